@@ -0,0 +1,156 @@
+// A microbenchmark of the compiler's hash containers (Map, StringMap, PtrSet) on workloads shaped like the checker's
+//
+// It is built against a compiler source tree, so two builds can be compared, e.g. before and after a change to them:
+//
+//     c++ -std=c++14 -O2 -w -I <odin>/src misc/hash_bench/hash_bench.cpp -o hash_bench -pthread -ldl -lm
+//     ./hash_bench $(find core -name '*.odin')
+//
+// The identifiers of the given files stand in for the names declared in and looked up through scopes, and every
+// identifier occurrence is a pointer key, as for the checker's Entity and Type keyed maps and sets
+
+#include "common.cpp"
+
+enum : isize {
+	BENCH_RUNS = 7,
+};
+
+struct BenchFile {
+	Array<String> idents; // NOTE: Every identifier occurrence, in order
+};
+
+bool bench_is_ident_start(u8 c) { return c == '_' || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+bool bench_is_ident_char(u8 c)  { return bench_is_ident_start(c) || (c >= '0' && c <= '9'); }
+
+void bench_load_file(char const *path, Array<BenchFile> *files) {
+	gbFileContents fc = gb_file_read_contents(heap_allocator(), false, path);
+	if (fc.data == nullptr) {
+		gb_printf_err("Could not read %s\n", path);
+		return;
+	}
+	BenchFile file = {};
+	array_init(&file.idents, heap_allocator());
+	u8 const *s = cast(u8 const *)fc.data;
+	isize n = fc.size;
+	for (isize i = 0; i < n;) {
+		if (!bench_is_ident_start(s[i])) {
+			i += 1;
+			continue;
+		}
+		isize start = i;
+		while (i < n && bench_is_ident_char(s[i])) {
+			i += 1;
+		}
+		array_add(&file.idents, make_string(s+start, i-start));
+	}
+	array_add(files, file);
+}
+
+// NOTE: Each file is a scope: the first occurrence of a name declares it, and every occurrence is looked up
+// in the file's scope and then in a shared parent scope, as `scope_lookup_parent` does
+isize bench_string_map(Array<BenchFile> const &files) {
+	isize found = 0;
+	StringMap<isize> parent = {};
+	string_map_init(&parent, heap_allocator());
+	for_array(i, files) {
+		StringMap<isize> scope = {};
+		string_map_init(&scope, heap_allocator());
+		Array<String> const &idents = files[i].idents;
+		for_array(j, idents) {
+			StringHashKey key = string_hash_string(idents[j]);
+			if (string_map_get(&scope, key) != nullptr) {
+				found += 1;
+			} else if (string_map_get(&parent, key) != nullptr) {
+				found += 1;
+			} else if ((j & 7) == 0) {
+				string_map_set(&parent, key, j);
+			} else {
+				string_map_set(&scope, key, j);
+			}
+		}
+		string_map_destroy(&scope);
+	}
+	string_map_destroy(&parent);
+	return found;
+}
+
+// NOTE: The text pointer of each identifier occurrence is used as a unique pointer key
+isize bench_map(Array<BenchFile> const &files) {
+	isize found = 0;
+	Map<isize> map = {};
+	map_init(&map, heap_allocator());
+	for_array(i, files) {
+		Array<String> const &idents = files[i].idents;
+		for_array(j, idents) {
+			map_set(&map, hash_pointer(idents[j].text), j);
+		}
+	}
+	for_array(i, files) {
+		Array<String> const &idents = files[i].idents;
+		for_array(j, idents) {
+			found += map_get(&map, hash_pointer(idents[j].text)) != nullptr;
+			found += map_get(&map, hash_pointer(idents[j].text+1)) != nullptr;
+		}
+	}
+	map_destroy(&map);
+	return found;
+}
+
+isize bench_ptr_set(Array<BenchFile> const &files) {
+	isize found = 0;
+	PtrSet<u8 *> set = {};
+	ptr_set_init(&set, heap_allocator());
+	for_array(i, files) {
+		Array<String> const &idents = files[i].idents;
+		for_array(j, idents) {
+			if ((j & 1) == 0) {
+				ptr_set_add(&set, idents[j].text);
+			}
+		}
+	}
+	for_array(i, files) {
+		Array<String> const &idents = files[i].idents;
+		for_array(j, idents) {
+			found += ptr_set_exists(&set, idents[j].text);
+		}
+	}
+	ptr_set_destroy(&set);
+	return found;
+}
+
+void bench_run(char const *name, isize (*proc)(Array<BenchFile> const &), Array<BenchFile> const &files) {
+	f64 best = 0;
+	isize result = 0;
+	for (isize run = 0; run < BENCH_RUNS; run++) {
+		f64 start = gb_time_now();
+		result = proc(files);
+		f64 time = gb_time_now() - start;
+		if (run == 0 || time < best) {
+			best = time;
+		}
+	}
+	// NOTE: gb_printf does not pad strings
+	isize pad = gb_max(10 - gb_strlen(name), 0);
+	gb_printf("%s%.*s - %10.3f ms (best of %td, result %td)\n", name, cast(int)pad, "          ", best*1000.0, cast(isize)BENCH_RUNS, result);
+}
+
+int main(int argc, char **argv) {
+	if (argc < 2) {
+		gb_printf_err("Usage: %s <file.odin>...\n", argv[0]);
+		return 1;
+	}
+	Array<BenchFile> files = {};
+	array_init(&files, heap_allocator());
+	isize ident_count = 0;
+	for (int i = 1; i < argc; i++) {
+		bench_load_file(argv[i], &files);
+	}
+	for_array(i, files) {
+		ident_count += files[i].idents.count;
+	}
+	gb_printf("%td files, %td identifiers\n", files.count, ident_count);
+
+	bench_run("StringMap", bench_string_map, files);
+	bench_run("Map",       bench_map,        files);
+	bench_run("PtrSet",    bench_ptr_set,    files);
+	return 0;
+}
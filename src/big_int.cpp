@@ -35,7 +35,15 @@ void MP_FREE(void *mem, size_t size) {
 #define MAX_BIG_INT_SHIFT 1024
 #endif
 
-typedef mp_int BigInt;
+
+// NOTE: Most integer constants are small, so any value which fits in an i64 is stored inline in `small`,
+// and only a value which does not uses `big` (which must allocate its digits). This is canonical: `big` is used
+// (and has digits) if and only if the value does not fit, where I64_MIN is treated as not fitting so that negating
+// a small value never overflows. Equal values therefore always have the same representation
+struct BigInt {
+	mp_int big;
+	i64    small;
+};
 
 void big_int_from_u64(BigInt *dst, u64 x);
 void big_int_from_i64(BigInt *dst, i64 x);
@@ -43,7 +51,8 @@ void big_int_init    (BigInt *dst, BigInt const *src);
 void big_int_from_string(BigInt *dst, String const &s);
 
 void big_int_dealloc(BigInt *dst) {
-	mp_clear(dst);
+	mp_clear(&dst->big);
+	dst->small = 0;
 }
 
 BigInt big_int_make(BigInt const *b, bool abs=false);
@@ -56,6 +65,7 @@ i64    big_int_to_i64   (BigInt const *x);
 f64    big_int_to_f64   (BigInt const *x);
 String big_int_to_string(gbAllocator allocator, BigInt const *x, u64 base = 10);
 
+void big_int_abs    (BigInt *dst, BigInt const *x);
 void big_int_add    (BigInt *dst, BigInt const *x, BigInt const *y);
 void big_int_sub    (BigInt *dst, BigInt const *x, BigInt const *y);
 void big_int_shl    (BigInt *dst, BigInt const *x, BigInt const *y);
@@ -83,7 +93,87 @@ void big_int_mul_eq(BigInt *dst, BigInt const *x);
 void big_int_quo_eq(BigInt *dst, BigInt const *x);
 void big_int_rem_eq(BigInt *dst, BigInt const *x);
 
-bool big_int_is_neg(BigInt const *x);
+bool big_int_is_neg (BigInt const *x);
+bool big_int_is_zero(BigInt const *x);
+
+
+gb_inline bool big_int_is_big(BigInt const *x) {
+	return x->big.dp != nullptr;
+}
+
+gb_inline bool big_int__fits_small(i64 x) {
+	return x != I64_MIN;
+}
+
+gb_inline void big_int__set_small(BigInt *dst, i64 x) {
+	GB_ASSERT(big_int__fits_small(x));
+	dst->big = {};
+	dst->small = x;
+}
+
+// NOTE: Takes ownership of the digits of `r`
+void big_int__set_mp(BigInt *dst, mp_int *r) {
+	if (mp_count_bits(r) < 64) {
+		i64 x = mp_get_i64(r);
+		mp_clear(r);
+		big_int__set_small(dst, x);
+	} else {
+		dst->big = *r;
+		dst->small = 0;
+	}
+}
+
+// NOTE: Only allocates (into `tmp`) if `x` is small; `tmp` must be cleared afterwards
+mp_int const *big_int__to_mp(BigInt const *x, mp_int *tmp) {
+	if (big_int_is_big(x)) {
+		return &x->big;
+	}
+	mp_init_i64(tmp, x->small);
+	return tmp;
+}
+
+typedef mp_err BigIntMpBinaryProc(mp_int const *a, mp_int const *b, mp_int *c);
+
+void big_int__mp_binary(BigInt *dst, BigInt const *x, BigInt const *y, BigIntMpBinaryProc *proc) {
+	mp_int tx = {};
+	mp_int ty = {};
+	mp_int r = {};
+	mp_err err = proc(big_int__to_mp(x, &tx), big_int__to_mp(y, &ty), &r);
+	GB_ASSERT(err == MP_OKAY);
+	mp_clear(&tx);
+	mp_clear(&ty);
+	big_int__set_mp(dst, &r);
+}
+
+// NOTE: These only succeed if the result fits in `small`, otherwise the operation must be done with `big`
+gb_internal bool big_int__small_add(i64 a, i64 b, i64 *r) {
+	if ((b > 0 && a > I64_MAX - b) || (b < 0 && a < I64_MIN - b)) {
+		return false;
+	}
+	*r = a + b;
+	return big_int__fits_small(*r);
+}
+gb_internal bool big_int__small_sub(i64 a, i64 b, i64 *r) {
+	if ((b < 0 && a > I64_MAX + b) || (b > 0 && a < I64_MIN + b)) {
+		return false;
+	}
+	*r = a - b;
+	return big_int__fits_small(*r);
+}
+gb_internal bool big_int__small_mul(i64 a, i64 b, i64 *r) {
+	if (a == 0 || b == 0) {
+		*r = 0;
+		return true;
+	}
+	u64 ua = cast(u64)(a < 0 ? -a : a);
+	u64 ub = cast(u64)(b < 0 ? -b : b);
+	if (ua > cast(u64)I64_MAX / ub) {
+		return false;
+	}
+	i64 m = cast(i64)(ua*ub);
+	*r = (a < 0) != (b < 0) ? -m : m;
+	return true;
+}
 
 
 void big_int_add_eq(BigInt *dst, BigInt const *x) {
@@ -125,31 +215,45 @@ void big_int_rem_eq(BigInt *dst, BigInt const *x) {
 
 
 i64 big_int_sign(BigInt const *x) {
-	if (mp_iszero(x)) {
+	if (big_int_is_zero(x)) {
 		return 0;
 	}
-	return x->sign == MP_ZPOS ? +1 : -1;
+	return big_int_is_neg(x) ? -1 : +1;
 }
 
 
 void big_int_from_u64(BigInt *dst, u64 x) {
-	mp_init_u64(dst, x);
+	if (x <= cast(u64)I64_MAX) {
+		big_int__set_small(dst, cast(i64)x);
+		return;
+	}
+	dst->small = 0;
+	mp_init_u64(&dst->big, x);
 }
 void big_int_from_i64(BigInt *dst, i64 x) {
-	mp_init_i64(dst, x);
-
+	if (big_int__fits_small(x)) {
+		big_int__set_small(dst, x);
+		return;
+	}
+	dst->small = 0;
+	mp_init_i64(&dst->big, x);
 }
 void big_int_init(BigInt *dst, BigInt const *src) {
 	if (dst == src) {
 		return;
 	}
-	mp_init_copy(dst, src);
+	if (!big_int_is_big(src)) {
+		big_int__set_small(dst, src->small);
+		return;
+	}
+	dst->small = 0;
+	mp_init_copy(&dst->big, &src->big);
 }
 
 BigInt big_int_make(BigInt const *b, bool abs) {
 	BigInt i = {};
 	big_int_init(&i, b);
-	if (abs) mp_abs(&i, &i);
+	if (abs) big_int_abs(&i, &i);
 	return i;
 }
 BigInt big_int_make_abs(BigInt const *b) {
@@ -192,7 +296,7 @@ void big_int_from_string(BigInt *dst, String const &s) {
 
 	BigInt b = {};
 	big_int_from_u64(&b, base);
-	mp_zero(dst);
+	big_int_from_u64(dst, 0);
 
 	isize i = 0;
 	for (; i < len; i++) {
@@ -238,75 +342,161 @@ void big_int_from_string(BigInt *dst, String const &s) {
 
 
 
+
+
+
 u64 big_int_to_u64(BigInt const *x) {
-	GB_ASSERT(x->sign == 0);
-	return mp_get_u64(x);
+	GB_ASSERT(!big_int_is_neg(x));
+	if (!big_int_is_big(x)) {
+		return cast(u64)x->small;
+	}
+	return mp_get_u64(&x->big);
 }
 
 i64 big_int_to_i64(BigInt const *x) {
-	return mp_get_i64(x);
+	if (!big_int_is_big(x)) {
+		return x->small;
+	}
+	return mp_get_i64(&x->big);
 }
 
 f64 big_int_to_f64(BigInt const *x) {
-	return mp_get_double(x);
+	if (!big_int_is_big(x)) {
+		return cast(f64)x->small;
+	}
+	return mp_get_double(&x->big);
 }
 
 
 void big_int_neg(BigInt *dst, BigInt const *x) {
-	mp_neg(x, dst);
+	if (!big_int_is_big(x)) {
+		big_int__set_small(dst, -x->small);
+		return;
+	}
+	mp_int r = {};
+	mp_neg(&x->big, &r);
+	big_int__set_mp(dst, &r);
+}
+
+void big_int_abs(BigInt *dst, BigInt const *x) {
+	if (!big_int_is_big(x)) {
+		big_int__set_small(dst, x->small < 0 ? -x->small : x->small);
+		return;
+	}
+	mp_int r = {};
+	mp_abs(&x->big, &r);
+	big_int__set_mp(dst, &r);
 }
 
 
 int big_int_cmp(BigInt const *x, BigInt const *y) {
-	return mp_cmp(x, y);
+	if (!big_int_is_big(x) && !big_int_is_big(y)) {
+		if (x->small < y->small) {
+			return -1;
+		}
+		return x->small > y->small ? +1 : 0;
+	}
+	mp_int tx = {};
+	mp_int ty = {};
+	int cmp = mp_cmp(big_int__to_mp(x, &tx), big_int__to_mp(y, &ty));
+	mp_clear(&tx);
+	mp_clear(&ty);
+	return cmp;
 }
 
 int big_int_cmp_zero(BigInt const *x) {
-	if (mp_iszero(x)) {
+	if (big_int_is_zero(x)) {
 		return 0;
 	}
-	return x->sign ? -1 : +1;
+	return big_int_is_neg(x) ? -1 : +1;
 }
 
 bool big_int_is_zero(BigInt const *x) {
-	return mp_iszero(x);
+	// NOTE: A big value is never zero
+	return !big_int_is_big(x) && x->small == 0;
 }
 
 
 
 
 void big_int_add(BigInt *dst, BigInt const *x, BigInt const *y) {
-	mp_add(x, y, dst);
+	i64 r = 0;
+	if (!big_int_is_big(x) && !big_int_is_big(y) && big_int__small_add(x->small, y->small, &r)) {
+		big_int__set_small(dst, r);
+		return;
+	}
+	big_int__mp_binary(dst, x, y, mp_add);
 }
 
 
 void big_int_sub(BigInt *dst, BigInt const *x, BigInt const *y) {
-	mp_sub(x, y, dst);
+	i64 r = 0;
+	if (!big_int_is_big(x) && !big_int_is_big(y) && big_int__small_sub(x->small, y->small, &r)) {
+		big_int__set_small(dst, r);
+		return;
+	}
+	big_int__mp_binary(dst, x, y, mp_sub);
 }
 
 
 void big_int_shl(BigInt *dst, BigInt const *x, BigInt const *y) {
-	u32 yy = mp_get_u32(y);
-	mp_mul_2d(x, yy, dst);
+	if (!big_int_is_big(x) && !big_int_is_big(y) && 0 <= y->small && y->small < 63) {
+		i64 a = x->small;
+		u32 n = cast(u32)y->small;
+		u64 ua = cast(u64)(a < 0 ? -a : a);
+		if ((ua >> (63-n)) == 0) {
+			i64 m = cast(i64)(ua << n);
+			big_int__set_small(dst, a < 0 ? -m : m);
+			return;
+		}
+	}
+	mp_int tx = {};
+	mp_int ty = {};
+	mp_int r = {};
+	u32 yy = mp_get_u32(big_int__to_mp(y, &ty));
+	mp_mul_2d(big_int__to_mp(x, &tx), yy, &r);
+	mp_clear(&tx);
+	mp_clear(&ty);
+	big_int__set_mp(dst, &r);
 }
 
 void big_int_shr(BigInt *dst, BigInt const *x, BigInt const *y) {
-	u32 yy = mp_get_u32(y);
-	BigInt d = {};
-	mp_div_2d(x, yy, dst, &d);
-	big_int_dealloc(&d);
+	if (!big_int_is_big(x) && !big_int_is_big(y) && 0 <= y->small && y->small <= U32_MAX) {
+		// NOTE: This truncates towards zero, the same as `mp_div_2d`
+		i64 a = x->small;
+		u64 n = cast(u64)y->small;
+		u64 ua = cast(u64)(a < 0 ? -a : a);
+		i64 m = n < 64 ? cast(i64)(ua >> n) : 0;
+		big_int__set_small(dst, a < 0 ? -m : m);
+		return;
+	}
+	mp_int tx = {};
+	mp_int ty = {};
+	mp_int r = {};
+	mp_int d = {};
+	u32 yy = mp_get_u32(big_int__to_mp(y, &ty));
+	mp_div_2d(big_int__to_mp(x, &tx), yy, &r, &d);
+	mp_clear(&tx);
+	mp_clear(&ty);
+	mp_clear(&d);
+	big_int__set_mp(dst, &r);
 }
 
 void big_int_mul_u64(BigInt *dst, BigInt const *x, u64 y) {
 	BigInt d = {};
 	big_int_from_u64(&d, y);
-	mp_mul(x, &d, dst);
+	big_int_mul(dst, x, &d);
 	big_int_dealloc(&d);
 }
 
 
 void big_int_mul(BigInt *dst, BigInt const *x, BigInt const *y) {
-	mp_mul(x, y, dst);
+	i64 r = 0;
+	if (!big_int_is_big(x) && !big_int_is_big(y) && big_int__small_mul(x->small, y->small, &r)) {
+		big_int__set_small(dst, r);
+		return;
+	}
+	big_int__mp_binary(dst, x, y, mp_mul);
 }
 
 
@@ -344,7 +534,27 @@ u64 leading_zeros_u64(u64 x) {
 // q = x/y with the result truncated to zero
 // r = x - y*q
 void big_int_quo_rem(BigInt const *x, BigInt const *y, BigInt *q_, BigInt *r_) {
-	mp_div(x, y, q_, r_);
+	if (!big_int_is_big(x) && !big_int_is_big(y) && y->small != 0) {
+		// NOTE: I64_MIN is never small so this cannot overflow, and C++ division also truncates towards zero
+		i64 q = x->small / y->small;
+		i64 r = x->small % y->small;
+		if (q_) big_int__set_small(q_, q);
+		if (r_) big_int__set_small(r_, r);
+		return;
+	}
+	mp_int tx = {};
+	mp_int ty = {};
+	mp_int q = {};
+	mp_int r = {};
+	mp_div(big_int__to_mp(x, &tx), big_int__to_mp(y, &ty), &q, &r);
+	mp_clear(&tx);
+	mp_clear(&ty);
+	if (q_) {
+		big_int__set_mp(q_, &q);
+	}
+	if (r_) {
+		big_int__set_mp(r_, &r);
+	}
 }
 
 void big_int_quo(BigInt *z, BigInt const *x, BigInt const *y) {
@@ -365,8 +575,8 @@ void big_int_euclidean_mod(BigInt *z, BigInt const *x, BigInt const *y) {
 
 	BigInt q = {};
 	big_int_quo_rem(x, y, &q, z);
-	if (z->sign) {
-		if (y0.sign) {
+	if (big_int_is_neg(z)) {
+		if (big_int_is_neg(&y0)) {
 			big_int_sub(z, z, &y0);
 		} else {
 			big_int_add(z, z, &y0);
@@ -377,79 +587,125 @@ void big_int_euclidean_mod(BigInt *z, BigInt const *x, BigInt const *y) {
 
 
 void big_int_and(BigInt *dst, BigInt const *x, BigInt const *y) {
-	mp_and(x, y, dst);
-}
-
-void big_int_and_not(BigInt *dst, BigInt const *x, BigInt const *y) {
-	if (mp_iszero(x)) {
-		big_int_init(dst, y);
-		return;
-	}
-	if (mp_iszero(y)) {
-		big_int_init(dst, x);
+	if (!big_int_is_big(x) && !big_int_is_big(y) && big_int__fits_small(x->small & y->small)) {
+		big_int__set_small(dst, x->small & y->small);
 		return;
 	}
+	big_int__mp_binary(dst, x, y, mp_and);
+}
 
+mp_err big_int__mp_and_not(mp_int const *x, mp_int const *y, mp_int *dst) {
 	if (x->sign == y->sign) {
 		if (x->sign) {
 			// (-x) &~ (-y) == ~(x-1) &~ ~(y-1) == ~(x-1) & (y-1) == (y-1) &~ (x-1)
-			BigInt x1 = big_int_make_abs(x);
-			BigInt y1 = big_int_make_abs(y);
+			mp_int x1 = {};
+			mp_int y1 = {};
+			mp_abs(x, &x1);
+			mp_abs(y, &y1);
 			mp_decr(&x1);
 			mp_decr(&y1);
 
-			BigInt ny1 = {};
+			mp_int ny1 = {};
 			mp_complement(&y1, &ny1);
-			mp_and(&x1, &ny1, dst);
+			mp_err err = mp_and(&x1, &ny1, dst);
 
-			big_int_dealloc(&x1);
-			big_int_dealloc(&y1);
-			big_int_dealloc(&ny1);
-			return;
+			mp_clear(&x1);
+			mp_clear(&y1);
+			mp_clear(&ny1);
+			return err;
 		}
 
-		BigInt ny = {};
+		mp_int ny = {};
 		mp_complement(y, &ny);
-		mp_and(x, &ny, dst);
+		mp_err err = mp_and(x, &ny, dst);
 
-		big_int_dealloc(&ny);
-		return;
+		mp_clear(&ny);
+		return err;
 	}
 
 	if (x->sign) {
 		// (-x) &~ y == ~(x-1) &~ y == ~(x-1) & ~y == ~((x-1) | y) == -(((x-1) | y) + 1)
-		BigInt x1 = big_int_make_abs(x);
-		BigInt y1 = big_int_make_abs(y);
+		mp_int x1 = {};
+		mp_int y1 = {};
+		mp_abs(x, &x1);
+		mp_abs(y, &y1);
 		mp_decr(&x1);
 
-		BigInt z1 = {};
-		big_int_or(&z1, &x1, &y1);
-		mp_add_d(&z1, 1, dst);
+		mp_int z1 = {};
+		mp_or(&x1, &y1, &z1);
+		mp_err err = mp_add_d(&z1, 1, dst);
 
-		big_int_dealloc(&x1);
-		big_int_dealloc(&y1);
-		big_int_dealloc(&z1);
-		return;
+		mp_clear(&x1);
+		mp_clear(&y1);
+		mp_clear(&z1);
+		return err;
 	}
 
 	// x &~ (-y) == x &~ ~(y-1) == x & (y-1)
-	BigInt x1 = big_int_make_abs(x);
-	BigInt y1 = big_int_make_abs(y);
+	mp_int x1 = {};
+	mp_int y1 = {};
+	mp_abs(x, &x1);
+	mp_abs(y, &y1);
 	mp_decr(&y1);
-	big_int_and(dst, &x1, &y1);
+	mp_err err = mp_and(&x1, &y1, dst);
+
+	mp_clear(&x1);
+	mp_clear(&y1);
+	return err;
+}
 
-	big_int_dealloc(&x1);
-	big_int_dealloc(&y1);
-	return;
+// NOTE: This must give the same results as `big_int__mp_and_not` for the same values
+gb_internal bool big_int__small_and_not(i64 x, i64 y, i64 *r) {
+	if ((x < 0) == (y < 0)) {
+		if (x < 0) {
+			*r = (-x - 1) & ~(-y - 1);
+		} else {
+			*r = x & ~y;
+		}
+	} else if (x < 0) {
+		i64 z = (-x - 1) | y;
+		if (z == I64_MAX) {
+			return false;
+		}
+		*r = z + 1;
+	} else {
+		*r = x & (-y - 1);
+	}
+	return true;
+}
+
+void big_int_and_not(BigInt *dst, BigInt const *x, BigInt const *y) {
+	if (big_int_is_zero(x)) {
+		big_int_init(dst, y);
+		return;
+	}
+	if (big_int_is_zero(y)) {
+		big_int_init(dst, x);
+		return;
+	}
+	i64 r = 0;
+	if (!big_int_is_big(x) && !big_int_is_big(y) && big_int__small_and_not(x->small, y->small, &r)) {
+		big_int__set_small(dst, r);
+		return;
+	}
+	big_int__mp_binary(dst, x, y, big_int__mp_and_not);
 }
 
 void big_int_xor(BigInt *dst, BigInt const *x, BigInt const *y) {
-	mp_xor(x, y, dst);
+	if (!big_int_is_big(x) && !big_int_is_big(y) && big_int__fits_small(x->small ^ y->small)) {
+		big_int__set_small(dst, x->small ^ y->small);
+		return;
+	}
+	big_int__mp_binary(dst, x, y, mp_xor);
 }
 
 
 void big_int_or(BigInt *dst, BigInt const *x, BigInt const *y) {
-	mp_or(x, y, dst);
+	if (!big_int_is_big(x) && !big_int_is_big(y) && big_int__fits_small(x->small | y->small)) {
+		big_int__set_small(dst, x->small | y->small);
+		return;
+	}
+	big_int__mp_binary(dst, x, y, mp_or);
 }
 
 void debug_print_big_int(BigInt const *x) {
@@ -464,53 +720,80 @@ void big_int_not(BigInt *dst, BigInt const *x, i32 bit_count, bool is_signed) {
 		big_int_from_u64(dst, 0);
 		return;
 	}
-	if (big_int_is_neg(x)) {
-		// ~x == -x - 1
-		big_int_neg(dst, x);
-		mp_decr(dst);
-		mp_mod_2d(dst, bit_count, dst);
+	if (!big_int_is_big(x) && bit_count < 63) {
+		u64 mask = (1ull<<bit_count) - 1;
+		i64 a = x->small;
+		if (a < 0) {
+			// ~x == -x - 1
+			big_int__set_small(dst, cast(i64)(cast(u64)(-a - 1) & mask));
+			return;
+		}
+		u64 v = (cast(u64)a & mask) ^ mask;
+		i64 r = cast(i64)v;
+		if (is_signed) {
+			u64 pmask = 1ull<<(bit_count-1);
+			r = cast(i64)(v & (pmask-1)) - cast(i64)(v & pmask);
+		}
+		big_int__set_small(dst, r);
 		return;
 	}
 
+	mp_int tx = {};
+	mp_int const *mx = big_int__to_mp(x, &tx);
+	mp_int d = {};
+
+	if (mx->sign != MP_ZPOS) {
+		// ~x == -x - 1
+		mp_neg(mx, &d);
+		mp_decr(&d);
+		mp_mod_2d(&d, bit_count, &d);
+		mp_clear(&tx);
+		big_int__set_mp(dst, &d);
+		return;
+	}
 
-	BigInt pow2b = {};
-	mp_2expt(&pow2b, bit_count);
 
-	BigInt mask = {};
+	mp_int mask = {};
 	mp_2expt(&mask, bit_count);
 	mp_decr(&mask);
 
-	BigInt v = {};
-	mp_init_copy(&v, x);
+	mp_int v = {};
+	mp_init_copy(&v, mx);
 	mp_mod_2d(&v, bit_count, &v);
 
-	mp_xor(&v, &mask, dst);
+	mp_xor(&v, &mask, &d);
 
 	if (is_signed) {
-		BigInt pmask = {};
-		BigInt pmask_minus_one = {};
+		mp_int pmask = {};
+		mp_int pmask_minus_one = {};
 		mp_2expt(&pmask, bit_count-1);
 		mp_sub_d(&pmask, 1, &pmask_minus_one);
 
-		BigInt a = {};
-		BigInt b = {};
-		big_int_and(&a, dst, &pmask_minus_one);
-		big_int_and(&b, dst, &pmask);
-		big_int_sub(dst, &a, &b);
-		big_int_dealloc(&a);
-		big_int_dealloc(&b);
+		mp_int a = {};
+		mp_int b = {};
+		mp_and(&d, &pmask_minus_one, &a);
+		mp_and(&d, &pmask, &b);
+		mp_sub(&a, &b, &d);
+		mp_clear(&a);
+		mp_clear(&b);
+		mp_clear(&pmask);
+		mp_clear(&pmask_minus_one);
 	}
 
-	big_int_dealloc(&pow2b);
-	big_int_dealloc(&mask);
-	big_int_dealloc(&v);
+	mp_clear(&tx);
+	mp_clear(&mask);
+	mp_clear(&v);
+	big_int__set_mp(dst, &d);
 }
 
 bool big_int_is_neg(BigInt const *x) {
 	if (x == nullptr) {
 		return false;
 	}
-	return x->sign != MP_ZPOS;
+	if (!big_int_is_big(x)) {
+		return x->small < 0;
+	}
+	return x->big.sign != MP_ZPOS;
 }
 
 
@@ -527,7 +810,7 @@ char digit_to_char(u8 digit) {
 String big_int_to_string(gbAllocator allocator, BigInt const *x, u64 base) {
 	GB_ASSERT(base <= 16);
 
-	if (mp_iszero(x)) {
+	if (big_int_is_zero(x)) {
 		u8 *buf = gb_alloc_array(allocator, u8, 1);
 		buf[0] = '0';
 		return make_string(buf, 1);
@@ -536,33 +819,39 @@ String big_int_to_string(gbAllocator allocator, BigInt const *x, u64 base) {
 	Array<char> buf = {};
 	array_init(&buf, allocator, 0, 32);
 
-	BigInt v = {};
-	mp_init_copy(&v, x);
-
-	if (v.sign) {
+	if (big_int_is_neg(x)) {
 		array_add(&buf, '-');
-		mp_abs(&v, &v);
 	}
 
 	isize first_word_idx = buf.count;
 
-	BigInt r = {};
-	BigInt b = {};
-	big_int_from_u64(&b, base);
+	if (!big_int_is_big(x)) {
+		u64 v = cast(u64)(x->small < 0 ? -x->small : x->small);
+		do {
+			array_add(&buf, digit_to_char(cast(u8)(v % base)));
+			v /= base;
+		} while (v != 0);
+	} else {
+		BigInt v = big_int_make_abs(x);
+
+		BigInt r = {};
+		BigInt b = {};
+		big_int_from_u64(&b, base);
 
-	u8 digit = 0;
-	while (big_int_cmp(&v, &b) >= 0) {
-		big_int_quo_rem(&v, &b, &v, &r);
+		u8 digit = 0;
+		while (big_int_cmp(&v, &b) >= 0) {
+			big_int_quo_rem(&v, &b, &v, &r);
+			digit = cast(u8)big_int_to_u64(&r);
+			array_add(&buf, digit_to_char(digit));
+		}
+
+		big_int_rem(&r, &v, &b);
 		digit = cast(u8)big_int_to_u64(&r);
 		array_add(&buf, digit_to_char(digit));
-	}
-
-	big_int_rem(&r, &v, &b);
-	digit = cast(u8)big_int_to_u64(&r);
-	array_add(&buf, digit_to_char(digit));
 
-	big_int_dealloc(&r);
-	big_int_dealloc(&b);
+		big_int_dealloc(&r);
+		big_int_dealloc(&b);
+	}
 
 	for (isize i = first_word_idx; i < buf.count/2; i++) {
 		isize j = buf.count + first_word_idx - i - 1;
@@ -179,6 +179,7 @@ struct BuildContext {
 	String link_flags;
 	String extra_linker_flags;
 	String microarch;
+	String cache_dir;
 	BuildModeKind build_mode;
 	bool   generate_docs;
 	i32    optimization_level;
@@ -186,6 +187,7 @@ struct BuildContext {
 	bool   show_unused;
 	bool   show_unused_with_location;
 	bool   show_more_timings;
+	String trace_file;
 	bool   show_system_calls;
 	bool   keep_temp_files;
 	bool   ignore_unknown_attributes;
@@ -215,7 +217,10 @@ struct BuildContext {
 	bool   linker_map_file;
 
 	bool use_separate_modules;
+	bool incremental;
+	u64  command_line_hash; // NOTE: Only used by -incremental
 	bool threaded_checker;
+	bool threaded_global_checker;
 
 	bool show_debug_messages;
 
@@ -715,10 +720,8 @@ String path_to_fullpath(gbAllocator a, String s) {
 }
 #elif defined(GB_SYSTEM_OSX) || defined(GB_SYSTEM_UNIX)
 String path_to_fullpath(gbAllocator a, String s) {
-	char *p;
-	mutex_lock(&string_buffer_mutex);
-	p = realpath(cast(char *)s.text, 0);
-	mutex_unlock(&string_buffer_mutex);
+	// NOTE: `realpath` allocates its result, so it does not need the string buffer
+	char *p = realpath(cast(char *)s.text, 0);
 	if(p == nullptr) return String{};
 	return make_string_c(p);
 }
@@ -727,6 +730,27 @@ String path_to_fullpath(gbAllocator a, String s) {
 #endif
 
 
+// NOTE: The same import paths are resolved from many files, and each resolution is a system call,
+// so the full paths are cached. A shard is only locked to look up or add a path, never whilst resolving
+// one, so the parser threads can resolve different paths at the same time
+enum : isize {
+	FULLPATH_CACHE_SHARD_COUNT = 32,
+};
+
+struct FullpathCacheShard {
+	BlockingMutex     mutex;
+	StringMap<String> map; // Key: path to resolve, Value: full path or empty if it does not exist
+};
+
+gb_global FullpathCacheShard fullpath_cache_shards[FULLPATH_CACHE_SHARD_COUNT];
+
+void init_fullpath_cache(void) {
+	for (isize i = 0; i < FULLPATH_CACHE_SHARD_COUNT; i++) {
+		mutex_init(&fullpath_cache_shards[i].mutex);
+		string_map_init(&fullpath_cache_shards[i].map, heap_allocator());
+	}
+}
+
 String get_fullpath_relative(gbAllocator a, String base_dir, String path) {
 	u8 *str = gb_alloc_array(heap_allocator(), u8, base_dir.len+1+path.len+1);
 	defer (gb_free(heap_allocator(), str));
@@ -740,7 +764,29 @@ String get_fullpath_relative(gbAllocator a, String base_dir, String path) {
 
 	String res = make_string(str, i);
 	res = string_trim_whitespace(res);
-	return path_to_fullpath(a, res);
+
+	StringHashKey key = string_hash_string(res);
+	FullpathCacheShard *shard = &fullpath_cache_shards[key.hash % FULLPATH_CACHE_SHARD_COUNT];
+	mutex_lock(&shard->mutex);
+	String *found = string_map_get(&shard->map, key);
+	String fullpath = found ? *found : String{};
+	mutex_unlock(&shard->mutex);
+	if (found) {
+		return fullpath;
+	}
+
+	fullpath = path_to_fullpath(a, res);
+
+	mutex_lock(&shard->mutex);
+	defer (mutex_unlock(&shard->mutex));
+	found = string_map_get(&shard->map, key);
+	if (found) {
+		// NOTE: Another thread resolved the same path first
+		return *found;
+	}
+	key.string = copy_string(heap_allocator(), res);
+	string_map_set(&shard->map, key, fullpath);
+	return fullpath;
 }
 
 
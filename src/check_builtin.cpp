@@ -235,8 +235,6 @@ bool check_builtin_procedure(CheckerContext *c, Operand *operand, Ast *call, i32
 				return false;
 			}
 
-			gbAllocator a = heap_allocator();
-
 			GB_ASSERT(o.value.kind == ExactValue_String);
 			String base_dir = dir_from_path(get_file_path_string(bd->token.pos.file_id));
 			String original_string = o.value.value_string;
@@ -246,38 +244,28 @@ bool check_builtin_procedure(CheckerContext *c, Operand *operand, Ast *call, i32
 			String path = {};
 			bool ok = determine_path_from_string(ignore_mutex, call, base_dir, original_string, &path);
 
-			char *c_str = alloc_cstring(a, path);
-			defer (gb_free(a, c_str));
-
-
-			gbFile f = {};
-			gbFileError file_err = gb_file_open(&f, c_str);
-			defer (gb_file_close(&f));
-
-			switch (file_err) {
-			default:
-			case gbFileError_Invalid:
-				error(ce->proc, "Failed to `#load` file: %s; invalid file or cannot be found", c_str);
+			LoadFileCache *cache = load_file_cached(c->info, path);
+			switch (cache->error) {
+			case LoadedFile_None:
+				// Okay
+				break;
+			case LoadedFile_NotExists:
+				error(ce->proc, "Failed to `#load` file: %.*s; file cannot be found", LIT(path));
 				return false;
-			case gbFileError_NotExists:
-				error(ce->proc, "Failed to `#load` file: %s; file cannot be found", c_str);
+			case LoadedFile_Permission:
+				error(ce->proc, "Failed to `#load` file: %.*s; file permissions problem", LIT(path));
 				return false;
-			case gbFileError_Permission:
-				error(ce->proc, "Failed to `#load` file: %s; file permissions problem", c_str);
+			case LoadedFile_FileTooLarge:
+				error(ce->proc, "Failed to `#load` file: %.*s; file is too large", LIT(path));
+				return false;
+			default:
+				error(ce->proc, "Failed to `#load` file: %.*s; invalid file or cannot be found", LIT(path));
 				return false;
-			case gbFileError_None:
-				// Okay
-				break;
 			}
 
-			String result = {};
-			isize file_size = cast(isize)gb_file_size(&f);
-			if (file_size > 0) {
-				u8 *data = cast(u8 *)gb_alloc(a, file_size+1);
-				gb_file_read_at(&f, data, file_size, 0);
-				data[file_size] = '\0';
-				result.text = data;
-				result.len = file_size;
+			String result = cache->data;
+			if (build_context.incremental) {
+				c->info->load_files_hash.fetch_add(cache->hash, std::memory_order_relaxed);
 			}
 
 			operand->type = t_u8_slice;
@@ -1490,7 +1478,7 @@ bool check_builtin_procedure(CheckerContext *c, Operand *operand, Ast *call, i32
 		if (operand->mode == Addressing_Constant) {
 			switch (operand->value.kind) {
 			case ExactValue_Integer:
-				mp_abs(&operand->value.value_integer, &operand->value.value_integer);
+				big_int_abs(&operand->value.value_integer, &operand->value.value_integer);
 				break;
 			case ExactValue_Float:
 				operand->value.value_float = gb_abs(operand->value.value_float);
@@ -1324,12 +1324,12 @@ void check_proc_body(CheckerContext *ctx_, Token token, DeclInfo *decl, Type *ty
 			// NOTE(bill): Add the dependencies from the procedure literal (lambda)
 			// But only at the procedure level
 			for_array(i, decl->deps.entries) {
-				Entity *e = decl->deps.entries[i].ptr;
-				ptr_set_add(&decl->parent->deps, e);
+				Entity *e = decl->deps.entries[i];
+				small_id_set_add(&decl->parent->deps, e);
 			}
 			for_array(i, decl->type_info_deps.entries) {
-				Type *t = decl->type_info_deps.entries[i].ptr;
-				ptr_set_add(&decl->parent->type_info_deps, t);
+				Type *t = decl->type_info_deps.entries[i];
+				small_id_set_add(&decl->parent->type_info_deps, t);
 			}
 
 			mutex_unlock(&ctx->info->deps_mutex);
@@ -207,6 +207,28 @@ isize check_is_assignable_to_using_subtype(Type *src, Type *dst, isize level = 0
 	return 0;
 }
 
+HashKey hash_polymorphic_procedure_instance(Ast *base_identifier, Type *proc_type) {
+	HashKey key = hash_pointer(base_identifier);
+	key.key = type_hash_combine(key.key, type_hash(proc_type));
+	return key;
+}
+
+// NOTE: Requires `info->gen_procs_mutex` to be held
+Entity *find_polymorphic_procedure_instance(CheckerInfo *info, Ast *base_identifier, Type *proc_type) {
+	HashKey key = hash_polymorphic_procedure_instance(base_identifier, proc_type);
+	auto *entry = multi_map_find_first(&info->gen_proc_instances, key);
+	while (entry != nullptr) {
+		Entity *other = entry->value.entity;
+		// NOTE: Different bases or signatures may share the same hash
+		if (entry->value.base_identifier == base_identifier &&
+		    are_types_identical(base_type(other->type), proc_type)) {
+			return other;
+		}
+		entry = multi_map_find_next(&info->gen_proc_instances, entry);
+	}
+	return nullptr;
+}
+
 bool find_or_generate_polymorphic_procedure(CheckerContext *c, Entity *base_entity, Type *type,
                                             Array<Operand> *param_operands, Ast *poly_def_node, PolyProcData *poly_proc_data) {
 	///////////////////////////////////////////////////////////////////////////////
@@ -314,16 +336,12 @@ bool find_or_generate_polymorphic_procedure(CheckerContext *c, Entity *base_enti
 
 	auto *found_gen_procs = map_get(&info->gen_procs, hash_pointer(base_entity->identifier));
 	if (found_gen_procs) {
-		auto procs = *found_gen_procs;
-		for_array(i, procs) {
-			Entity *other = procs[i];
-			Type *pt = base_type(other->type);
-			if (are_types_identical(pt, final_proc_type)) {
-				if (poly_proc_data) {
-					poly_proc_data->gen_entity = other;
-				}
-				return true;
+		Entity *other = find_polymorphic_procedure_instance(info, base_entity->identifier, final_proc_type);
+		if (other != nullptr) {
+			if (poly_proc_data) {
+				poly_proc_data->gen_entity = other;
 			}
+			return true;
 		}
 	}
 
@@ -350,16 +368,12 @@ bool find_or_generate_polymorphic_procedure(CheckerContext *c, Entity *base_enti
 		}
 
 		if (found_gen_procs) {
-			auto procs = *found_gen_procs;
-			for_array(i, procs) {
-				Entity *other = procs[i];
-				Type *pt = base_type(other->type);
-				if (are_types_identical(pt, final_proc_type)) {
-					if (poly_proc_data) {
-						poly_proc_data->gen_entity = other;
-					}
-					return true;
+			Entity *other = find_polymorphic_procedure_instance(info, base_entity->identifier, final_proc_type);
+			if (other != nullptr) {
+				if (poly_proc_data) {
+					poly_proc_data->gen_entity = other;
 				}
+				return true;
 			}
 		}
 	}
@@ -418,6 +432,7 @@ bool find_or_generate_polymorphic_procedure(CheckerContext *c, Entity *base_enti
 	proc_info->tags  = tags;
 	proc_info->generated_from_polymorphic = true;
 	proc_info->poly_def_node = poly_def_node;
+	proc_info->poly_instantiated_in = checker_proc_body_decl;
 
 	if (found_gen_procs) {
 		array_add(found_gen_procs, entity);
@@ -426,6 +441,8 @@ bool find_or_generate_polymorphic_procedure(CheckerContext *c, Entity *base_enti
 		array_add(&array, entity);
 		map_set(&info->gen_procs, hash_pointer(base_entity->identifier), array);
 	}
+	GenProcInstance instance = {base_entity->identifier, entity};
+	multi_map_insert(&info->gen_proc_instances, hash_polymorphic_procedure_instance(base_entity->identifier, final_proc_type), instance);
 
 	GB_ASSERT(entity != nullptr);
 
@@ -870,7 +887,7 @@ bool is_polymorphic_type_assignable(CheckerContext *c, Type *poly, Type *source,
 		}
 		if (modify_type) {
 			Type *ds = default_type(source); // IMPORTANT TODO(bill): IS THIS CORRECT?
-			gb_memmove(poly, ds, gb_size_of(Type));
+			type_overwrite_in_place(poly, ds);
 		}
 		return true;
 	}
@@ -936,6 +953,7 @@ bool is_polymorphic_type_assignable(CheckerContext *c, Type *poly, Type *source,
 					poly->kind = Type_EnumeratedArray;
 					poly->cached_size  = -1;
 					poly->cached_align = -1;
+					poly->cached_hash  = 0;
 					poly->flags        = source->flags;
 					poly->failure      = false;
 					poly->EnumeratedArray.elem      = source->EnumeratedArray.elem;
@@ -1139,7 +1157,7 @@ Entity *check_ident(CheckerContext *c, Operand *o, Ast *n, Type *named_type, Typ
 	o->expr = n;
 	String name = n->Ident.token.string;
 
-	Entity *e = scope_lookup(c->scope, name);
+	Entity *e = scope_lookup(c->scope, token_hash_key(n->Ident.token));
 	if (e == nullptr) {
 		if (is_blank_ident(name)) {
 			error(n, "'_' cannot be used as a value");
@@ -1495,17 +1513,19 @@ bool check_representable_as_constant(CheckerContext *c, ExactValue in_value, Typ
 
 			BigInt bi128 = {};
 			BigInt bi127 = {};
+			BigInt bi1 = {};
 			big_int_from_i64(&bi128, 128);
 			big_int_from_i64(&bi127, 127);
+			big_int_from_i64(&bi1, 1);
 
 			big_int_shl_eq(&umax, &bi128);
-			mp_decr(&umax);
+			big_int_sub_eq(&umax, &bi1);
 
 			big_int_shl_eq(&imin, &bi127);
 			big_int_neg(&imin, &imin);
 
 			big_int_shl_eq(&imax, &bi127);
-			mp_decr(&imax);
+			big_int_sub_eq(&imax, &bi1);
 		}
 
 		switch (type->Basic.kind) {
@@ -1551,7 +1571,7 @@ bool check_representable_as_constant(CheckerContext *c, ExactValue in_value, Typ
 			{
 				// return 0ull <= i && i <= umax;
 				int b = big_int_cmp(&i, &umax);
-				return !i.sign && (b <= 0);
+				return !big_int_is_neg(&i) && (b <= 0);
 			}
 
 		case Basic_UntypedInteger:
@@ -1771,7 +1791,7 @@ bool check_is_not_addressable(CheckerContext *c, Operand *o) {
 			return true;
 		}
 		ast_node(ta, TypeAssertion, expr);
-		TypeAndValue tv = ta->expr->tav;
+		TypeAndValue tv = *ta->expr->tav;
 		if (is_type_pointer(tv.type)) {
 			return false;
 		}
@@ -2223,7 +2243,7 @@ void check_shift(CheckerContext *c, Operand *x, Operand *y, Ast *node, Type *typ
 		TokenPos pos = ast_token(x->expr).pos;
 		if (x_is_untyped) {
 			if (x->expr != nullptr) {
-				x->expr->tav.is_lhs = true;
+				ast_tav_for_write(x->expr)->is_lhs = true;
 			}
 			x->mode = Addressing_Value;
 			if (type_hint && is_type_integer(type_hint)) {
@@ -2917,8 +2937,8 @@ void update_untyped_expr_type(CheckerContext *c, Ast *e, Type *type, bool final)
 	ExprInfo *old = check_get_expr_info(c, e);
 	if (old == nullptr) {
 		if (type != nullptr && type != t_invalid) {
-			if (e->tav.type == nullptr || e->tav.type == t_invalid) {
-				add_type_and_value(c->info, e, e->tav.mode, type ? type : e->tav.type, e->tav.value);
+			if (e->tav->type == nullptr || e->tav->type == t_invalid) {
+				add_type_and_value(c->info, e, e->tav->mode, type ? type : e->tav->type, e->tav->value);
 			}
 		}
 		return;
@@ -3302,7 +3322,7 @@ bool check_index_value(CheckerContext *c, bool open_range, Ast *index_value, i64
 	if (operand.mode == Addressing_Constant &&
 	    (c->state_flags & StateFlag_no_bounds_check) == 0) {
 		BigInt i = exact_value_to_integer(operand.value).value_integer;
-		if (i.sign && !is_type_enum(index_type)) {
+		if (big_int_is_neg(&i) && !is_type_enum(index_type)) {
 			gbString expr_str = expr_to_string(operand.expr);
 			error(operand.expr, "Index '%s' cannot be a negative value", expr_str);
 			gb_string_free(expr_str);
@@ -3348,7 +3368,7 @@ bool check_index_value(CheckerContext *c, bool open_range, Ast *index_value, i64
 
 			} else { // NOTE(bill): Do array bound checking
 				i64 v = -1;
-				if (i.used <= 1) {
+				if (!big_int_is_big(&i)) {
 					v = big_int_to_i64(&i);
 				}
 				if (value) *value = v;
@@ -3407,7 +3427,7 @@ ExactValue get_constant_field_single(CheckerContext *c, ExactValue value, i32 in
 		}
 
 		if (cl->elems[0]->kind == Ast_FieldValue) {
-			if (is_type_struct(node->tav.type)) {
+			if (is_type_struct(node->tav->type)) {
 				for_array(i, cl->elems) {
 					Ast *elem = cl->elems[i];
 					if (elem->kind != Ast_FieldValue) {
@@ -3415,14 +3435,14 @@ ExactValue get_constant_field_single(CheckerContext *c, ExactValue value, i32 in
 					}
 					ast_node(fv, FieldValue, elem);
 					String name = fv->field->Ident.token.string;
-					Selection sub_sel = lookup_field(node->tav.type, name, false);
+					Selection sub_sel = lookup_field(node->tav->type, name, false);
 					defer (array_free(&sub_sel.index));
 					if (sub_sel.index[0] == index) {
-						value = fv->value->tav.value;
+						value = fv->value->tav->value;
 						break;
 					}
 				}
-			} else if (is_type_array(node->tav.type) || is_type_enumerated_array(node->tav.type)) {
+			} else if (is_type_array(node->tav->type) || is_type_enumerated_array(node->tav->type)) {
 				for_array(i, cl->elems) {
 					Ast *elem = cl->elems[i];
 					if (elem->kind != Ast_FieldValue) {
@@ -3431,8 +3451,8 @@ ExactValue get_constant_field_single(CheckerContext *c, ExactValue value, i32 in
 					ast_node(fv, FieldValue, elem);
 					if (is_ast_range(fv->field)) {
 						ast_node(ie, BinaryExpr, fv->field);
-						TypeAndValue lo_tav = ie->left->tav;
-						TypeAndValue hi_tav = ie->right->tav;
+						TypeAndValue lo_tav = *ie->left->tav;
+						TypeAndValue hi_tav = *ie->right->tav;
 						GB_ASSERT(lo_tav.mode == Addressing_Constant);
 						GB_ASSERT(hi_tav.mode == Addressing_Constant);
 
@@ -3442,39 +3462,39 @@ ExactValue get_constant_field_single(CheckerContext *c, ExactValue value, i32 in
 
 						i64 corrected_index = index;
 
-						if (is_type_enumerated_array(node->tav.type)) {
-							Type *bt = base_type(node->tav.type);
+						if (is_type_enumerated_array(node->tav->type)) {
+							Type *bt = base_type(node->tav->type);
 							GB_ASSERT(bt->kind == Type_EnumeratedArray);
 							corrected_index = index + exact_value_to_i64(bt->EnumeratedArray.min_value);
 						}
 						if (op != Token_RangeHalf) {
 							if (lo <= corrected_index && corrected_index <= hi) {
-								TypeAndValue tav = fv->value->tav;
+								TypeAndValue tav = *fv->value->tav;
 								if (success_) *success_ = true;
 								if (finish_) *finish_ = false;
 								return tav.value;
 							}
 						} else {
 							if (lo <= corrected_index && corrected_index < hi) {
-								TypeAndValue tav = fv->value->tav;
+								TypeAndValue tav = *fv->value->tav;
 								if (success_) *success_ = true;
 								if (finish_) *finish_ = false;
 								return tav.value;
 							}
 						}
 					} else {
-						TypeAndValue index_tav = fv->field->tav;
+						TypeAndValue index_tav = *fv->field->tav;
 						GB_ASSERT(index_tav.mode == Addressing_Constant);
 						ExactValue index_value = index_tav.value;
-						if (is_type_enumerated_array(node->tav.type)) {
-							Type *bt = base_type(node->tav.type);
+						if (is_type_enumerated_array(node->tav->type)) {
+							Type *bt = base_type(node->tav->type);
 							GB_ASSERT(bt->kind == Type_EnumeratedArray);
 							index_value = exact_value_sub(index_value, bt->EnumeratedArray.min_value);
 						}
 
 						i64 field_index = exact_value_to_i64(index_value);
 						if (index == field_index) {
-							TypeAndValue tav = fv->value->tav;
+							TypeAndValue tav = *fv->value->tav;
 							if (success_) *success_ = true;
 							if (finish_) *finish_ = false;
 							return tav.value;;
@@ -3496,7 +3516,7 @@ ExactValue get_constant_field_single(CheckerContext *c, ExactValue value, i32 in
 				return value;
 			}
 
-			TypeAndValue tav = cl->elems[index]->tav;
+			TypeAndValue tav = *cl->elems[index]->tav;
 			if (tav.mode == Addressing_Constant) {
 				if (success_) *success_ = true;
 				if (finish_) *finish_ = false;
@@ -3673,7 +3693,7 @@ Entity *check_selector(CheckerContext *c, Operand *operand, Ast *node, Type *typ
 
 	if (op_expr->kind == Ast_Ident) {
 		String op_name = op_expr->Ident.token.string;
-		Entity *e = scope_lookup(c->scope, op_name);
+		Entity *e = scope_lookup(c->scope, token_hash_key(op_expr->Ident.token));
 		add_entity_use(c, op_expr, e);
 		expr_entity = e;
 
@@ -3687,7 +3707,7 @@ Entity *check_selector(CheckerContext *c, Operand *operand, Ast *node, Type *typ
 			String entity_name = selector->Ident.token.string;
 
 			check_op_expr = false;
-			entity = scope_lookup_current(import_scope, entity_name);
+			entity = scope_lookup_current(import_scope, token_hash_key(selector->Ident.token));
 			bool is_declared = entity != nullptr;
 			bool allow_builtin = false;
 			if (is_declared) {
@@ -4081,7 +4101,7 @@ isize add_dependencies_from_unpacking(CheckerContext *c, Entity **lhs, isize lhs
 				if (decl != nullptr) {
 					c->decl = decl; // will be reset by the 'defer' any way
 					for_array(k, decl->deps.entries) {
-						Entity *dep = decl->deps.entries[k].ptr;
+						Entity *dep = decl->deps.entries[k];
 						add_declaration_dependency(c, dep); // TODO(bill): Should this be here?
 					}
 				}
@@ -4270,7 +4290,7 @@ bool check_unpack_arguments(CheckerContext *ctx, Entity **lhs, isize lhs_count,
 
 bool is_expr_constant_zero(Ast *expr) {
 	GB_ASSERT(expr != nullptr);
-	auto v = exact_value_to_integer(expr->tav.value);
+	auto v = exact_value_to_integer(expr->tav->value);
 	if (v.kind == ExactValue_Integer) {
 		return big_int_cmp_zero(&v.value_integer) == 0;
 	}
@@ -6391,7 +6411,7 @@ ExprKind check_expr_base_internal(CheckerContext *c, Operand *o, Ast *node, Type
 
 	case_ast_node(bl, BasicLit, node);
 		Type *t = t_invalid;
-		switch (node->tav.value.kind) {
+		switch (node->tav->value.kind) {
 		case ExactValue_String:     t = t_untyped_string;     break;
 		case ExactValue_Float:      t = t_untyped_float;      break;
 		case ExactValue_Complex:    t = t_untyped_complex;    break;
@@ -6409,7 +6429,7 @@ ExprKind check_expr_base_internal(CheckerContext *c, Operand *o, Ast *node, Type
 
 		o->mode  = Addressing_Constant;
 		o->type  = t;
-		o->value = node->tav.value;
+		o->value = node->tav->value;
 	case_end;
 
 	case_ast_node(bd, BasicDirective, node);
@@ -7410,7 +7430,7 @@ ExprKind check_expr_base_internal(CheckerContext *c, Operand *o, Ast *node, Type
 					Entity *field = nullptr;
 					Ast *elem = cl->elems[index];
 					GB_ASSERT(elem->kind != Ast_FieldValue);
-					TypeAndValue tav = elem->tav;
+					TypeAndValue tav = *elem->tav;
 					ExactValue i = exact_value_to_integer(tav.value);
 					if (i.kind != ExactValue_Integer) {
 						continue;
@@ -7704,9 +7724,9 @@ ExprKind check_expr_base_internal(CheckerContext *c, Operand *o, Ast *node, Type
 		if (se->modified_call) {
 			// Prevent double evaluation
 			o->expr  = node;
-			o->type  = node->tav.type;
-			o->value = node->tav.value;
-			o->mode  = node->tav.mode;
+			o->type  = node->tav->type;
+			o->value = node->tav->value;
+			o->mode  = node->tav->mode;
 			return Expr_Expr;
 		}
 
@@ -7763,9 +7783,9 @@ ExprKind check_expr_base_internal(CheckerContext *c, Operand *o, Ast *node, Type
 		}
 
 		Operand y = {};
-		y.mode = first_arg->tav.mode;
-		y.type = first_arg->tav.type;
-		y.value = first_arg->tav.value;
+		y.mode = first_arg->tav->mode;
+		y.type = first_arg->tav->type;
+		y.value = first_arg->tav->value;
 		if (check_is_assignable_to(c, &y, first_type)) {
 			// Do nothing, it's valid
 		} else {
@@ -8350,12 +8370,12 @@ bool is_exact_value_zero(ExactValue const &v) {
 			} else {
 				for_array(i, cl->elems) {
 					Ast *elem = cl->elems[i];
-					if (elem->tav.mode != Addressing_Constant) {
-						// if (elem->tav.value.kind != ExactValue_Invalid) {
+					if (elem->tav->mode != Addressing_Constant) {
+						// if (elem->tav->value.kind != ExactValue_Invalid) {
 						return false;
 						// }
 					}
-					if (!is_exact_value_zero(elem->tav.value)) {
+					if (!is_exact_value_zero(elem->tav->value)) {
 						return false;
 					}
 				}
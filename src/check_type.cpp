@@ -207,7 +207,7 @@ bool check_custom_align(CheckerContext *ctx, Ast *node, i64 *align_) {
 	if (is_type_untyped(type) || is_type_integer(type)) {
 		if (o.value.kind == ExactValue_Integer) {
 			BigInt v = o.value.value_integer;
-			if (v.used > 1) {
+			if (big_int_is_big(&v)) {
 				gbAllocator a = heap_allocator();
 				String str = big_int_to_string(a, &v);
 				error(node, "#align too large, %.*s", LIT(str));
@@ -1087,7 +1087,7 @@ bool check_type_specialization_to(CheckerContext *ctx, Type *specialization, Typ
 
 			if (modify_type) {
 				// NOTE(bill): This is needed in order to change the actual type but still have the types defined within it
-				gb_memmove(specialization, type, gb_size_of(Type));
+				type_overwrite_in_place(specialization, type);
 			}
 
 			return true;
@@ -1126,7 +1126,7 @@ bool check_type_specialization_to(CheckerContext *ctx, Type *specialization, Typ
 
 			if (modify_type) {
 				// NOTE(bill): This is needed in order to change the actual type but still have the types defined within it
-				gb_memmove(specialization, type, gb_size_of(Type));
+				type_overwrite_in_place(specialization, type);
 			}
 
 			return true;
@@ -2005,9 +2005,8 @@ i64 check_array_count(CheckerContext *ctx, Operand *o, Ast *e) {
 				gb_free(a, str.text);
 				return 0;
 			}
-			switch (count.used) {
-			case 0: return 0;
-			case 1: return big_int_to_u64(&count);
+			if (!big_int_is_big(&count)) {
+				return big_int_to_i64(&count);
 			}
 			gbAllocator a = heap_allocator();
 			String str = big_int_to_string(a, &count);
@@ -2395,8 +2394,9 @@ bool check_type_internal(CheckerContext *ctx, Ast *e, Type **type, Type *named_t
 	case_end;
 
 	case_ast_node(tt, TypeidType, e);
-		e->tav.mode = Addressing_Type;
-		e->tav.type = t_typeid;
+		TypeAndValue *tav = ast_tav_for_write(e);
+		tav->mode = Addressing_Type;
+		tav->type = t_typeid;
 		*type = t_typeid;
 		set_base_type(named_type, *type);
 		return true;
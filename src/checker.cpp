@@ -38,8 +38,7 @@ void scope_reset(Scope *scope) {
 }
 
 void scope_reserve(Scope *scope, isize capacity) {
-	isize cap = 2*capacity;
-	if (cap > scope->elements.hashes.count) {
+	if (hash_index_capacity_for(capacity) > scope->elements.index.capacity) {
 		string_map_rehash(&scope->elements, capacity);
 	}
 }
@@ -57,13 +56,13 @@ i32 is_scope_an_ancestor(Scope *parent, Scope *child) {
 }
 
 void entity_graph_node_set_destroy(EntityGraphNodeSet *s) {
-	if (s->hashes.data != nullptr) {
+	if (s->entries.data != nullptr) {
 		ptr_set_destroy(s);
 	}
 }
 
 void entity_graph_node_set_add(EntityGraphNodeSet *s, EntityGraphNode *n) {
-	if (s->hashes.data == nullptr) {
+	if (s->entries.data == nullptr) {
 		ptr_set_init(s, heap_allocator());
 	}
 	ptr_set_add(s, n);
@@ -110,13 +109,13 @@ void entity_graph_node_swap(EntityGraphNode **data, isize i, isize j) {
 
 
 void import_graph_node_set_destroy(ImportGraphNodeSet *s) {
-	if (s->hashes.data != nullptr) {
+	if (s->entries.data != nullptr) {
 		ptr_set_destroy(s);
 	}
 }
 
 void import_graph_node_set_add(ImportGraphNodeSet *s, ImportGraphNode *n) {
-	if (s->hashes.data == nullptr) {
+	if (s->entries.data == nullptr) {
 		ptr_set_init(s, heap_allocator());
 	}
 	ptr_set_add(s, n);
@@ -185,9 +184,9 @@ GB_COMPARE_PROC(ast_node_cmp) {
 void init_decl_info(DeclInfo *d, Scope *scope, DeclInfo *parent) {
 	d->parent = parent;
 	d->scope  = scope;
-	ptr_set_init(&d->deps,           heap_allocator());
-	ptr_set_init(&d->type_info_deps, heap_allocator());
-	array_init  (&d->labels,         heap_allocator());
+	small_id_set_init(&d->deps,           heap_allocator());
+	small_id_set_init(&d->type_info_deps, heap_allocator());
+	array_init       (&d->labels,         heap_allocator());
 }
 
 DeclInfo *make_decl_info(Scope *scope, DeclInfo *parent) {
@@ -197,7 +196,8 @@ DeclInfo *make_decl_info(Scope *scope, DeclInfo *parent) {
 }
 
 void destroy_declaration_info(DeclInfo *d) {
-	ptr_set_destroy(&d->deps);
+	small_id_set_destroy(&d->deps);
+	small_id_set_destroy(&d->type_info_deps);
 	array_free(&d->labels);
 }
 
@@ -347,18 +347,21 @@ void check_close_scope(CheckerContext *c) {
 }
 
 
-Entity *scope_lookup_current(Scope *s, String const &name) {
-	Entity **found = string_map_get(&s->elements, name);
+Entity *scope_lookup_current(Scope *s, StringHashKey const &key) {
+	Entity **found = string_map_get(&s->elements, key);
 	if (found) {
 		return *found;
 	}
 	return nullptr;
 }
 
-void scope_lookup_parent(Scope *scope, String const &name, Scope **scope_, Entity **entity_) {
+Entity *scope_lookup_current(Scope *s, String const &name) {
+	return scope_lookup_current(s, string_hash_string(name));
+}
+
+void scope_lookup_parent(Scope *scope, StringHashKey const &key, Scope **scope_, Entity **entity_) {
 	bool gone_thru_proc = false;
 	bool gone_thru_package = false;
-	StringHashKey key = string_hash_string(name);
 	for (Scope *s = scope; s != nullptr; s = s->parent) {
 		Entity **found = string_map_get(&s->elements, key);
 		if (found) {
@@ -397,19 +400,26 @@ void scope_lookup_parent(Scope *scope, String const &name, Scope **scope_, Entit
 	if (scope_) *scope_ = nullptr;
 }
 
-Entity *scope_lookup(Scope *s, String const &name) {
+void scope_lookup_parent(Scope *scope, String const &name, Scope **scope_, Entity **entity_) {
+	scope_lookup_parent(scope, string_hash_string(name), scope_, entity_);
+}
+
+Entity *scope_lookup(Scope *s, StringHashKey const &key) {
 	Entity *entity = nullptr;
-	scope_lookup_parent(s, name, nullptr, &entity);
+	scope_lookup_parent(s, key, nullptr, &entity);
 	return entity;
 }
 
+Entity *scope_lookup(Scope *s, String const &name) {
+	return scope_lookup(s, string_hash_string(name));
+}
+
 
 
-Entity *scope_insert_with_name(Scope *s, String const &name, Entity *entity) {
-	if (name == "") {
+Entity *scope_insert_with_key(Scope *s, StringHashKey const &key, Entity *entity) {
+	if (key.string == "") {
 		return nullptr;
 	}
-	StringHashKey key = string_hash_string(name);
 	Entity **found = string_map_get(&s->elements, key);
 
 	if (found) {
@@ -431,9 +441,12 @@ Entity *scope_insert_with_name(Scope *s, String const &name, Entity *entity) {
 	return nullptr;
 }
 
+Entity *scope_insert_with_name(Scope *s, String const &name, Entity *entity) {
+	return scope_insert_with_key(s, string_hash_string(name), entity);
+}
+
 Entity *scope_insert(Scope *s, Entity *entity) {
-	String name = entity->token.string;
-	return scope_insert_with_name(s, name, entity);
+	return scope_insert_with_key(s, token_hash_key(entity->token), entity);
 }
 
 
@@ -630,14 +643,14 @@ void check_scope_usage(Checker *c, Scope *scope) {
 
 
 void add_dependency(DeclInfo *d, Entity *e) {
-	ptr_set_add(&d->deps, e);
+	small_id_set_add(&d->deps, e);
 }
 void add_type_info_dependency(DeclInfo *d, Type *type) {
 	if (d == nullptr) {
 		// GB_ASSERT(type == t_invalid);
 		return;
 	}
-	ptr_set_add(&d->type_info_deps, type);
+	small_id_set_add(&d->type_info_deps, type);
 }
 
 AstPackage *get_core_package(CheckerInfo *info, String name) {
@@ -657,7 +670,7 @@ void add_package_dependency(CheckerContext *c, char const *package_name, char co
 	e->flags |= EntityFlag_Used;
 	GB_ASSERT_MSG(e != nullptr, "%s", name);
 	GB_ASSERT(c->decl != nullptr);
-	ptr_set_add(&c->decl->deps, e);
+	small_id_set_add(&c->decl->deps, e);
 }
 
 void add_declaration_dependency(CheckerContext *c, Entity *e) {
@@ -724,6 +737,7 @@ void init_universal(void) {
 
 // Types
 	for (isize i = 0; i < gb_count_of(basic_types); i++) {
+		basic_types[i].id = 1+global_type_id.fetch_add(1, std::memory_order_relaxed);
 		add_global_type_entity(basic_types[i].Basic.name, &basic_types[i]);
 	}
 	add_global_type_entity(str_lit("byte"), &basic_types[Basic_u8]);
@@ -734,6 +748,9 @@ void init_universal(void) {
 
 		Type *hasher_args[2] = {t_rawptr, t_uintptr};
 		t_hasher_proc = alloc_type_proc_from_types(hasher_args, 2, t_uintptr, false, ProcCC_Contextless);
+
+		Type *map_get_args[3] = {t_rawptr, t_rawptr, t_uintptr};
+		t_map_get_proc = alloc_type_proc_from_types(map_get_args, 3, t_rawptr, false, ProcCC_Contextless);
 	}
 
 // Constants
@@ -834,10 +851,17 @@ void init_checker_info(CheckerInfo *i) {
 	array_init(&i->entities,      a);
 	map_init(&i->global_untyped, a);
 	string_map_init(&i->foreigns, a);
+	string_map_init(&i->load_file_cache, a);
+	map_init(&i->load_file_data, a);
 	map_init(&i->gen_procs,       a);
+	map_init(&i->gen_proc_instances, a);
 	map_init(&i->gen_types,       a);
 	array_init(&i->type_info_types, a);
-	map_init(&i->type_info_map,   a);
+	for (isize j = 0; j < TYPE_INFO_SHARD_COUNT; j++) {
+		mutex_init(&i->type_info_shards[j].mutex);
+		map_init(&i->type_info_shards[j].map, a);
+		map_init(&i->type_info_shards[j].structural_map, a);
+	}
 	string_map_init(&i->files,    a);
 	string_map_init(&i->packages, a);
 	array_init(&i->variable_init_order, a);
@@ -870,6 +894,7 @@ void init_checker_info(CheckerInfo *i) {
 	mutex_init(&i->deps_mutex);
 	mutex_init(&i->identifier_uses_mutex);
 	mutex_init(&i->foreign_mutex);
+	mutex_init(&i->load_file_mutex);
 
 	gb_semaphore_init(&i->collect_semaphore);
 
@@ -882,10 +907,17 @@ void destroy_checker_info(CheckerInfo *i) {
 	array_free(&i->entities);
 	map_destroy(&i->global_untyped);
 	string_map_destroy(&i->foreigns);
+	string_map_destroy(&i->load_file_cache);
+	map_destroy(&i->load_file_data);
 	map_destroy(&i->gen_procs);
+	map_destroy(&i->gen_proc_instances);
 	map_destroy(&i->gen_types);
 	array_free(&i->type_info_types);
-	map_destroy(&i->type_info_map);
+	for (isize j = 0; j < TYPE_INFO_SHARD_COUNT; j++) {
+		mutex_destroy(&i->type_info_shards[j].mutex);
+		map_destroy(&i->type_info_shards[j].map);
+		map_destroy(&i->type_info_shards[j].structural_map);
+	}
 	string_map_destroy(&i->files);
 	string_map_destroy(&i->packages);
 	array_free(&i->variable_init_order);
@@ -906,6 +938,62 @@ void destroy_checker_info(CheckerInfo *i) {
 	mutex_destroy(&i->deps_mutex);
 	mutex_destroy(&i->identifier_uses_mutex);
 	mutex_destroy(&i->foreign_mutex);
+	mutex_destroy(&i->load_file_mutex);
+}
+
+
+// NOTE: The file is loaded (and hashed, if needed) without holding the lock, and if another thread
+// loaded the same path in the meantime, its entry is used instead
+LoadFileCache *load_file_cached(CheckerInfo *info, String const &path) {
+	mutex_lock(&info->load_file_mutex);
+	LoadFileCache **found = string_map_get(&info->load_file_cache, path);
+	mutex_unlock(&info->load_file_mutex);
+	if (found != nullptr) {
+		return *found;
+	}
+
+	LoadFileCache *cache = gb_alloc_item(permanent_allocator(), LoadFileCache);
+	cache->path = copy_string(permanent_allocator(), path);
+
+	char *c_str = alloc_cstring(heap_allocator(), path);
+	cache->error = load_file(c_str, &cache->file);
+	gb_free(heap_allocator(), c_str);
+
+	if (cache->error == LoadedFile_None) {
+		cache->data = make_string(cast(u8 *)cache->file.data, cache->file.size);
+	} else if (cache->error == LoadedFile_Empty) {
+		cache->error = LoadedFile_None;
+	}
+	if (build_context.incremental) {
+		cache->hash = fnv64a(path.text, path.len) ^ (fnv64a(cache->data.text, cache->data.len) * 0x100000001b3ull);
+	}
+
+	mutex_lock(&info->load_file_mutex);
+	defer (mutex_unlock(&info->load_file_mutex));
+	found = string_map_get(&info->load_file_cache, path);
+	if (found != nullptr) {
+		unload_file(&cache->file);
+		return *found;
+	}
+	string_map_set(&info->load_file_cache, cache->path, cache);
+	if (cache->data.len > 0) {
+		map_set(&info->load_file_data, hash_pointer(cache->data.text), cache);
+	}
+	return cache;
+}
+
+// NOTE: Returns the '#load' which `data` is the whole contents of, if any
+LoadFileCache *load_file_cache_from_data(CheckerInfo *info, String const &data) {
+	if (data.len == 0) {
+		return nullptr;
+	}
+	mutex_lock(&info->load_file_mutex);
+	defer (mutex_unlock(&info->load_file_mutex));
+	LoadFileCache **found = map_get(&info->load_file_data, hash_pointer(data.text));
+	if (found != nullptr && (*found)->data.len == data.len) {
+		return *found;
+	}
+	return nullptr;
 }
 
 CheckerContext make_checker_context(Checker *c) {
@@ -969,6 +1057,8 @@ void init_checker(Checker *c) {
 
 	mpmc_init(&c->global_untyped_queue, a, 1<<20);
 
+	array_init(&c->package_levels, a);
+
 	c->builtin_ctx = make_checker_context(c);
 
 #undef TIME_SECTION
@@ -983,19 +1073,24 @@ void destroy_checker(Checker *c) {
 	gb_semaphore_destroy(&c->procs_to_check_semaphore);
 
 	mpmc_destroy(&c->global_untyped_queue);
+
+	for_array(i, c->package_levels) {
+		array_free(&c->package_levels[i]);
+	}
+	array_free(&c->package_levels);
 }
 
 
 TypeAndValue type_and_value_of_expr(Ast *expr) {
 	TypeAndValue tav = {};
 	if (expr != nullptr) {
-		tav = expr->tav;
+		tav = *expr->tav;
 	}
 	return tav;
 }
 
 Type *type_of_expr(Ast *expr) {
-	TypeAndValue tav = expr->tav;
+	TypeAndValue tav = *expr->tav;
 	if (tav.mode != Addressing_Invalid) {
 		return tav.type;
 	}
@@ -1097,36 +1192,38 @@ void check_remove_expr_info(CheckerContext *c, Ast *e) {
 }
 
 
+gb_inline TypeInfoShard *type_info_shard(CheckerInfo *info, u64 hash) {
+	return &info->type_info_shards[hash % TYPE_INFO_SHARD_COUNT];
+}
+
+// NOTE: `shard->mutex` must be held. Returns the index into `type_info_types` or -1 if not found
+isize type_info_shard_find(TypeInfoShard *shard, Type *type, u64 hash) {
+	isize *found = map_get(&shard->map, hash_type(type));
+	if (found) {
+		return *found;
+	}
+	auto *e = multi_map_find_first(&shard->structural_map, hash_integer(hash));
+	for (; e != nullptr; e = multi_map_find_next(&shard->structural_map, e)) {
+		if (are_types_identical(e->value.type, type)) {
+			// NOTE: Add it to the search map
+			map_set(&shard->map, hash_type(type), e->value.index);
+			return e->value.index;
+		}
+	}
+	return -1;
+}
+
 isize type_info_index(CheckerInfo *info, Type *type, bool error_on_failure) {
 	type = default_type(type);
 	if (type == t_llvm_bool) {
 		type = t_bool;
 	}
 
-	mutex_lock(&info->type_info_mutex);
-
-	isize entry_index = -1;
-	HashKey key = hash_type(type);
-	isize *found_entry_index = map_get(&info->type_info_map, key);
-	if (found_entry_index) {
-		entry_index = *found_entry_index;
-	}
-	if (entry_index < 0) {
-		// NOTE(bill): Do manual search
-		// TODO(bill): This is O(n) and can be very slow
-		for_array(i, info->type_info_map.entries){
-			auto *e = &info->type_info_map.entries[i];
-			Type *prev_type = cast(Type *)cast(uintptr)e->key.key;
-			if (are_types_identical(prev_type, type)) {
-				entry_index = e->value;
-				// NOTE(bill): Add it to the search map
-				map_set(&info->type_info_map, key, entry_index);
-				break;
-			}
-		}
-	}
-
-	mutex_unlock(&info->type_info_mutex);
+	u64 hash = type_hash(type);
+	TypeInfoShard *shard = type_info_shard(info, hash);
+	mutex_lock(&shard->mutex);
+	isize entry_index = type_info_shard_find(shard, type, hash);
+	mutex_unlock(&shard->mutex);
 
 	if (error_on_failure && entry_index < 0) {
 		compiler_error("Type_Info for '%s' could not be found", type_to_string(type));
@@ -1166,14 +1263,15 @@ void add_type_and_value(CheckerInfo *i, Ast *expr, AddressingMode mode, Type *ty
 	Ast *prev_expr = nullptr;
 	for (;;) {
 		if (prev_expr != expr) {
-			expr->tav.mode = mode;
-			expr->tav.type = type;
+			TypeAndValue *tav = ast_tav_for_write(expr);
+			tav->mode = mode;
+			tav->type = type;
 			if (mode == Addressing_Constant || mode == Addressing_Invalid) {
-				expr->tav.value = value;
+				tav->value = value;
 			} else if (mode == Addressing_Value && is_type_typeid(type)) {
-				expr->tav.value = value;
+				tav->value = value;
 			} else if (mode == Addressing_Value && is_type_proc(type)) {
-				expr->tav.value = value;
+				tav->value = value;
 			}
 
 			prev_expr = expr;
@@ -1428,9 +1526,7 @@ void add_implicit_entity(CheckerContext *c, Ast *clause, Entity *e) {
 void add_type_info_type(CheckerContext *c, Type *t) {
 	void add_type_info_type_internal(CheckerContext *c, Type *t);
 
-	mutex_lock(&c->info->type_info_mutex);
 	add_type_info_type_internal(c, t);
-	mutex_unlock(&c->info->type_info_mutex);
 }
 
 void add_type_info_type_internal(CheckerContext *c, Type *t) {
@@ -1447,31 +1543,34 @@ void add_type_info_type_internal(CheckerContext *c, Type *t) {
 
 	add_type_info_dependency(c->decl, t);
 
-	auto found = map_get(&c->info->type_info_map, hash_type(t));
-	if (found != nullptr) {
+	// NOTE: The shard is only locked for this type and not whilst adding its nested types,
+	// so other threads can add types at the same time
+	// NOTE: The type is now in use, so its hash cannot change after it has been added to a shard
+	u64 hash = type_hash_final(t);
+	TypeInfoShard *shard = type_info_shard(c->info, hash);
+	mutex_lock(&shard->mutex);
+
+	if (map_get(&shard->map, hash_type(t)) != nullptr) {
 		// Types have already been added
+		mutex_unlock(&shard->mutex);
 		return;
 	}
 
-	bool prev = false;
-	isize ti_index = -1;
-	for_array(i, c->info->type_info_map.entries) {
-		auto *e = &c->info->type_info_map.entries[i];
-		Type *prev_type = cast(Type *)cast(uintptr)e->key.key;
-		if (are_types_identical(t, prev_type)) {
-			// Duplicate entry
-			ti_index = e->value;
-			prev = true;
-			break;
-		}
-	}
-	if (ti_index < 0) {
+	// Duplicate entry
+	isize ti_index = type_info_shard_find(shard, t, hash);
+	bool prev = ti_index >= 0;
+	if (!prev) {
 		// Unique entry
-		// NOTE(bill): map entries grow linearly and in order
+		mutex_lock(&c->info->type_info_mutex);
 		ti_index = c->info->type_info_types.count;
 		array_add(&c->info->type_info_types, t);
+		mutex_unlock(&c->info->type_info_mutex);
+
+		TypeInfoUnique unique = {t, ti_index};
+		multi_map_insert(&shard->structural_map, hash_integer(hash), unique);
+		map_set(&shard->map, hash_type(t), ti_index);
 	}
-	map_set(&c->checker->info.type_info_map, hash_type(t), ti_index);
+	mutex_unlock(&shard->mutex);
 
 	if (prev) {
 		// NOTE(bill): If a previous one exists already, no need to continue
@@ -1643,6 +1742,14 @@ void add_type_info_type_internal(CheckerContext *c, Type *t) {
 
 
 gb_global bool global_procedure_body_in_worker_queue = false;
+gb_global bool global_entities_in_worker_queue = false;
+
+// NOTE: The procedure body which is being checked by `check_proc_info` on this thread, if any
+thread_local DeclInfo *checker_proc_body_decl = nullptr;
+
+// NOTE: The queue of the package whose global entities are being checked on this thread by
+// `check_all_global_entities_threaded`, if any
+thread_local ProcBodyQueue *checker_global_entities_queue = nullptr;
 
 void check_procedure_later(CheckerContext *c, ProcInfo *info) {
 	GB_ASSERT(info != nullptr);
@@ -1652,7 +1759,15 @@ void check_procedure_later(CheckerContext *c, ProcInfo *info) {
 		GB_ASSERT(c->procs_to_check_queue != nullptr);
 	}
 
-	auto *queue = c->procs_to_check_queue ? c->procs_to_check_queue : &c->checker->procs_to_check_queue;
+	auto *queue = c->procs_to_check_queue;
+	if (queue == nullptr) {
+		queue = checker_global_entities_queue;
+	}
+	if (queue == nullptr) {
+		// NOTE: Only a single thread may add to the global queue, as its buffer may be resized
+		GB_ASSERT(!global_entities_in_worker_queue);
+		queue = &c->checker->procs_to_check_queue;
+	}
 	mpmc_enqueue(queue, info);
 }
 
@@ -1848,57 +1963,161 @@ void add_min_dep_type_info(Checker *c, Type *t) {
 }
 
 
+// NOTE: The dependencies of the roots are added by `walk_minimum_dependency_set`
 void add_dependency_to_set(Checker *c, Entity *entity) {
 	if (entity == nullptr) {
 		return;
 	}
+	array_add(&c->info.minimum_dependency_roots, entity);
+}
 
-	CheckerInfo *info = &c->info;
-	auto *set = &info->minimum_dependency_set;
-
+bool is_minimum_dependency_candidate(Entity *entity) {
+	if (entity == nullptr) {
+		return false;
+	}
 	if (entity->type != nullptr &&
 	    is_type_polymorphic(entity->type)) {
 
 		DeclInfo *decl = decl_info_of_entity(entity);
 		if (decl != nullptr && decl->gen_proc_type == nullptr) {
-			return;
+			return false;
 		}
 	}
+	return true;
+}
 
-	if (ptr_set_update(set, entity)) {
-		return;
+struct MinDepWorkerData {
+	Entity **              frontier;
+	isize                  frontier_count;
+	IdSet<Entity *> const *visited;
+	Array<Entity *>        found; // NOTE: May contain duplicates, these are removed when merging
+};
+
+void min_dep_add_candidate(MinDepWorkerData *wd, Entity *e) {
+	if (is_minimum_dependency_candidate(e) && !id_set_exists(wd->visited, e)) {
+		array_add(&wd->found, e);
 	}
+}
 
-	DeclInfo *decl = decl_info_of_entity(entity);
-	if (decl == nullptr) {
-		return;
+WORKER_TASK_PROC(min_dep_worker_proc) {
+	auto *wd = cast(MinDepWorkerData *)data;
+	for (isize i = 0; i < wd->frontier_count; i++) {
+		Entity *entity = wd->frontier[i];
+		DeclInfo *decl = decl_info_of_entity(entity);
+		if (decl == nullptr) {
+			continue;
+		}
+
+		for_array(j, decl->deps.entries) {
+			Entity *e = decl->deps.entries[j];
+			min_dep_add_candidate(wd, e);
+			if (e->kind == Entity_Procedure && e->Procedure.is_foreign) {
+				Entity *fl = e->Procedure.foreign_library;
+				if (fl != nullptr) {
+					GB_ASSERT_MSG(fl->kind == Entity_LibraryName &&
+					              (fl->flags&EntityFlag_Used),
+					              "%.*s", LIT(entity->token.string));
+					min_dep_add_candidate(wd, fl);
+				}
+			} else if (e->kind == Entity_Variable && e->Variable.is_foreign) {
+				Entity *fl = e->Variable.foreign_library;
+				if (fl != nullptr) {
+					GB_ASSERT_MSG(fl->kind == Entity_LibraryName &&
+					              (fl->flags&EntityFlag_Used),
+					              "%.*s", LIT(entity->token.string));
+					min_dep_add_candidate(wd, fl);
+				}
+			}
+		}
 	}
+	return 0;
+}
 
-	for_array(i, decl->type_info_deps.entries) {
-		Type *type = decl->type_info_deps.entries[i].ptr;
-		add_min_dep_type_info(c, type);
+// NOTE: A level-synchronous breadth first search from the roots
+// The dependencies of each level are found in parallel against the entities visited in the previous levels,
+// and then merged in the order of the frontier, so the order of the set does not depend upon the threads
+void walk_minimum_dependency_set(Checker *c) {
+	enum : isize {MIN_DEP_ENTITIES_PER_TASK = 256};
+
+	// NOTE: The set is its own visited set; it is only read by the workers and only written when merging
+	auto *set = &c->info.minimum_dependency_set;
+
+	auto frontier      = array_make<Entity *>(heap_allocator(), 0, c->info.minimum_dependency_roots.count);
+	auto next_frontier = array_make<Entity *>(heap_allocator());
+	auto worker_data   = array_make<MinDepWorkerData>(heap_allocator());
+	defer (array_free(&frontier));
+	defer (array_free(&next_frontier));
+	defer ({
+		for_array(i, worker_data) {
+			array_free(&worker_data[i].found);
+		}
+		array_free(&worker_data);
+	});
+
+	for_array(i, c->info.minimum_dependency_roots) {
+		Entity *e = c->info.minimum_dependency_roots[i];
+		if (is_minimum_dependency_candidate(e) && !id_set_update(set, e)) {
+			array_add(&frontier, e);
+		}
 	}
 
-	for_array(i, decl->deps.entries) {
-		Entity *e = decl->deps.entries[i].ptr;
-		add_dependency_to_set(c, e);
-		if (e->kind == Entity_Procedure && e->Procedure.is_foreign) {
-			Entity *fl = e->Procedure.foreign_library;
-			if (fl != nullptr) {
-				GB_ASSERT_MSG(fl->kind == Entity_LibraryName &&
-				              (fl->flags&EntityFlag_Used),
-				              "%.*s", LIT(entity->token.string));
-				add_dependency_to_set(c, fl);
+	isize thread_count = gb_max(build_context.thread_count, 1);
+	isize worker_count = thread_count-1; // NOTE(bill): The main thread will also be used for work
+	ThreadPool pool = {};
+	thread_pool_init(&pool, heap_allocator(), worker_count, "MinDepWork");
+	defer (thread_pool_destroy(&pool));
+	thread_pool_start(&pool);
+
+	while (frontier.count > 0) {
+		isize task_count = (frontier.count + MIN_DEP_ENTITIES_PER_TASK-1) / MIN_DEP_ENTITIES_PER_TASK;
+		while (worker_data.count < task_count) {
+			MinDepWorkerData wd = {};
+			array_init(&wd.found, heap_allocator());
+			array_add(&worker_data, wd);
+		}
+
+		ThreadPoolTaskGroup group = {};
+		for (isize i = 0; i < task_count; i++) {
+			MinDepWorkerData *wd = &worker_data[i];
+			isize offset = i*MIN_DEP_ENTITIES_PER_TASK;
+			wd->frontier       = frontier.data + offset;
+			wd->frontier_count = gb_min(frontier.count-offset, MIN_DEP_ENTITIES_PER_TASK);
+			wd->visited        = set;
+			array_clear(&wd->found);
+			if (task_count == 1) {
+				min_dep_worker_proc(wd);
+			} else {
+				thread_pool_add_task(&pool, min_dep_worker_proc, wd, &group);
 			}
-		} else if (e->kind == Entity_Variable && e->Variable.is_foreign) {
-			Entity *fl = e->Variable.foreign_library;
-			if (fl != nullptr) {
-				GB_ASSERT_MSG(fl->kind == Entity_LibraryName &&
-				              (fl->flags&EntityFlag_Used),
-				              "%.*s", LIT(entity->token.string));
-				add_dependency_to_set(c, fl);
+		}
+		thread_pool_wait_for(&pool, &group);
+
+		array_clear(&next_frontier);
+		for (isize i = 0; i < task_count; i++) {
+			MinDepWorkerData *wd = &worker_data[i];
+			for_array(j, wd->found) {
+				Entity *e = wd->found[j];
+				if (!id_set_update(set, e)) {
+					array_add(&next_frontier, e);
+				}
 			}
 		}
+		gb_swap(Array<Entity *>, frontier, next_frontier);
+	}
+
+	thread_pool_wait_to_process(&pool);
+
+	// NOTE: Adding type information may add new types, so it is done single threaded and in order
+	for_array(i, set->entries) {
+		Entity *entity = set->entries[i];
+		DeclInfo *decl = decl_info_of_entity(entity);
+		if (decl == nullptr) {
+			continue;
+		}
+		for_array(j, decl->type_info_deps.entries) {
+			Type *type = decl->type_info_deps.entries[j];
+			add_min_dep_type_info(c, type);
+		}
 	}
 }
 
@@ -1915,11 +2134,13 @@ void force_add_dependency_entity(Checker *c, Scope *scope, String const &name) {
 
 
 void generate_minimum_dependency_set(Checker *c, Entity *start) {
-	isize entity_count = c->info.entities.count;
-	isize min_dep_set_cap = next_pow2_isize(entity_count*4); // empirically determined factor
+	// NOTE: Enough bits for every entity created so far
+	isize entity_id_count = 1+global_entity_id.load(std::memory_order_relaxed);
 
-	ptr_set_init(&c->info.minimum_dependency_set, heap_allocator(), min_dep_set_cap);
+	id_set_init(&c->info.minimum_dependency_set, heap_allocator(), entity_id_count);
 	ptr_set_init(&c->info.minimum_dependency_type_info_set, heap_allocator());
+	array_init(&c->info.minimum_dependency_roots, heap_allocator());
+	defer (array_free(&c->info.minimum_dependency_roots));
 
 	String required_runtime_entities[] = {
 		// Odin types
@@ -2085,6 +2306,8 @@ void generate_minimum_dependency_set(Checker *c, Entity *start) {
 		start->flags |= EntityFlag_Used;
 		add_dependency_to_set(c, start);
 	}
+
+	walk_minimum_dependency_set(c);
 }
 
 bool is_entity_a_dependency(Entity *e) {
@@ -2149,7 +2372,7 @@ Array<EntityGraphNode *> generate_entity_dependency_graph(CheckerInfo *info, gbA
 		GB_ASSERT(decl != nullptr);
 
 		for_array(j, decl->deps.entries) {
-			Entity *dep = decl->deps.entries[j].ptr;
+			Entity *dep = decl->deps.entries[j];
 			if (dep->flags & EntityFlag_Field) {
 				continue;
 			}
@@ -3157,8 +3380,8 @@ void check_collect_value_decl(CheckerContext *c, Ast *decl) {
 				if (value != nullptr) {
 					if (value->kind == Ast_BasicLit && value->BasicLit.token.kind == Token_String) {
 						String v = {};
-						if (value->tav.value.kind == ExactValue_String) {
-							v = value->tav.value.value_string;
+						if (value->tav->value.kind == ExactValue_String) {
+							v = value->tav->value.value_string;
 						}
 						if (v == "file") {
 							kind = EntityVisiblity_PrivateToFile;
@@ -3507,20 +3730,147 @@ void check_single_global_entity(Checker *c, Entity *e, DeclInfo *d) {
 	check_entity_decl(ctx, e, d, nullptr);
 }
 
+void check_global_entity_in_order(Checker *c, Entity *e) {
+	if (e->flags & EntityFlag_Lazy) {
+		return;
+	}
+	DeclInfo *d = e->decl_info;
+	check_single_global_entity(c, e, d);
+	if (e->type != nullptr && is_type_typed(e->type)) {
+		(void)type_size_of(e->type);
+		(void)type_align_of(e->type);
+	}
+}
+
+// NOTE: Each package has its own queue of procedure bodies and its own diagnostics, which are merged
+// once its level has been checked, so that neither depends upon which thread checked which package
+struct CheckGlobalEntitiesWorkerData {
+	Checker *           checker;
+	AstPackage *        pkg;
+	Array<Entity *>     entities;
+	ProcBodyQueue       procs_to_check_queue;
+	ErrorDeferredBuffer diagnostics;
+};
+
+WORKER_TASK_PROC(check_global_entities_worker_proc) {
+	auto *wd = cast(CheckGlobalEntitiesWorkerData *)data;
+	TRACE_SCOPE(str_lit("Check Global Entities"), wd->pkg->name);
+
+	ProcBodyQueue *prev_queue = checker_global_entities_queue;
+	ErrorDeferredBuffer *prev_diagnostics = error_deferred_buffer;
+	checker_global_entities_queue = &wd->procs_to_check_queue;
+	error_deferred_buffer = &wd->diagnostics;
+
+	for_array(i, wd->entities) {
+		check_global_entity_in_order(wd->checker, wd->entities[i]);
+	}
+
+	checker_global_entities_queue = prev_queue;
+	error_deferred_buffer = prev_diagnostics;
+	return 0;
+}
+
+void check_all_global_entities_threaded(Checker *c) {
+	Map<isize> pkg_to_worker_data = {}; // Key: AstPackage *
+	map_init(&pkg_to_worker_data, heap_allocator());
+	defer (map_destroy(&pkg_to_worker_data));
+
+	isize worker_data_count = 0;
+	for_array(level, c->package_levels) {
+		worker_data_count += c->package_levels[level].count;
+	}
+	// NOTE: Not an `Array` as the queues cannot be copied
+	auto *worker_data = gb_alloc_array(heap_allocator(), CheckGlobalEntitiesWorkerData, worker_data_count);
+	gb_zero_size(worker_data, gb_size_of(CheckGlobalEntitiesWorkerData)*worker_data_count);
+	defer ({
+		for (isize i = 0; i < worker_data_count; i++) {
+			array_free(&worker_data[i].entities);
+			mpmc_destroy(&worker_data[i].procs_to_check_queue);
+			error_deferred_destroy(&worker_data[i].diagnostics);
+		}
+		gb_free(heap_allocator(), worker_data);
+	});
+
+	isize worker_data_index = 0;
+	for_array(level, c->package_levels) {
+		for_array(i, c->package_levels[level]) {
+			AstPackage *pkg = c->package_levels[level][i];
+			map_set(&pkg_to_worker_data, hash_pointer(pkg), worker_data_index);
+
+			CheckGlobalEntitiesWorkerData *wd = &worker_data[worker_data_index++];
+			wd->checker = c;
+			wd->pkg = pkg;
+			array_init(&wd->entities, heap_allocator());
+			mpmc_init(&wd->procs_to_check_queue, heap_allocator(), 256);
+			error_deferred_init(&wd->diagnostics);
+		}
+	}
+
+	// NOTE: Keep the order of the entities within each package, as the single threaded version does
+	// Lazy entities may be appended to `c->info.entities` whilst checking
+	isize entity_count = c->info.entities.count;
+	for (isize i = 0; i < entity_count; i++) {
+		Entity *e = c->info.entities[i];
+		isize *found = e->pkg ? map_get(&pkg_to_worker_data, hash_pointer(e->pkg)) : nullptr;
+		if (found == nullptr) {
+			// NOTE: The runtime package and the packages it imports are not within any level
+			check_global_entity_in_order(c, e);
+		} else {
+			array_add(&worker_data[*found].entities, e);
+		}
+	}
+
+	debugf("Checking the global entities of %td packages in %td levels\n", worker_data_count, c->package_levels.count);
+
+	isize thread_count = gb_max(build_context.thread_count, 1);
+	isize worker_count = thread_count-1; // NOTE(bill): The main thread will also be used for work
+	ThreadPool pool = {};
+	thread_pool_init(&pool, heap_allocator(), worker_count, "CheckerWork");
+	defer (thread_pool_destroy(&pool));
+	thread_pool_start(&pool);
+
+	auto level_diagnostics = array_make<ErrorDeferredBuffer *>(heap_allocator(), 0, worker_data_count);
+	defer (array_free(&level_diagnostics));
+
+	isize worker_index = 0;
+	for_array(level, c->package_levels) {
+		// NOTE: Every package within a level only depends upon packages in the previous levels,
+		// which have all been checked by now
+		isize level_start = worker_index;
+		ThreadPoolTaskGroup group = {};
+		global_entities_in_worker_queue = true;
+		for_array(i, c->package_levels[level]) {
+			thread_pool_add_task(&pool, check_global_entities_worker_proc, &worker_data[worker_index++], &group);
+		}
+		thread_pool_wait_for(&pool, &group);
+		global_entities_in_worker_queue = false;
+
+		array_clear(&level_diagnostics);
+		for (isize i = level_start; i < worker_index; i++) {
+			auto *wd = &worker_data[i];
+			ProcInfo *pi = nullptr;
+			while (mpmc_dequeue(&wd->procs_to_check_queue, &pi)) {
+				mpmc_enqueue(&c->procs_to_check_queue, pi);
+			}
+			array_add(&level_diagnostics, &wd->diagnostics);
+		}
+		error_deferred_flush(level_diagnostics.data, level_diagnostics.count);
+	}
+	GB_ASSERT(worker_index == worker_data_count);
+
+	thread_pool_wait_to_process(&pool);
+}
+
 void check_all_global_entities(Checker *c) {
+	if (build_context.threaded_global_checker && c->package_levels.count > 0) {
+		check_all_global_entities_threaded(c);
+		return;
+	}
+
 	// NOTE(bill): This must be single threaded
 	// Don't bother trying
 	for_array(i, c->info.entities) {
-		Entity *e = c->info.entities[i];
-		if (e->flags & EntityFlag_Lazy) {
-			continue;
-		}
-		DeclInfo *d = e->decl_info;
-		check_single_global_entity(c, e, d);
-		if (e->type != nullptr && is_type_typed(e->type)) {
-			(void)type_size_of(e->type);
-			(void)type_align_of(e->type);
-		}
+		check_global_entity_in_order(c, c->info.entities[i]);
 	}
 }
 
@@ -4257,6 +4607,70 @@ void check_export_entities(Checker *c) {
 	check_with_workers(c, thread_proc_check_export_entities, c->info.packages.entries.count);
 }
 
+void calculate_package_levels(Checker *c, Array<ImportGraphNode *> const &package_order) {
+	// NOTE: `package_order` is sorted such that every package comes after the packages it imports
+	Map<isize> levels = {}; // Key: ImportGraphNode *
+	map_init(&levels, heap_allocator(), 2*package_order.count);
+	defer (map_destroy(&levels));
+
+	// NOTE: Every package may refer to the runtime package implicitly (e.g. through `find_core_type`),
+	// and the runtime package may import packages which import it, so the runtime package and everything
+	// it imports are left out of the levels and are checked single threaded before any other package
+	PtrSet<ImportGraphNode *> runtime_deps = {};
+	ptr_set_init(&runtime_deps, heap_allocator());
+	defer (ptr_set_destroy(&runtime_deps));
+
+	Array<ImportGraphNode *> stack = {};
+	array_init(&stack, heap_allocator());
+	defer (array_free(&stack));
+	for_array(i, package_order) {
+		if (package_order[i]->pkg->kind == Package_Runtime) {
+			array_add(&stack, package_order[i]);
+		}
+	}
+	while (stack.count > 0) {
+		ImportGraphNode *n = array_pop(&stack);
+		if (ptr_set_update(&runtime_deps, n)) {
+			continue;
+		}
+		for_array(i, n->succ.entries) {
+			array_add(&stack, n->succ.entries[i].ptr);
+		}
+	}
+
+	for_array(i, package_order) {
+		ImportGraphNode *n = package_order[i];
+		if (ptr_set_exists(&runtime_deps, n)) {
+			continue;
+		}
+		isize level = 0;
+		for_array(j, n->succ.entries) {
+			ImportGraphNode *dep = n->succ.entries[j].ptr;
+			if (ptr_set_exists(&runtime_deps, dep)) {
+				continue;
+			}
+			isize *dep_level = map_get(&levels, hash_pointer(dep));
+			if (dep_level == nullptr) {
+				// NOTE: Cyclic importation, which has already been reported as an error
+				for_array(k, c->package_levels) {
+					array_free(&c->package_levels[k]);
+				}
+				array_clear(&c->package_levels);
+				return;
+			}
+			level = gb_max(level, *dep_level+1);
+		}
+		map_set(&levels, hash_pointer(n), level);
+
+		while (c->package_levels.count <= level) {
+			Array<AstPackage *> pkgs = {};
+			array_init(&pkgs, heap_allocator());
+			array_add(&c->package_levels, pkgs);
+		}
+		array_add(&c->package_levels[level], n->pkg);
+	}
+}
+
 void check_import_entities(Checker *c) {
 #define TIME_SECTION(str) do { debugf("[Section] %s\n", str); if (build_context.show_more_timings) timings_start_section(&global_timings, str_lit(str)); } while (0)
 
@@ -4323,6 +4737,11 @@ void check_import_entities(Checker *c) {
 		array_add(&package_order, n);
 	}
 
+	if (build_context.threaded_global_checker) {
+		TIME_SECTION("check_import_entities - calculate package levels");
+		calculate_package_levels(c, package_order);
+	}
+
 	TIME_SECTION("check_import_entities - collect file decls");
 	CheckerContext ctx = make_checker_context(c);
 
@@ -4410,7 +4829,7 @@ bool find_entity_path_tuple(Type *tuple, Entity *end, Map<Entity *> *visited, Ar
 			continue;
 		}
 		for_array(i, var_decl->deps.entries) {
-			Entity *dep = var_decl->deps.entries[i].ptr;
+			Entity *dep = var_decl->deps.entries[i];
 			if (dep == end) {
 				auto path = array_make<Entity *>(heap_allocator());
 				array_add(&path, dep);
@@ -4465,7 +4884,7 @@ Array<Entity *> find_entity_path(Entity *start, Entity *end, Map<Entity *> *visi
 			}
 		} else {
 			for_array(i, decl->deps.entries) {
-				Entity *dep = decl->deps.entries[i].ptr;
+				Entity *dep = decl->deps.entries[i];
 				if (dep == end) {
 					auto path = array_make<Entity *>(heap_allocator());
 					array_add(&path, dep);
@@ -4612,7 +5031,13 @@ void check_proc_info(Checker *c, ProcInfo *pi, UntypedExprInfoMap *untyped, Proc
 		GB_ASSERT((pi->decl->entity->flags & EntityFlag_ProcBodyChecked) == 0);
 	}
 
-	check_proc_body(&ctx, pi->token, pi->decl, pi->type, pi->body);
+	{
+		TRACE_SCOPE(str_lit("Check Procedure Body"), name);
+		DeclInfo *prev_proc_body_decl = checker_proc_body_decl;
+		checker_proc_body_decl = pi->decl;
+		check_proc_body(&ctx, pi->token, pi->decl, pi->type, pi->body);
+		checker_proc_body_decl = prev_proc_body_decl;
+	}
 	if (pi->body != nullptr && pi->decl->entity != nullptr) {
 		pi->decl->entity->flags |= EntityFlag_ProcBodyChecked;
 	}
@@ -4622,6 +5047,8 @@ void check_proc_info(Checker *c, ProcInfo *pi, UntypedExprInfoMap *untyped, Proc
 
 GB_STATIC_ASSERT(sizeof(isize) == sizeof(void *));
 
+bool consume_proc_info_queue(Checker *c, ProcInfo *pi, ProcBodyQueue *q, UntypedExprInfoMap *untyped);
+
 void check_unchecked_bodies(Checker *c) {
 	// NOTE(2021-02-26, bill): Sanity checker
 	// This is a partial hack to make sure all procedure bodies have been checked
@@ -4632,8 +5059,13 @@ void check_unchecked_bodies(Checker *c) {
 	map_init(&untyped, heap_allocator());
 	defer (map_destroy(&untyped));
 
+	// NOTE: Any procedures required by these bodies (e.g. polymorphic instantiations) must be checked too
+	ProcBodyQueue q = {};
+	mpmc_init(&q, heap_allocator(), 1<<8);
+	defer (mpmc_destroy(&q));
+
 	for_array(i, c->info.minimum_dependency_set.entries) {
-		Entity *e = c->info.minimum_dependency_set.entries[i].ptr;
+		Entity *e = c->info.minimum_dependency_set.entries[i];
 		if (e == nullptr || e->kind != Entity_Procedure) {
 			continue;
 		}
@@ -4658,7 +5090,11 @@ void check_unchecked_bodies(Checker *c) {
 			}
 
 			map_clear(&untyped);
-			check_proc_info(c, &pi, &untyped, nullptr);
+			check_proc_info(c, &pi, &untyped, &q);
+
+			for (ProcInfo *pi; mpmc_dequeue(&q, &pi); /**/) {
+				consume_proc_info_queue(c, pi, &q, &untyped);
+			}
 		}
 	}
 }
@@ -4677,7 +5113,7 @@ void check_test_procedures(Checker *c) {
 		if (e == nullptr) {
 			Token tok = {};
 			if (pkg->files.count != 0) {
-				tok = pkg->files[0]->tokens[0];
+				tok = ast_file_token(pkg->files[0], 0);
 			}
 			error(tok, "Unable to find the test '%.*s' in 'package %.*s' ", LIT(name), LIT(pkg->name));
 		}
@@ -4710,6 +5146,12 @@ bool consume_proc_info_queue(Checker *c, ProcInfo *pi, ProcBodyQueue *q, Untyped
 			return true;
 		}
 	}
+	if (pi->poly_instantiated_in != nullptr && !pi->poly_instantiated_in->proc_checked) {
+		// NOTE: A polymorphic instantiation is only marked as used after it has been generated,
+		// so it must wait for the body which required it when another thread steals it
+		mpmc_enqueue(q, pi);
+		return true;
+	}
 	if (untyped) {
 		map_clear(untyped);
 	}
@@ -4724,22 +5166,97 @@ struct ThreadProcBodyData {
 	u32 thread_index;
 	u32 thread_count;
 	ThreadProcBodyData *all_data;
+
+	// NOTE: Utilization counters, shown with -show-debug-messages
+	isize bodies_checked;
+	isize bodies_stolen;
+	u64   busy_time;
+	u64   idle_time;
 };
 
+// NOTE: The number of threads which are currently checking a procedure body
+// Only these threads can add more procedures to the queues
+gb_global std::atomic<isize> proc_body_busy_thread_count;
+
+bool proc_body_queues_have_work(ThreadProcBodyData *data) {
+	for (u32 i = 0; i < data->thread_count; i++) {
+		if (data->all_data[i].queue->count.load(std::memory_order_acquire) > 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool proc_body_steal(ThreadProcBodyData *data, ProcInfo **pi_) {
+	for (u32 i = 1; i < data->thread_count; i++) {
+		ProcBodyQueue *victim = data->all_data[(data->thread_index+i)%data->thread_count].queue;
+		if (victim->count.load(std::memory_order_relaxed) <= 0) {
+			continue;
+		}
+		// NOTE: Only the owner enqueues, but that may resize the queue, which is done under its mutex
+		mutex_lock(&victim->mutex);
+		bool ok = mpmc_dequeue(victim, pi_);
+		mutex_unlock(&victim->mutex);
+		if (ok) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// NOTE: Returns false once every queue is empty and no other thread is busy
+bool proc_body_wait_for_work(ThreadProcBodyData *data) {
+	u64 idle_start = time_stamp_time_now();
+	defer (data->idle_time += time_stamp_time_now() - idle_start);
+
+	proc_body_busy_thread_count.fetch_sub(1, std::memory_order_acq_rel);
+	for (;;) {
+		// NOTE: Load the busy count before the queues, as a busy thread enqueues before it becomes idle
+		isize busy_count = proc_body_busy_thread_count.load(std::memory_order_acquire);
+		if (proc_body_queues_have_work(data)) {
+			proc_body_busy_thread_count.fetch_add(1, std::memory_order_acq_rel);
+			return true;
+		}
+		if (busy_count == 0) {
+			return false;
+		}
+		gb_yield();
+	}
+}
+
 GB_THREAD_PROC(thread_proc_body) {
 	ThreadProcBodyData *data = cast(ThreadProcBodyData *)thread->user_data;
 	Checker *c = data->checker;
 	GB_ASSERT(c != nullptr);
-	ThreadProcBodyData *all_data = data->all_data;
 	ProcBodyQueue *this_queue = data->queue;
 
 	UntypedExprInfoMap untyped = {};
 	map_init(&untyped, heap_allocator());
 
-	for (ProcInfo *pi; mpmc_dequeue(this_queue, &pi); /**/) {
-		consume_proc_info_queue(c, pi, this_queue, &untyped);
+	u64 start = time_stamp_time_now();
+
+	for (;;) {
+		ProcInfo *pi = nullptr;
+		if (mpmc_dequeue(this_queue, &pi)) {
+			// Own work first
+		} else if (proc_body_steal(data, &pi)) {
+			// NOTE: Procedures differ in size by orders of magnitude, so a static split
+			// of the queue leaves threads idle while others are still busy
+			data->bodies_stolen += 1;
+		} else if (proc_body_wait_for_work(data)) {
+			continue;
+		} else {
+			break;
+		}
+
+		// NOTE: Any nested procedures are added to this thread's queue, where other threads can steal them
+		if (!consume_proc_info_queue(c, pi, this_queue, &untyped)) {
+			data->bodies_checked += 1;
+		}
 	}
 
+	data->busy_time = (time_stamp_time_now() - start) - data->idle_time;
+
 	map_destroy(&untyped);
 
 	gb_semaphore_release(&c->procs_to_check_semaphore);
@@ -4802,6 +5319,7 @@ void check_procedure_bodies(Checker *c) {
 	GB_ASSERT(total_queued == original_queue_count);
 
 
+	proc_body_busy_thread_count.store(thread_count);
 	gb_semaphore_post(&c->procs_to_check_semaphore, cast(i32)thread_count);
 
 	gbThread *threads = gb_alloc_array(permanent_allocator(), gbThread, worker_count);
@@ -4824,8 +5342,22 @@ void check_procedure_bodies(Checker *c) {
 
 	isize global_remaining = c->procs_to_check_queue.count.load(std::memory_order_relaxed);
 	GB_ASSERT(global_remaining == 0);
+	for (u32 i = 0; i < thread_count; i++) {
+		GB_ASSERT(thread_data[i].queue->count.load(std::memory_order_relaxed) == 0);
+	}
 
 	debugf("Total Procedure Bodies Checked: %td\n", total_bodies_checked.load(std::memory_order_relaxed));
+	if (build_context.show_debug_messages) {
+		f64 freq = cast(f64)time_stamp__freq();
+		for (u32 i = 0; i < thread_count; i++) {
+			ThreadProcBodyData *data = thread_data + i;
+			f64 busy = 1000.0*cast(f64)data->busy_time/freq;
+			f64 idle = 1000.0*cast(f64)data->idle_time/freq;
+			f64 utilization = busy+idle > 0 ? 100.0*busy/(busy+idle) : 100.0;
+			debugf("Checker Thread %u: %td bodies (%td stolen), busy %.3f ms, idle %.3f ms, %.2f%% utilization\n",
+			       i, data->bodies_checked, data->bodies_stolen, busy, idle, utilization);
+		}
+	}
 
 	global_procedure_body_in_worker_queue = false;
 }
@@ -5147,7 +5679,7 @@ void check_parsed_files(Checker *c) {
 			ast_node(pl, ProcLit, decl->proc_lit);
 			if (pl->inlining == ProcInlining_inline) {
 				for_array(j, decl->deps.entries) {
-					Entity *dep = decl->deps.entries[j].ptr;
+					Entity *dep = decl->deps.entries[j];
 					if (dep == e) {
 						error(e->token, "Cannot inline recursive procedure '%.*s'", LIT(e->token.string));
 						break;
@@ -5174,7 +5706,7 @@ void check_parsed_files(Checker *c) {
 		Entity *e = c->info.definitions[i];
 		if (e->kind == Entity_TypeName && e->type != nullptr) {
 			i64 align = type_align_of(e->type);
-			if (align > 0 && ptr_set_exists(&c->info.minimum_dependency_set, e)) {
+			if (align > 0 && id_set_exists(&c->info.minimum_dependency_set, e)) {
 				add_type_info_type(&c->builtin_ctx, e->type);
 			}
 		}
@@ -5196,7 +5728,7 @@ void check_parsed_files(Checker *c) {
 			if (s->pkg->files.count > 0) {
 				AstFile *f = s->pkg->files[0];
 				if (f->tokens.count > 0) {
-					token = f->tokens[0];
+					token = ast_file_token(f, 0);
 				}
 			}
 
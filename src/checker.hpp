@@ -150,9 +150,9 @@ struct DeclInfo {
 	CommentGroup *comment;
 	CommentGroup *docs;
 
-	PtrSet<Entity *>  deps;
-	PtrSet<Type *>    type_info_deps;
-	Array<BlockLabel> labels;
+	SmallIdSet<Entity *> deps;
+	SmallIdSet<Type *>   type_info_deps;
+	Array<BlockLabel>    labels;
 };
 
 // ProcInfo stores the information needed for checking a procedure
@@ -165,6 +165,7 @@ struct ProcInfo {
 	u64       tags;
 	bool      generated_from_polymorphic;
 	Ast *     poly_def_node;
+	DeclInfo *poly_instantiated_in; // NOTE: The procedure body being checked when this was instantiated, if any
 };
 
 
@@ -264,6 +265,39 @@ struct UntypedExprInfo {
 typedef Map<ExprInfo *> UntypedExprInfoMap; // Key: Ast *
 typedef MPMCQueue<ProcInfo *> ProcBodyQueue;
 
+// NOTE: The key also hashes the base identifier, but different bases may share a key
+struct GenProcInstance {
+	Ast *   base_identifier;
+	Entity *entity;
+};
+
+enum : isize {
+	TYPE_INFO_SHARD_COUNT = 64,
+};
+
+struct TypeInfoUnique {
+	Type *type;
+	isize index; // NOTE: Index into `type_info_types`
+};
+
+// NOTE: Identical types have the same structural hash (see `type_hash`) and so are always in the same
+// shard, and only the unique types with the same hash need to be compared when a type is first seen
+struct TypeInfoShard {
+	BlockingMutex       mutex;
+	Map<isize>          map;            // Key: Type *
+	Map<TypeInfoUnique> structural_map; // Key: type_hash (multi map)
+};
+
+// NOTE: Every '#load' of the same file shares this, and the contents are memory mapped where possible.
+// They must stay alive until the backend has finished, as the constant value of '#load' refers to them
+struct LoadFileCache {
+	String          path;
+	LoadedFileError error;
+	LoadedFile      file;
+	String          data;
+	u64             hash; // NOTE: Only used by -incremental
+};
+
 // CheckerInfo stores all the symbol information for a type-checked program
 struct CheckerInfo {
 	Checker *checker;
@@ -277,8 +311,9 @@ struct CheckerInfo {
 	AstPackage *          init_package;
 	Scope *               init_scope;
 	Entity *              entry_point;
-	PtrSet<Entity *>      minimum_dependency_set;
+	IdSet<Entity *>       minimum_dependency_set;
 	PtrSet<isize>         minimum_dependency_type_info_set;
+	Array<Entity *>       minimum_dependency_roots; // NOTE: Only used whilst generating the minimum dependency set
 
 
 
@@ -310,15 +345,23 @@ struct CheckerInfo {
 	RecursiveMutex gen_procs_mutex;
 	RecursiveMutex gen_types_mutex;
 	Map<Array<Entity *> > gen_procs; // Key: Ast * | Identifier -> Entity
+	Map<GenProcInstance>  gen_proc_instances; // Key: Ast * | Identifier + type_hash(proc type) (multi map)
 	Map<Array<Entity *> > gen_types; // Key: Type *
 
-	BlockingMutex type_info_mutex; // NOT recursive
+	BlockingMutex type_info_mutex; // NOT recursive & Only guards `type_info_types`
 	Array<Type *> type_info_types;
-	Map<isize>    type_info_map;   // Key: Type *
+	TypeInfoShard type_info_shards[TYPE_INFO_SHARD_COUNT];
 
 	BlockingMutex foreign_mutex; // NOT recursive
 	StringMap<Entity *> foreigns;
 
+	// NOTE: An order independent hash of every file loaded with '#load', used by -incremental
+	std::atomic<u64> load_files_hash;
+
+	BlockingMutex              load_file_mutex; // NOT recursive
+	StringMap<LoadFileCache *> load_file_cache; // Key: full path
+	Map<LoadFileCache *>       load_file_data;  // Key: LoadFileCache.data.text
+
 	// only used by 'odin query'
 	bool          allow_identifier_uses;
 	BlockingMutex identifier_uses_mutex;
@@ -390,6 +433,10 @@ struct Checker {
 
 	// TODO(bill): Technically MPSC queue
 	MPMCQueue<UntypedExprInfo> global_untyped_queue;
+
+	// NOTE: Packages grouped by their depth in the import graph, only used by -threaded-global-checker
+	// The packages within a level do not depend upon each other
+	Array<Array<AstPackage *> > package_levels;
 };
 
 
@@ -422,8 +469,11 @@ Entity *entity_of_node(Ast *expr);
 
 
 Entity *scope_lookup_current(Scope *s, String const &name);
+Entity *scope_lookup_current(Scope *s, StringHashKey const &key);
 Entity *scope_lookup (Scope *s, String const &name);
+Entity *scope_lookup (Scope *s, StringHashKey const &key);
 void    scope_lookup_parent (Scope *s, String const &name, Scope **scope_, Entity **entity_);
+void    scope_lookup_parent (Scope *s, StringHashKey const &key, Scope **scope_, Entity **entity_);
 Entity *scope_insert (Scope *s, Entity *entity);
 
 
@@ -446,15 +446,15 @@ typedef struct Arena {
 	isize       block_size;
 	gbMutex     mutex;
 	isize total_used;
+	isize total_reserved;
 	bool   use_mutex;
 } Arena;
 
 #define ARENA_MIN_ALIGNMENT 16
 #define ARENA_DEFAULT_BLOCK_SIZE (8*1024*1024)
+#define ARENA_THREAD_BLOCK_SIZE  (2*1024*1024)
 
 
-gb_global Arena permanent_arena = {};
-
 void arena_init(Arena *arena, gbAllocator backing, isize block_size=ARENA_DEFAULT_BLOCK_SIZE) {
 	arena->backing = backing;
 	arena->block_size = block_size;
@@ -475,6 +475,7 @@ void arena_grow(Arena *arena, isize min_size) {
 	// zero_size(arena->ptr, size); // NOTE(bill): This should already be zeroed
 	GB_ASSERT(arena->ptr == ALIGN_DOWN_PTR(arena->ptr, ARENA_MIN_ALIGNMENT));
 	arena->end = arena->ptr + size;
+	arena->total_reserved += size;
 	array_add(&arena->blocks, arena->ptr);
 
 	if (arena->use_mutex) {
@@ -568,8 +569,51 @@ GB_ALLOCATOR_PROC(arena_allocator_proc) {
 }
 
 
+// NOTE: Each thread has its own permanent arena which is never freed, so a permanent
+// allocation requires no locks nor atomics. The blocks of each arena are taken from the shared
+// heap, and the shared list of arenas is only locked when a thread creates its arena
+struct PermanentArenas {
+	gbMutex        mutex;
+	Array<Arena *> arenas;
+};
+
+gb_global PermanentArenas permanent_arenas = {};
+thread_local Arena *permanent_thread_arena = nullptr;
+
+Arena *get_permanent_thread_arena(void) {
+	Arena *arena = permanent_thread_arena;
+	if (arena == nullptr) {
+		arena = gb_alloc_item(heap_allocator(), Arena);
+		// NOTE: Smaller blocks as there is an arena per thread and blocks are zeroed on allocation
+		arena_init(arena, heap_allocator(), ARENA_THREAD_BLOCK_SIZE);
+		arena->use_mutex = false;
+
+		gb_mutex_lock(&permanent_arenas.mutex);
+		array_add(&permanent_arenas.arenas, arena);
+		gb_mutex_unlock(&permanent_arenas.mutex);
+
+		permanent_thread_arena = arena;
+	}
+	return arena;
+}
+
+void init_permanent_arenas(void) {
+	gb_mutex_init(&permanent_arenas.mutex);
+	array_init(&permanent_arenas.arenas, heap_allocator());
+	get_permanent_thread_arena();
+}
+
+GB_ALLOCATOR_PROC(permanent_allocator_proc) {
+	// NOTE: Allocators are stored (e.g. within an Array) and may be used on a different thread
+	// to the one which created them, so always use the arena of the calling thread
+	return arena_allocator_proc(get_permanent_thread_arena(), type, size, alignment, old_memory, old_size, flags);
+}
+
 gbAllocator permanent_allocator() {
-	return arena_allocator(&permanent_arena);
+	gbAllocator a;
+	a.proc = permanent_allocator_proc;
+	a.data = nullptr;
+	return a;
 	// return heap_allocator();
 }
 
@@ -670,50 +714,92 @@ gbAllocator temporary_allocator() {
 
 
 
+#include "hash_index.cpp"
 #include "string_map.cpp"
 #include "map.cpp"
 #include "ptr_set.cpp"
+#include "id_set.cpp"
 #include "string_set.cpp"
 #include "priority_queue.cpp"
 #include "thread_pool.cpp"
 
 
+// NOTE: Strings with the same contents are interned to the same `StringIntern`, which also stores the hash
+// of the string, so that it does not need to be calculated again. Identifiers are interned by the tokenizer
+// on many threads at once, so the interner is split into shards by the hash, each with its own mutex
 struct StringIntern {
 	StringIntern *next;
+	u64   hash; // NOTE: The same as `gb_fnv64a` of the string
 	isize len;
-	char str[1];
+	char  str[1];
 };
 
-Map<StringIntern *> string_intern_map = {}; // Key: u64
+enum : isize {
+	STRING_INTERN_SHARD_COUNT = 64,
+};
+
+struct StringInternShard {
+	BlockingMutex       mutex;
+	Map<StringIntern *> map; // Key: u64
+};
+
+gb_global StringInternShard string_intern_shards[STRING_INTERN_SHARD_COUNT];
 Arena string_intern_arena = {};
 
-char const *string_intern(char const *text, isize len) {
-	u64 hash = gb_fnv64a(text, len);
+StringIntern *string_intern_entry(char const *text, isize len, u64 hash) {
 	u64 key = hash ? hash : 1;
-	StringIntern **found = map_get(&string_intern_map, hash_integer(key));
+	StringInternShard *shard = &string_intern_shards[hash % STRING_INTERN_SHARD_COUNT];
+	mutex_lock(&shard->mutex);
+	defer (mutex_unlock(&shard->mutex));
+
+	StringIntern **found = map_get(&shard->map, hash_integer(key));
 	if (found) {
 		for (StringIntern *it = *found; it != nullptr; it = it->next) {
 			if (it->len == len && gb_strncmp(it->str, (char *)text, len) == 0) {
-				return it->str;
+				return it;
 			}
 		}
 	}
 
 	StringIntern *new_intern = cast(StringIntern *)arena_alloc(&string_intern_arena, gb_offset_of(StringIntern, str) + len + 1, gb_align_of(StringIntern));
+	new_intern->hash = hash;
 	new_intern->len = len;
 	new_intern->next = found ? *found : nullptr;
 	gb_memmove(new_intern->str, text, len);
 	new_intern->str[len] = 0;
-	map_set(&string_intern_map, hash_integer(key), new_intern);
-	return new_intern->str;
+	map_set(&shard->map, hash_integer(key), new_intern);
+	return new_intern;
+}
+
+gb_inline StringIntern *string_intern_entry(String const &string) {
+	return string_intern_entry(cast(char const *)string.text, string.len, gb_fnv64a(string.text, string.len));
+}
+
+char const *string_intern(char const *text, isize len) {
+	return string_intern_entry(text, len, gb_fnv64a(text, len))->str;
 }
 
 char const *string_intern(String const &string) {
 	return string_intern(cast(char const *)string.text, string.len);
 }
 
+gb_inline String string_intern_string(StringIntern const *intern) {
+	return make_string(cast(u8 const *)intern->str, intern->len);
+}
+
+// NOTE: Keys made from the same `StringIntern` share the same text, see `string_hash_key_equal`
+gb_inline StringHashKey string_intern_hash_key(StringIntern const *intern) {
+	StringHashKey key = {};
+	key.hash = intern->hash;
+	key.string = string_intern_string(intern);
+	return key;
+}
+
 void init_string_interner(void) {
-	map_init(&string_intern_map, heap_allocator());
+	for (isize i = 0; i < STRING_INTERN_SHARD_COUNT; i++) {
+		mutex_init(&string_intern_shards[i].mutex);
+		map_init(&string_intern_shards[i].map, heap_allocator());
+	}
 	arena_init(&string_intern_arena, heap_allocator());
 }
 
@@ -1278,6 +1364,279 @@ ReadDirectoryError read_directory(String path, Array<FileInfo> *fi) {
 #endif
 
 
+enum LoadedFileError {
+	LoadedFile_None,
+
+	LoadedFile_Empty,
+	LoadedFile_FileTooLarge,
+	LoadedFile_Invalid,
+	LoadedFile_NotExists,
+	LoadedFile_Permission,
+
+	LoadedFile_COUNT,
+};
+
+struct LoadedFile {
+	void *      handle; // NOTE: Non-null when the contents are memory mapped
+	void const *data;
+	isize       size;
+	u64         file_id;         // NOTE: e.g. the inode, 0 if unknown
+	u64         last_write_time; // NOTE: Microseconds since 1601-01-01 UTC, the same as `gb_utc_time_now`
+};
+
+// NOTE: A file can be written again within the resolution of its last write time without that changing,
+// so a file written this recently is never treated as unchanged, see `loaded_file_is_unchanged`
+enum : u64 {LOADED_FILE_MIN_AGE = 2000000}; // microseconds
+
+bool loaded_file_is_unchanged(char const *fullpath, LoadedFile const *file);
+
+#if defined(GB_SYSTEM_LINUX) || defined(GB_SYSTEM_OSX) || defined(GB_SYSTEM_FREEBSD)
+void loaded_file__set_stat(LoadedFile *file, struct stat const *file_stat) {
+#if defined(GB_SYSTEM_OSX)
+	struct timespec mtime = file_stat->st_mtimespec;
+#else
+	struct timespec mtime = file_stat->st_mtim;
+#endif
+	file->file_id = cast(u64)file_stat->st_ino;
+	file->last_write_time = cast(u64)mtime.tv_sec * 1000000ull + cast(u64)mtime.tv_nsec/1000 + 11644473600000000ull;
+}
+
+LoadedFileError load_file_by_reading(int fd, isize size_hint, LoadedFile *file) {
+	gbAllocator a = heap_allocator();
+
+	isize cap = gb_max(size_hint, 4096);
+	isize len = 0;
+	u8 *buf = cast(u8 *)gb_alloc(a, cap);
+
+	for (;;) {
+		if (len == cap) {
+			buf = cast(u8 *)gb_resize(a, buf, cap, cap*2);
+			cap *= 2;
+		}
+		ssize_t n = read(fd, buf+len, cap-len);
+		if (n < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			gb_free(a, buf);
+			return LoadedFile_Invalid;
+		}
+		if (n == 0) {
+			break;
+		}
+		len += n;
+		if (len > I32_MAX) {
+			gb_free(a, buf);
+			return LoadedFile_FileTooLarge;
+		}
+	}
+
+	if (len == 0) {
+		gb_free(a, buf);
+		return LoadedFile_Empty;
+	}
+
+	file->handle = nullptr;
+	file->data = buf;
+	file->size = len;
+	return LoadedFile_None;
+}
+
+// NOTE: The contents are memory mapped where possible and must stay alive until unload_file
+LoadedFileError load_file(char const *fullpath, LoadedFile *file) {
+	zero_item(file);
+
+	int fd = open(fullpath, O_RDONLY);
+	if (fd < 0) {
+		switch (errno) {
+		case ENOENT: return LoadedFile_NotExists;
+		case EACCES: return LoadedFile_Permission;
+		}
+		return LoadedFile_Invalid;
+	}
+	defer (close(fd));
+
+	struct stat file_stat = {};
+	if (fstat(fd, &file_stat) != 0 || S_ISDIR(file_stat.st_mode)) {
+		return LoadedFile_Invalid;
+	}
+	if (S_ISREG(file_stat.st_mode) && file_stat.st_size > 0) {
+		if (file_stat.st_size > I32_MAX) {
+			return LoadedFile_FileTooLarge;
+		}
+		isize size = cast(isize)file_stat.st_size;
+		void *ptr = mmap(nullptr, cast(size_t)size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (ptr != MAP_FAILED) {
+			file->handle = ptr;
+			file->data = ptr;
+			file->size = size;
+			loaded_file__set_stat(file, &file_stat);
+			return LoadedFile_None;
+		}
+	}
+
+	// NOTE: Pipes and files which report a size of zero (e.g. procfs) have to be read
+	LoadedFileError err = load_file_by_reading(fd, cast(isize)file_stat.st_size, file);
+	if (err == LoadedFile_None && S_ISREG(file_stat.st_mode)) {
+		loaded_file__set_stat(file, &file_stat);
+	}
+	return err;
+}
+
+bool loaded_file_is_unchanged(char const *fullpath, LoadedFile const *file) {
+	struct stat file_stat = {};
+	if (file->last_write_time == 0 || stat(fullpath, &file_stat) != 0 || !S_ISREG(file_stat.st_mode)) {
+		return false;
+	}
+	LoadedFile current = {};
+	loaded_file__set_stat(&current, &file_stat);
+	return cast(isize)file_stat.st_size == file->size &&
+	       current.file_id == file->file_id &&
+	       current.last_write_time == file->last_write_time &&
+	       gb_utc_time_now() >= file->last_write_time + LOADED_FILE_MIN_AGE;
+}
+
+void unload_file(LoadedFile *file) {
+	if (file->handle != nullptr) {
+		munmap(file->handle, cast(size_t)file->size);
+	} else if (file->data != nullptr) {
+		gb_free(heap_allocator(), cast(void *)file->data);
+	}
+	zero_item(file);
+}
+#elif defined(GB_SYSTEM_WINDOWS)
+void loaded_file__set_info(LoadedFile *file, BY_HANDLE_FILE_INFORMATION const *info) {
+	FILETIME t = info->ftLastWriteTime;
+	file->file_id = (cast(u64)info->nFileIndexHigh << 32) | cast(u64)info->nFileIndexLow;
+	// NOTE: A FILETIME counts 100 nanosecond intervals since 1601-01-01 UTC
+	file->last_write_time = ((cast(u64)t.dwHighDateTime << 32) | cast(u64)t.dwLowDateTime)/10;
+}
+
+// NOTE: The contents are memory mapped where possible and must stay alive until unload_file
+LoadedFileError load_file(char const *fullpath, LoadedFile *file) {
+	zero_item(file);
+
+	gbFile f = {};
+	gbFileError file_err = gb_file_open(&f, fullpath);
+	defer (gb_file_close(&f));
+
+	switch (file_err) {
+	case gbFileError_None:       break;
+	case gbFileError_NotExists:  return LoadedFile_NotExists;
+	case gbFileError_Permission: return LoadedFile_Permission;
+	default:                     return LoadedFile_Invalid;
+	}
+
+	HANDLE handle = cast(HANDLE)f.fd.p;
+	BY_HANDLE_FILE_INFORMATION info = {};
+	if (!GetFileInformationByHandle(handle, &info) || (info.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0) {
+		return LoadedFile_Invalid;
+	}
+	u64 size = (cast(u64)info.nFileSizeHigh << 32) | cast(u64)info.nFileSizeLow;
+	if (size == 0) {
+		return LoadedFile_Empty;
+	} else if (size > I32_MAX) {
+		return LoadedFile_FileTooLarge;
+	}
+
+	file->size = cast(isize)size;
+	loaded_file__set_info(file, &info);
+
+	HANDLE mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping != nullptr) {
+		void *ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping); // NOTE: The view keeps the mapping alive
+		if (ptr != nullptr) {
+			file->handle = ptr;
+			file->data = ptr;
+			return LoadedFile_None;
+		}
+	}
+
+	void *data = gb_alloc(heap_allocator(), file->size);
+	if (!gb_file_read_at(&f, data, file->size, 0)) {
+		gb_free(heap_allocator(), data);
+		zero_item(file);
+		return LoadedFile_Invalid;
+	}
+	file->data = data;
+	return LoadedFile_None;
+}
+
+bool loaded_file_is_unchanged(char const *fullpath, LoadedFile const *file) {
+	if (file->last_write_time == 0) {
+		return false;
+	}
+	gbFile f = {};
+	if (gb_file_open(&f, fullpath) != gbFileError_None) {
+		return false;
+	}
+	defer (gb_file_close(&f));
+	BY_HANDLE_FILE_INFORMATION info = {};
+	if (!GetFileInformationByHandle(cast(HANDLE)f.fd.p, &info)) {
+		return false;
+	}
+	LoadedFile current = {};
+	loaded_file__set_info(&current, &info);
+	u64 size = (cast(u64)info.nFileSizeHigh << 32) | cast(u64)info.nFileSizeLow;
+	return size == cast(u64)file->size &&
+	       current.file_id == file->file_id &&
+	       current.last_write_time == file->last_write_time &&
+	       gb_utc_time_now() >= file->last_write_time + LOADED_FILE_MIN_AGE;
+}
+
+void unload_file(LoadedFile *file) {
+	if (file->handle != nullptr) {
+		UnmapViewOfFile(file->handle);
+	} else if (file->data != nullptr) {
+		gb_free(heap_allocator(), cast(void *)file->data);
+	}
+	zero_item(file);
+}
+#else
+LoadedFileError load_file(char const *fullpath, LoadedFile *file) {
+	zero_item(file);
+
+	gbFile f = {};
+	gbFileError file_err = gb_file_open(&f, fullpath);
+	defer (gb_file_close(&f));
+
+	switch (file_err) {
+	case gbFileError_None:       break;
+	case gbFileError_NotExists:  return LoadedFile_NotExists;
+	case gbFileError_Permission: return LoadedFile_Permission;
+	default:                     return LoadedFile_Invalid;
+	}
+
+	i64 size = gb_file_size(&f);
+	if (size <= 0) {
+		return LoadedFile_Empty;
+	} else if (size > I32_MAX) {
+		return LoadedFile_FileTooLarge;
+	}
+
+	void *data = gb_alloc(heap_allocator(), cast(isize)size);
+	gb_file_read_at(&f, data, cast(isize)size, 0);
+
+	file->handle = nullptr;
+	file->data = data;
+	file->size = cast(isize)size;
+	return LoadedFile_None;
+}
+
+bool loaded_file_is_unchanged(char const *fullpath, LoadedFile const *file) {
+	return false; // NOTE: The last write time is not known here
+}
+
+void unload_file(LoadedFile *file) {
+	if (file->data != nullptr) {
+		gb_free(heap_allocator(), cast(void *)file->data);
+	}
+	zero_item(file);
+}
+#endif
+
+
 
 #define USE_DAMERAU_LEVENSHTEIN 1
 
@@ -113,7 +113,7 @@ enum ProcedureOptimizationMode : u32 {
 // An Entity is a named "thing" in the language
 struct Entity {
 	EntityKind  kind;
-	u64         id;
+	u32         id; // NOTE: Dense and unique, see `IdSet`
 	u64         flags;
 	EntityState state;
 	Token       token;
@@ -249,7 +249,9 @@ bool entity_has_deferred_procedure(Entity *e) {
 }
 
 
-gb_global u64 global_entity_id = 0;
+// NOTE: Entities are created on multiple threads, and the minimum dependency set
+// requires that each id is unique
+gb_global std::atomic<u32> global_entity_id;
 
 Entity *alloc_entity(EntityKind kind, Scope *scope, Token token, Type *type) {
 	gbAllocator a = permanent_allocator();
@@ -259,7 +261,7 @@ Entity *alloc_entity(EntityKind kind, Scope *scope, Token token, Type *type) {
 	entity->scope  = scope;
 	entity->token  = token;
 	entity->type   = type;
-	entity->id     = ++global_entity_id;
+	entity->id     = 1+global_entity_id.fetch_add(1, std::memory_order_relaxed);
 	return entity;
 }
 
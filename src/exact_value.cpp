@@ -75,8 +75,12 @@ HashKey hash_exact_value(ExactValue v) {
 		}
 	case ExactValue_Integer:
 		{
-			HashKey key = hashing_proc(v.value_integer.dp, gb_size_of(*v.value_integer.dp) * v.value_integer.used);
-			u8 last = (u8)v.value_integer.sign;
+			BigInt const *i = &v.value_integer;
+			if (!big_int_is_big(i)) {
+				return hash_integer(cast(u64)i->small);
+			}
+			HashKey key = hashing_proc(i->big.dp, gb_size_of(*i->big.dp) * i->big.used);
+			u8 last = (u8)i->big.sign;
 			key.key = (key.key ^ last) * 0x100000001b3ll;
 			return key;
 		}
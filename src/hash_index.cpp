@@ -0,0 +1,227 @@
+// NOTE: The open addressing index shared by `Map`, `StringMap`, `PtrSet`, and `StringSet`
+// The containers keep their `entries` dense and in insertion order; this only maps a hash to an entry index
+//
+// The slots are grouped into chunks of a cache line each, which hold a control byte and the entry index of each
+// of their slots. The control byte's top bit is set if the slot is empty or deleted, otherwise its low 7 bits are
+// the top 7 bits of the hash of its entry. A lookup matches all of a chunk's control bytes at once (with SSE2 if
+// available) and only compares the keys of the slots whose bytes match, so a hit usually touches one chunk and
+// the one entry.
+
+#if defined(GB_CPU_X86) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define HASH_INDEX_USE_SSE2 1
+#include <emmintrin.h>
+#else
+#define HASH_INDEX_USE_SSE2 0
+#endif
+
+typedef u32 HashIndexMask; // NOTE: A bit per slot in a chunk
+
+enum : u8 {
+	HashIndexCtrl_Empty   = 0x80,
+	HashIndexCtrl_Deleted = 0xfe,
+	HashIndexCtrl_Unused  = 0xff, // NOTE: The padding bytes of a chunk, never matched
+};
+
+enum : isize {
+	HASH_INDEX_CHUNK_WIDTH = 12,
+	HASH_INDEX_CHUNK_CTRL  = 16,
+	HASH_INDEX_CHUNK_SHIFT = 4, // NOTE: slot = chunk<<HASH_INDEX_CHUNK_SHIFT | index within the chunk
+};
+
+enum : HashIndexMask {
+	HASH_INDEX_CHUNK_MASK = (1u<<HASH_INDEX_CHUNK_WIDTH)-1,
+};
+
+struct HashIndexChunk {
+	u8  ctrl[HASH_INDEX_CHUNK_CTRL];
+	u32 slots[HASH_INDEX_CHUNK_WIDTH]; // entry index of each full slot
+};
+GB_STATIC_ASSERT(gb_size_of(HashIndexChunk) == 64);
+
+struct HashIndex {
+	HashIndexChunk *chunks;
+	void *memory;     // NOTE: `chunks` is aligned up from this, not every allocator can align to a cache line
+	isize chunk_mask; // chunk count - 1, the chunk count is a power of two
+	isize capacity;   // slots in every chunk, or 0 if nothing has been allocated
+	isize used;       // full and deleted slots
+};
+
+void  hash_index_init   (HashIndex *ix, gbAllocator a, isize entry_count);
+void  hash_index_destroy(HashIndex *ix, gbAllocator a);
+void  hash_index_clear  (HashIndex *ix);
+bool  hash_index_needs_grow(HashIndex const *ix);
+isize hash_index_capacity_for(isize entry_count);
+isize hash_index_insert (HashIndex *ix, u64 hash, u32 entry_index); // NOTE: the entry must not already be in the index
+void  hash_index_erase  (HashIndex *ix, isize slot);
+isize hash_index_slot_of_entry(HashIndex const *ix, u64 hash, u32 entry_index);
+
+
+gb_inline u64 hash_index_mix(u64 hash) {
+	// NOTE: Pointers and small integers have poor low and high bits, so spread them across the whole word
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdull;
+	hash ^= hash >> 33;
+	return hash;
+}
+
+gb_inline u8  hash_index_h2(u64 mixed) { return cast(u8)(mixed >> 57); }
+gb_inline u64 hash_index_h1(u64 mixed) { return mixed; }
+
+// NOTE: The entry index of a full slot
+gb_inline u32 *hash_index_slot(HashIndex const *ix, isize slot) {
+	return &ix->chunks[slot >> HASH_INDEX_CHUNK_SHIFT].slots[slot & ((1<<HASH_INDEX_CHUNK_SHIFT)-1)];
+}
+
+
+#if HASH_INDEX_USE_SSE2
+gb_inline HashIndexMask hash_index__match(HashIndexChunk const *c, u8 h2) {
+	__m128i ctrl = _mm_loadu_si128(cast(__m128i const *)c->ctrl);
+	return cast(HashIndexMask)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(cast(char)h2))) & HASH_INDEX_CHUNK_MASK;
+}
+gb_inline HashIndexMask hash_index__match_empty(HashIndexChunk const *c) {
+	return hash_index__match(c, HashIndexCtrl_Empty);
+}
+gb_inline HashIndexMask hash_index__match_empty_or_deleted(HashIndexChunk const *c) {
+	__m128i ctrl = _mm_loadu_si128(cast(__m128i const *)c->ctrl);
+	return cast(HashIndexMask)_mm_movemask_epi8(ctrl) & HASH_INDEX_CHUNK_MASK;
+}
+#else
+gb_inline HashIndexMask hash_index__match(HashIndexChunk const *c, u8 h2) {
+	HashIndexMask mask = 0;
+	for (isize i = 0; i < HASH_INDEX_CHUNK_WIDTH; i++) {
+		mask |= cast(HashIndexMask)(c->ctrl[i] == h2) << i;
+	}
+	return mask;
+}
+gb_inline HashIndexMask hash_index__match_empty(HashIndexChunk const *c) {
+	return hash_index__match(c, HashIndexCtrl_Empty);
+}
+gb_inline HashIndexMask hash_index__match_empty_or_deleted(HashIndexChunk const *c) {
+	HashIndexMask mask = 0;
+	for (isize i = 0; i < HASH_INDEX_CHUNK_WIDTH; i++) {
+		mask |= cast(HashIndexMask)(c->ctrl[i] >> 7) << i;
+	}
+	return mask;
+}
+#endif
+
+// NOTE: `mask` must not be zero
+gb_inline u32 hash_index__lowest_bit(HashIndexMask mask) {
+#if defined(GB_COMPILER_MSVC)
+	unsigned long index = 0;
+	_BitScanForward(&index, mask);
+	return cast(u32)index;
+#else
+	return cast(u32)__builtin_ctz(mask);
+#endif
+}
+
+gb_internal void hash_index__reset(HashIndex *ix) {
+	for (isize i = 0; i <= ix->chunk_mask; i++) {
+		HashIndexChunk *c = &ix->chunks[i];
+		gb_memset(c->ctrl, HashIndexCtrl_Empty, HASH_INDEX_CHUNK_WIDTH);
+		gb_memset(c->ctrl+HASH_INDEX_CHUNK_WIDTH, HashIndexCtrl_Unused, HASH_INDEX_CHUNK_CTRL-HASH_INDEX_CHUNK_WIDTH);
+	}
+	ix->used = 0;
+}
+
+
+// NOTE: The maximum load factor is 7/8
+isize hash_index_capacity_for(isize entry_count) {
+	isize min_slots = entry_count + entry_count/7 + 1;
+	isize chunk_count = next_pow2_isize((min_slots + HASH_INDEX_CHUNK_WIDTH-1) / HASH_INDEX_CHUNK_WIDTH);
+	return gb_max(chunk_count, 1) * HASH_INDEX_CHUNK_WIDTH;
+}
+
+void hash_index_init(HashIndex *ix, gbAllocator a, isize entry_count) {
+	isize capacity = hash_index_capacity_for(entry_count);
+	isize chunk_count = capacity / HASH_INDEX_CHUNK_WIDTH;
+	GB_ASSERT(chunk_count <= cast(isize)(U32_MAX >> HASH_INDEX_CHUNK_SHIFT));
+	ix->memory = gb_alloc(a, (chunk_count+1)*gb_size_of(HashIndexChunk));
+	ix->chunks = cast(HashIndexChunk *)ALIGN_UP_PTR(ix->memory, gb_size_of(HashIndexChunk));
+	ix->chunk_mask = chunk_count-1;
+	ix->capacity = capacity;
+	hash_index__reset(ix);
+}
+
+void hash_index_destroy(HashIndex *ix, gbAllocator a) {
+	if (ix->memory != nullptr) {
+		gb_free(a, ix->memory);
+	}
+	*ix = {};
+}
+
+void hash_index_clear(HashIndex *ix) {
+	if (ix->chunks != nullptr) {
+		hash_index__reset(ix);
+	}
+}
+
+gb_inline bool hash_index_needs_grow(HashIndex const *ix) {
+	return 8*(ix->used+1) > 7*ix->capacity;
+}
+
+// NOTE: Calls `eq(entry_index)` for each candidate and returns the slot of the first one which matches, or -1
+template <typename Eq>
+gb_inline isize hash_index_find(HashIndex const *ix, u64 hash, Eq const &eq) {
+	if (ix->capacity == 0) {
+		return -1;
+	}
+	u64 mixed = hash_index_mix(hash);
+	u8 h2 = hash_index_h2(mixed);
+	isize chunk = cast(isize)(hash_index_h1(mixed) & cast(u64)ix->chunk_mask);
+	for (isize step = 1; /**/; step += 1) {
+		HashIndexChunk const *c = &ix->chunks[chunk];
+		for (HashIndexMask m = hash_index__match(c, h2); m != 0; m &= m-1) {
+			u32 i = hash_index__lowest_bit(m);
+			if (eq(c->slots[i])) {
+				return chunk << HASH_INDEX_CHUNK_SHIFT | i;
+			}
+		}
+		if (hash_index__match_empty(c) != 0) {
+			return -1;
+		}
+		chunk = (chunk + step) & ix->chunk_mask;
+	}
+}
+
+isize hash_index_insert(HashIndex *ix, u64 hash, u32 entry_index) {
+	GB_ASSERT(ix->capacity > 0);
+	u64 mixed = hash_index_mix(hash);
+	isize chunk = cast(isize)(hash_index_h1(mixed) & cast(u64)ix->chunk_mask);
+	for (isize step = 1; /**/; step += 1) {
+		HashIndexChunk *c = &ix->chunks[chunk];
+		HashIndexMask m = hash_index__match_empty_or_deleted(c);
+		if (m != 0) {
+			u32 i = hash_index__lowest_bit(m);
+			if (c->ctrl[i] == HashIndexCtrl_Empty) {
+				ix->used += 1;
+			}
+			c->ctrl[i] = hash_index_h2(mixed);
+			c->slots[i] = entry_index;
+			return chunk << HASH_INDEX_CHUNK_SHIFT | i;
+		}
+		chunk = (chunk + step) & ix->chunk_mask;
+	}
+}
+
+void hash_index_erase(HashIndex *ix, isize slot) {
+	// NOTE: A probe sequence only goes past a chunk with no empty slots, so if the chunk still has
+	// one, none can have gone past it and the slot can be made empty rather than deleted
+	HashIndexChunk *c = &ix->chunks[slot >> HASH_INDEX_CHUNK_SHIFT];
+	isize i = slot & ((1<<HASH_INDEX_CHUNK_SHIFT)-1);
+	if (hash_index__match_empty(c) != 0) {
+		c->ctrl[i] = HashIndexCtrl_Empty;
+		ix->used -= 1;
+	} else {
+		c->ctrl[i] = HashIndexCtrl_Deleted;
+	}
+}
+
+isize hash_index_slot_of_entry(HashIndex const *ix, u64 hash, u32 entry_index) {
+	isize slot = hash_index_find(ix, hash, [entry_index](u32 index) -> bool {
+		return index == entry_index;
+	});
+	GB_ASSERT(slot >= 0);
+	return slot;
+}
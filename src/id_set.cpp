@@ -0,0 +1,186 @@
+// NOTE: Sets of objects which have a dense 32-bit `id`, i.e. Entity and Type
+// Both keep their elements in insertion order in `entries`, so iterating them is deterministic
+//
+// IdSet:      A bit per id for membership, which is a single load
+//             Meant for large sets across the whole program (e.g. the minimum dependency set)
+// SmallIdSet: A linear scan whilst small, then an open addressed table of entry indices keyed by the id
+//             Meant for the many small sets (e.g. the dependencies of each DeclInfo)
+
+template <typename T>
+struct IdSet {
+	Array<u64> bits;
+	Array<T>   entries;
+};
+
+template <typename T> void id_set_init   (IdSet<T> *s, gbAllocator a, isize id_capacity = 0);
+template <typename T> void id_set_destroy(IdSet<T> *s);
+template <typename T> bool id_set_exists (IdSet<T> const *s, T ptr);
+template <typename T> bool id_set_update (IdSet<T> *s, T ptr); // returns true if it previously existed
+template <typename T> void id_set_add    (IdSet<T> *s, T ptr);
+template <typename T> void id_set_clear  (IdSet<T> *s);
+
+
+template <typename T>
+void id_set_init(IdSet<T> *s, gbAllocator a, isize id_capacity) {
+	array_init(&s->bits, a, (id_capacity+63)/64);
+	array_init(&s->entries, a);
+	gb_zero_size(s->bits.data, gb_size_of(u64)*s->bits.count);
+}
+
+template <typename T>
+void id_set_destroy(IdSet<T> *s) {
+	array_free(&s->bits);
+	array_free(&s->entries);
+}
+
+template <typename T>
+gb_inline bool id_set_exists(IdSet<T> const *s, T ptr) {
+	u32 id = ptr->id;
+	isize word = id>>6;
+	if (word >= s->bits.count) {
+		return false;
+	}
+	return (s->bits.data[word] & (1ull<<(id&63))) != 0;
+}
+
+template <typename T>
+bool id_set_update(IdSet<T> *s, T ptr) {
+	u32 id = ptr->id;
+	isize word = id>>6;
+	if (word >= s->bits.count) {
+		isize old_count = s->bits.count;
+		array_resize(&s->bits, gb_max(word+1, 2*old_count));
+		gb_zero_size(s->bits.data+old_count, gb_size_of(u64)*(s->bits.count-old_count));
+	}
+	u64 mask = 1ull<<(id&63);
+	if (s->bits.data[word] & mask) {
+		return true;
+	}
+	s->bits.data[word] |= mask;
+	array_add(&s->entries, ptr);
+	return false;
+}
+
+template <typename T>
+gb_inline void id_set_add(IdSet<T> *s, T ptr) {
+	id_set_update(s, ptr);
+}
+
+template <typename T>
+void id_set_clear(IdSet<T> *s) {
+	gb_zero_size(s->bits.data, gb_size_of(u64)*s->bits.count);
+	array_clear(&s->entries);
+}
+
+
+
+enum : isize {
+	SMALL_ID_SET_LINEAR_COUNT = 8, // NOTE: 8 pointers fit within a single cache line
+};
+
+template <typename T>
+struct SmallIdSet {
+	Array<T> entries;
+	u32 *    slots;      // NOTE: 0 means empty, otherwise it is the index into `entries` plus one
+	u32      slot_count; // NOTE: Always a power of two
+};
+
+template <typename T> void small_id_set_init   (SmallIdSet<T> *s, gbAllocator a);
+template <typename T> void small_id_set_destroy(SmallIdSet<T> *s);
+template <typename T> bool small_id_set_exists (SmallIdSet<T> const *s, T ptr);
+template <typename T> bool small_id_set_update (SmallIdSet<T> *s, T ptr); // returns true if it previously existed
+template <typename T> void small_id_set_add    (SmallIdSet<T> *s, T ptr);
+
+
+gb_inline u32 small_id_set__hash(u32 id) {
+	// NOTE: Fibonacci hashing, as the ids are mostly sequential
+	return id * 0x9e3779b9u;
+}
+
+template <typename T>
+void small_id_set_init(SmallIdSet<T> *s, gbAllocator a) {
+	array_init(&s->entries, a);
+	s->slots = nullptr;
+	s->slot_count = 0;
+}
+
+template <typename T>
+void small_id_set_destroy(SmallIdSet<T> *s) {
+	if (s->slots != nullptr) {
+		gb_free(s->entries.allocator, s->slots);
+	}
+	array_free(&s->entries);
+	s->slots = nullptr;
+	s->slot_count = 0;
+}
+
+template <typename T>
+gb_internal u32 *small_id_set__find_slot(SmallIdSet<T> const *s, T ptr) {
+	u32 mask = s->slot_count-1;
+	u32 index = small_id_set__hash(ptr->id) & mask;
+	for (;;) {
+		u32 *slot = &s->slots[index];
+		if (*slot == 0 || s->entries.data[*slot-1] == ptr) {
+			return slot;
+		}
+		index = (index+1) & mask;
+	}
+}
+
+template <typename T>
+gb_internal void small_id_set__rehash(SmallIdSet<T> *s, u32 new_slot_count) {
+	if (s->slots != nullptr) {
+		gb_free(s->entries.allocator, s->slots);
+	}
+	s->slots = gb_alloc_array(s->entries.allocator, u32, new_slot_count);
+	s->slot_count = new_slot_count;
+	gb_zero_size(s->slots, gb_size_of(u32)*new_slot_count);
+	for_array(i, s->entries) {
+		u32 *slot = small_id_set__find_slot(s, s->entries.data[i]);
+		*slot = cast(u32)(i+1);
+	}
+}
+
+template <typename T>
+bool small_id_set_exists(SmallIdSet<T> const *s, T ptr) {
+	if (s->slots == nullptr) {
+		for_array(i, s->entries) {
+			if (s->entries.data[i] == ptr) {
+				return true;
+			}
+		}
+		return false;
+	}
+	return *small_id_set__find_slot(s, ptr) != 0;
+}
+
+template <typename T>
+bool small_id_set_update(SmallIdSet<T> *s, T ptr) {
+	if (s->slots == nullptr) {
+		if (small_id_set_exists(s, ptr)) {
+			return true;
+		}
+		array_add(&s->entries, ptr);
+		if (s->entries.count > SMALL_ID_SET_LINEAR_COUNT) {
+			small_id_set__rehash(s, 4*SMALL_ID_SET_LINEAR_COUNT);
+		}
+		return false;
+	}
+
+	u32 *slot = small_id_set__find_slot(s, ptr);
+	if (*slot != 0) {
+		return true;
+	}
+	array_add(&s->entries, ptr);
+	*slot = cast(u32)s->entries.count;
+	// NOTE: Keep the load factor at most a half
+	if (2*cast(u32)s->entries.count > s->slot_count) {
+		small_id_set__rehash(s, 2*s->slot_count);
+	}
+	return false;
+}
+
+template <typename T>
+gb_inline void small_id_set_add(SmallIdSet<T> *s, T ptr) {
+	small_id_set_update(s, ptr);
+}
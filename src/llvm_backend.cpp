@@ -12,22 +12,22 @@
 #include "llvm_backend.hpp"
 #include "llvm_abi.cpp"
 #include "llvm_backend_opt.cpp"
+#include "llvm_backend_cache.cpp"
 
 gb_global ThreadPool lb_thread_pool = {};
 
-gb_global Entity *lb_global_type_info_data_entity   = {};
-gb_global lbAddr lb_global_type_info_member_types   = {};
-gb_global lbAddr lb_global_type_info_member_names   = {};
-gb_global lbAddr lb_global_type_info_member_offsets = {};
-gb_global lbAddr lb_global_type_info_member_usings  = {};
-gb_global lbAddr lb_global_type_info_member_tags    = {};
+struct lbTypeInfoMemberArray {
+	lbAddr        addr;
+	isize         index;
+	LLVMValueRef *values; // NOTE: Constant initializer of each element, nullptr is zero
+};
 
-gb_global isize lb_global_type_info_data_index           = 0;
-gb_global isize lb_global_type_info_member_types_index   = 0;
-gb_global isize lb_global_type_info_member_names_index   = 0;
-gb_global isize lb_global_type_info_member_offsets_index = 0;
-gb_global isize lb_global_type_info_member_usings_index  = 0;
-gb_global isize lb_global_type_info_member_tags_index    = 0;
+gb_global Entity *lb_global_type_info_data_entity = {};
+gb_global lbTypeInfoMemberArray lb_global_type_info_member_types   = {};
+gb_global lbTypeInfoMemberArray lb_global_type_info_member_names   = {};
+gb_global lbTypeInfoMemberArray lb_global_type_info_member_offsets = {};
+gb_global lbTypeInfoMemberArray lb_global_type_info_member_usings  = {};
+gb_global lbTypeInfoMemberArray lb_global_type_info_member_tags    = {};
 
 
 lbValue lb_global_type_info_data_ptr(lbModule *m) {
@@ -171,14 +171,7 @@ lbValue lb_addr_get_ptr(lbProcedure *p, lbAddr const &addr) {
 	switch (addr.kind) {
 	case lbAddr_Map: {
 		Type *map_type = base_type(addr.map.type);
-		lbValue h = lb_gen_map_header(p, addr.addr, map_type);
-		lbValue key = lb_gen_map_hash(p, addr.map.key, map_type->Map.key);
-
-		auto args = array_make<lbValue>(permanent_allocator(), 2);
-		args[0] = h;
-		args[1] = key;
-
-		lbValue ptr = lb_emit_runtime_call(p, "__dynamic_map_get", args);
+		lbValue ptr = lb_emit_map_get(p, addr.addr, map_type, addr.map.key);
 
 		return lb_emit_conv(p, ptr, alloc_type_pointer(map_type->Map.value));
 	}
@@ -708,14 +701,7 @@ lbValue lb_addr_load(lbProcedure *p, lbAddr const &addr) {
 	} else if (addr.kind == lbAddr_Map) {
 		Type *map_type = base_type(addr.map.type);
 		lbAddr v = lb_add_local_generated(p, map_type->Map.lookup_result_type, true);
-		lbValue h = lb_gen_map_header(p, addr.addr, map_type);
-		lbValue key = lb_gen_map_hash(p, addr.map.key, map_type->Map.key);
-
-		auto args = array_make<lbValue>(permanent_allocator(), 2);
-		args[0] = h;
-		args[1] = key;
-
-		lbValue ptr = lb_emit_runtime_call(p, "__dynamic_map_get", args);
+		lbValue ptr = lb_emit_map_get(p, addr.addr, map_type, addr.map.key);
 		lbValue ok = lb_emit_conv(p, lb_emit_comp_against_nil(p, Token_NotEq, ptr), t_bool);
 		lb_emit_store(p, lb_emit_struct_ep(p, v.addr, 1), ok);
 
@@ -989,7 +975,16 @@ String lb_mangle_name(lbModule *m, Entity *e) {
 	if (require_suffix_id) {
 		char *str = new_name + new_name_len-1;
 		isize len = max_len-new_name_len;
-		isize extra = gb_snprintf(str, len, "-%llu", cast(unsigned long long)e->id);
+		u64 stable_id = 0;
+		if (build_context.incremental) {
+			stable_id = lb_cache_stable_entity_id(e, make_string(cast(u8 const *)new_name, new_name_len-1));
+		}
+		isize extra = 0;
+		if (stable_id != 0) {
+			extra = gb_snprintf(str, len, "-%016llx", cast(unsigned long long)stable_id);
+		} else {
+			extra = gb_snprintf(str, len, "-%llu", cast(unsigned long long)e->id);
+		}
 		new_name_len += extra-1;
 	}
 
@@ -997,13 +992,67 @@ String lb_mangle_name(lbModule *m, Entity *e) {
 	return mangled_name;
 }
 
+// NOTE: `Entity::Procedure.link_name` and `Entity::TypeName.ir_mangled_name` may be named by several modules
+// being generated at once, and the first module to name an entity decides its name. A name is published by storing its
+// length after its text, and a length of -1 marks a name which is being written, so naming an entity takes no lock
+gb_inline std::atomic<isize> *lb_entity_name_len(String *name) {
+	return reinterpret_cast<std::atomic<isize> *>(&name->len);
+}
+gb_inline std::atomic<u8 *> *lb_entity_name_text(String *name) {
+	return reinterpret_cast<std::atomic<u8 *> *>(&name->text);
+}
+
+String lb_entity_name_load(String *name) {
+	for (;;) {
+		isize len = lb_entity_name_len(name)->load(std::memory_order_acquire);
+		if (len >= 0) {
+			u8 *text = lb_entity_name_text(name)->load(std::memory_order_acquire);
+			// NOTE: The name may have been replaced whilst reading its text
+			if (lb_entity_name_len(name)->load(std::memory_order_acquire) == len) {
+				return make_string(text, len);
+			}
+		}
+		gb_yield();
+	}
+}
+
+String lb_entity_name_publish(String *name, String new_name, bool only_if_unset) {
+	std::atomic<isize> *len = lb_entity_name_len(name);
+	for (;;) {
+		isize prev_len = len->load(std::memory_order_acquire);
+		if (prev_len < 0) {
+			gb_yield();
+			continue;
+		}
+		if (only_if_unset && prev_len != 0) {
+			return lb_entity_name_load(name);
+		}
+		if (len->compare_exchange_weak(prev_len, -1, std::memory_order_acq_rel)) {
+			break;
+		}
+	}
+	lb_entity_name_text(name)->store(new_name.text, std::memory_order_release);
+	len->store(new_name.len, std::memory_order_release);
+	return new_name;
+}
+
+void lb_entity_name_store(String *name, String new_name) {
+	lb_entity_name_publish(name, new_name, false);
+}
+
+// NOTE: Returns the name which was already set, if any, otherwise `new_name`
+String lb_entity_name_store_once(String *name, String new_name) {
+	return lb_entity_name_publish(name, new_name, true);
+}
+
 String lb_set_nested_type_name_ir_mangled_name(Entity *e, lbProcedure *p) {
 	// NOTE(bill, 2020-03-08): A polymorphic procedure may take a nested type declaration
 	// and as a result, the declaration does not have time to determine what it should be
 
 	GB_ASSERT(e != nullptr && e->kind == Entity_TypeName);
-	if (e->TypeName.ir_mangled_name.len != 0)  {
-		return e->TypeName.ir_mangled_name;
+	String prev_name = lb_entity_name_load(&e->TypeName.ir_mangled_name);
+	if (prev_name.len != 0)  {
+		return prev_name;
 	}
 	GB_ASSERT((e->scope->flags & ScopeFlag_File) == 0);
 
@@ -1037,28 +1086,29 @@ String lb_set_nested_type_name_ir_mangled_name(Entity *e, lbProcedure *p) {
 		name_len = gb_snprintf(name_text, name_len, "%.*s.%.*s-%u", LIT(p->name), LIT(ts_name), guid);
 
 		String name = make_string(cast(u8 *)name_text, name_len-1);
-		e->TypeName.ir_mangled_name = name;
-		return name;
+		return lb_entity_name_store_once(&e->TypeName.ir_mangled_name, name);
 	} else {
 		// NOTE(bill): a nested type be required before its parameter procedure exists. Just give it a temp name for now
 		isize name_len = 9 + 1 + ts_name.len + 1 + 10 + 1;
 		char *name_text = gb_alloc_array(permanent_allocator(), char, name_len);
-		static u32 guid = 0;
-		guid += 1;
+		static std::atomic<u32> global_guid;
+		u32 guid = 1+global_guid.fetch_add(1, std::memory_order_relaxed);
 		name_len = gb_snprintf(name_text, name_len, "_internal.%.*s-%u", LIT(ts_name), guid);
 
 		String name = make_string(cast(u8 *)name_text, name_len-1);
-		e->TypeName.ir_mangled_name = name;
-		return name;
+		return lb_entity_name_store_once(&e->TypeName.ir_mangled_name, name);
 	}
 }
 
 
 String lb_get_entity_name(lbModule *m, Entity *e, String default_name) {
-	if (e != nullptr && e->kind == Entity_TypeName && e->TypeName.ir_mangled_name.len != 0) {
-		return e->TypeName.ir_mangled_name;
-	}
 	GB_ASSERT(e != nullptr);
+	if (e->kind == Entity_TypeName) {
+		String prev_name = lb_entity_name_load(&e->TypeName.ir_mangled_name);
+		if (prev_name.len != 0) {
+			return prev_name;
+		}
+	}
 
 	if (e->pkg == nullptr) {
 		return e->token.string;
@@ -1079,10 +1129,12 @@ String lb_get_entity_name(lbModule *m, Entity *e, String default_name) {
 		if (e->Variable.link_name.len > 0) {
 			return e->Variable.link_name;
 		}
-	} else if (e->kind == Entity_Procedure && e->Procedure.link_name.len > 0) {
-		return e->Procedure.link_name;
-	} else if (e->kind == Entity_Procedure && e->Procedure.is_export) {
-		no_name_mangle = true;
+	} else if (e->kind == Entity_Procedure) {
+		String prev_name = lb_entity_name_load(&e->Procedure.link_name);
+		if (prev_name.len > 0) {
+			return prev_name;
+		}
+		no_name_mangle = e->Procedure.is_export;
 	}
 
 	if (!no_name_mangle) {
@@ -1093,9 +1145,9 @@ String lb_get_entity_name(lbModule *m, Entity *e, String default_name) {
 	}
 
 	if (e->kind == Entity_TypeName) {
-		e->TypeName.ir_mangled_name = name;
+		name = lb_entity_name_store_once(&e->TypeName.ir_mangled_name, name);
 	} else if (e->kind == Entity_Procedure) {
-		e->Procedure.link_name = name;
+		name = lb_entity_name_store_once(&e->Procedure.link_name, name);
 	}
 
 	return name;
@@ -2158,6 +2210,22 @@ LLVMMetadataRef lb_get_base_scope_metadata(lbModule *m, Scope *scope) {
 	}
 }
 
+// NOTE: Identical types must share their debug metadata. When a temporary forward declaration is
+// replaced, LLVM deletes any uniqued node which then becomes identical to another node, so any other
+// metadata cached for an identical type could be left dangling
+Type *lb_debug_canonical_type(lbModule *m, Type *type) {
+	HashKey key = hash_integer(type_hash(type));
+	for (auto *entry = multi_map_find_first(&m->debug_canonical_types, key);
+	     entry != nullptr;
+	     entry = multi_map_find_next(&m->debug_canonical_types, entry)) {
+		if (entry->value == type || are_types_identical(entry->value, type)) {
+			return entry->value;
+		}
+	}
+	multi_map_insert(&m->debug_canonical_types, key, type);
+	return type;
+}
+
 LLVMMetadataRef lb_debug_type(lbModule *m, Type *type) {
 	GB_ASSERT(type != nullptr);
 	LLVMMetadataRef found = lb_get_llvm_metadata(m, type);
@@ -2165,6 +2233,12 @@ LLVMMetadataRef lb_debug_type(lbModule *m, Type *type) {
 		return found;
 	}
 
+	Type *canonical = lb_debug_canonical_type(m, type);
+	if (canonical != type) {
+		// NOTE: Do not cache it for this type, as the canonical type's metadata may still be temporary
+		return lb_debug_type(m, canonical);
+	}
+
 	if (type->kind == Type_Named) {
 		LLVMMetadataRef file = nullptr;
 		unsigned line = 0;
@@ -2767,8 +2841,12 @@ lbProcedure *lb_create_procedure(lbModule *m, Entity *entity, bool ignore_body)
 	lbProcedure *p = gb_alloc_item(permanent_allocator(), lbProcedure);
 
 	p->module = m;
-	entity->code_gen_module = m;
-	entity->code_gen_procedure = p;
+	if (!ignore_body) {
+		// NOTE: Only the module which owns the body may claim the entity,
+		// other modules only declare it and may be generated on another thread
+		entity->code_gen_module = m;
+		entity->code_gen_procedure = p;
+	}
 	p->entity = entity;
 	p->name = link_name;
 
@@ -3722,7 +3800,7 @@ void lb_build_nested_proc(lbProcedure *p, AstProcLit *pd, Entity *e) {
 	lbModule *m = p->module;
 	auto *min_dep_set = &m->info->minimum_dependency_set;
 
-	if (ptr_set_exists(min_dep_set, e) == false) {
+	if (id_set_exists(min_dep_set, e) == false) {
 		// NOTE(bill): Nothing depends upon it so doesn't need to be built
 		return;
 	}
@@ -3730,9 +3808,9 @@ void lb_build_nested_proc(lbProcedure *p, AstProcLit *pd, Entity *e) {
 	// NOTE(bill): Generate a new name
 	// parent.name-guid
 	String original_name = e->token.string;
-	String pd_name = original_name;
-	if (e->Procedure.link_name.len > 0) {
-		pd_name = e->Procedure.link_name;
+	String pd_name = lb_entity_name_load(&e->Procedure.link_name);
+	if (pd_name.len == 0) {
+		pd_name = original_name;
 	}
 
 
@@ -3743,7 +3821,7 @@ void lb_build_nested_proc(lbProcedure *p, AstProcLit *pd, Entity *e) {
 	name_len = gb_snprintf(name_text, name_len, "%.*s.%.*s-%d", LIT(p->name), LIT(pd_name), guid);
 	String name = make_string(cast(u8 *)name_text, name_len-1);
 
-	e->Procedure.link_name = name;
+	lb_entity_name_store(&e->Procedure.link_name, name);
 
 	lbProcedure *nested_proc = lb_create_procedure(p->module, e);
 	e->code_gen_procedure = nested_proc;
@@ -3818,15 +3896,11 @@ void lb_build_constant_value_decl(lbProcedure *p, AstValueDecl *vd) {
 			}
 		}
 
-		if (!polymorphic_struct && !ptr_set_exists(min_dep_set, e)) {
-			continue;
-		}
-
-		if (e->TypeName.ir_mangled_name.len != 0) {
-			// NOTE(bill): Already set
+		if (!polymorphic_struct && !id_set_exists(min_dep_set, e)) {
 			continue;
 		}
 
+		// NOTE: Does nothing if it is already set
 		lb_set_nested_type_name_ir_mangled_name(e, p);
 	}
 
@@ -3854,7 +3928,7 @@ void lb_build_constant_value_decl(lbProcedure *p, AstValueDecl *vd) {
 				auto procs = *found;
 				for_array(i, procs) {
 					Entity *e = procs[i];
-					if (!ptr_set_exists(min_dep_set, e)) {
+					if (!id_set_exists(min_dep_set, e)) {
 						continue;
 					}
 					DeclInfo *d = decl_info_of_entity(e);
@@ -3867,14 +3941,14 @@ void lb_build_constant_value_decl(lbProcedure *p, AstValueDecl *vd) {
 
 			// FFI - Foreign function interace
 			String original_name = e->token.string;
-			String name = original_name;
 
 			if (e->Procedure.is_foreign) {
 				lb_add_foreign_library_path(p->module, e->Procedure.foreign_library);
 			}
 
-			if (e->Procedure.link_name.len > 0) {
-				name = e->Procedure.link_name;
+			String name = lb_entity_name_load(&e->Procedure.link_name);
+			if (name.len == 0) {
+				name = original_name;
 			}
 
 			lbValue *prev_value = string_map_get(&p->module->members, name);
@@ -3883,7 +3957,7 @@ void lb_build_constant_value_decl(lbProcedure *p, AstValueDecl *vd) {
 				return;
 			}
 
-			e->Procedure.link_name = name;
+			name = lb_entity_name_store_once(&e->Procedure.link_name, name);
 
 			lbProcedure *nested_proc = lb_create_procedure(p->module, e);
 
@@ -4646,11 +4720,11 @@ void lb_build_unroll_range_stmt(lbProcedure *p, AstUnrollRangeStmt *rs, Scope *s
 		TokenKind op = expr->BinaryExpr.op.kind;
 		Ast *start_expr = expr->BinaryExpr.left;
 		Ast *end_expr   = expr->BinaryExpr.right;
-		GB_ASSERT(start_expr->tav.mode == Addressing_Constant);
-		GB_ASSERT(end_expr->tav.mode == Addressing_Constant);
+		GB_ASSERT(start_expr->tav->mode == Addressing_Constant);
+		GB_ASSERT(end_expr->tav->mode == Addressing_Constant);
 
-		ExactValue start = start_expr->tav.value;
-		ExactValue end   = end_expr->tav.value;
+		ExactValue start = start_expr->tav->value;
+		ExactValue end   = end_expr->tav->value;
 		if (op != Token_RangeHalf) { // .. [start, end] (or ..=)
 			ExactValue index = exact_value_i64(0);
 			for (ExactValue val = start;
@@ -4700,16 +4774,16 @@ void lb_build_unroll_range_stmt(lbProcedure *p, AstUnrollRangeStmt *rs, Scope *s
 		if (val0_type) val0_addr = lb_build_addr(p, rs->val0);
 		if (val1_type) val1_addr = lb_build_addr(p, rs->val1);
 
-		GB_ASSERT(expr->tav.mode == Addressing_Constant);
+		GB_ASSERT(expr->tav->mode == Addressing_Constant);
 
-		Type *t = base_type(expr->tav.type);
+		Type *t = base_type(expr->tav->type);
 
 
 		switch (t->kind) {
 		case Type_Basic:
 			GB_ASSERT(is_type_string(t));
 			{
-				ExactValue value = expr->tav.value;
+				ExactValue value = expr->tav->value;
 				GB_ASSERT(value.kind == ExactValue_String);
 				String str = value.value_string;
 				Rune codepoint = 0;
@@ -4803,7 +4877,7 @@ bool lb_switch_stmt_can_be_trivial_jump_table(AstSwitchStmt *ss, bool *default_f
 			if (is_ast_range(expr)) {
 				return false;
 			}
-			if (expr->tav.mode == Addressing_Type) {
+			if (expr->tav->mode == Addressing_Type) {
 				GB_ASSERT(is_typeid);
 				continue;
 			}
@@ -4822,6 +4896,143 @@ bool lb_switch_stmt_can_be_trivial_jump_table(AstSwitchStmt *ss, bool *default_f
 }
 
 
+// NOTE: A switch on a string with enough constant cases is dispatched on the length and then on the bytes
+// which tell the remaining cases apart, so that at most one string comparison is needed rather than one per case
+enum : isize {LB_STRING_SWITCH_MIN_CASES = 4};
+
+struct lbStringSwitchCase {
+	String   value;
+	Ast *    expr;
+	lbBlock *body;
+};
+
+GB_COMPARE_PROC(lb_string_switch_case_cmp) {
+	lbStringSwitchCase const *x = cast(lbStringSwitchCase const *)a;
+	lbStringSwitchCase const *y = cast(lbStringSwitchCase const *)b;
+	if (x->value.len != y->value.len) {
+		return x->value.len < y->value.len ? -1 : +1;
+	}
+	return string_compare(x->value, y->value);
+}
+
+bool lb_switch_stmt_can_be_string_table(AstSwitchStmt *ss) {
+	if (ss->tag == nullptr) {
+		return false;
+	}
+	TypeAndValue tv = type_and_value_of_expr(ss->tag);
+	if (!is_type_string(tv.type) || is_type_cstring(tv.type)) {
+		return false;
+	}
+
+	isize case_count = 0;
+	ast_node(body, BlockStmt, ss->body);
+	for_array(i, body->stmts) {
+		ast_node(cc, CaseClause, body->stmts[i]);
+		for_array(j, cc->list) {
+			Ast *expr = unparen_expr(cc->list[j]);
+			if (is_ast_range(expr)) {
+				return false;
+			}
+			tv = type_and_value_of_expr(expr);
+			if (tv.mode != Addressing_Constant || tv.value.kind != ExactValue_String) {
+				return false;
+			}
+			case_count += 1;
+		}
+	}
+	return case_count >= LB_STRING_SWITCH_MIN_CASES;
+}
+
+// NOTE: All of `cases` have the same length and different values, and `checked_count` of their bytes
+// have already been matched against the tag
+void lb_build_string_switch_node(lbProcedure *p, lbValue tag, lbValue tag_data, Slice<lbStringSwitchCase> cases, isize checked_count, lbBlock *default_block) {
+	if (cases.count == 1) {
+		lbStringSwitchCase const &c = cases[0];
+		if (checked_count == c.value.len) {
+			lb_emit_jump(p, c.body);
+		} else {
+			lbValue cond = lb_emit_comp(p, Token_CmpEq, tag, lb_build_expr(p, c.expr));
+			lb_emit_if(p, cond, c.body, default_block);
+		}
+		return;
+	}
+
+	// NOTE: Pick the byte which has the most distinct values amongst the cases
+	isize len = cases[0].value.len;
+	isize best_index = -1;
+	isize best_count = 0;
+	for (isize i = 0; i < len; i++) {
+		bool seen[256] = {};
+		isize count = 0;
+		for_array(j, cases) {
+			u8 c = cases[j].value[i];
+			count += !seen[c];
+			seen[c] = true;
+		}
+		if (count > best_count) {
+			best_index = i;
+			best_count = count;
+			if (count == cases.count) {
+				break;
+			}
+		}
+	}
+	GB_ASSERT(best_index >= 0 && best_count > 1);
+
+	lbValue byte_ptr = lb_emit_ptr_offset(p, tag_data, lb_const_int(p->module, t_int, best_index));
+	lbValue byte = lb_emit_load(p, byte_ptr);
+	LLVMValueRef switch_instr = LLVMBuildSwitch(p->builder, byte.value, default_block->block, cast(unsigned)best_count);
+
+	auto bucket = array_make<lbStringSwitchCase>(heap_allocator(), 0, cases.count);
+	defer (array_free(&bucket));
+	for (isize c = 0; c < 256; c++) {
+		array_clear(&bucket);
+		for_array(j, cases) {
+			if (cases[j].value[best_index] == c) {
+				array_add(&bucket, cases[j]);
+			}
+		}
+		if (bucket.count == 0) {
+			continue;
+		}
+		lbBlock *block = lb_create_block(p, "switch.string.byte");
+		LLVMAddCase(switch_instr, lb_const_int(p->module, t_u8, c).value, block->block);
+		lb_start_block(p, block);
+		lb_build_string_switch_node(p, tag, tag_data, slice_from_array(bucket), checked_count+1, default_block);
+	}
+}
+
+void lb_build_string_switch(lbProcedure *p, lbValue tag, Array<lbStringSwitchCase> const &cases, lbBlock *default_block) {
+	gb_sort_array(cases.data, cases.count, lb_string_switch_case_cmp);
+
+	isize len_count = 0;
+	for_array(i, cases) {
+		if (i == 0 || cases[i-1].value.len != cases[i].value.len) {
+			len_count += 1;
+		}
+	}
+
+	lbValue tag_len  = lb_string_len(p, tag);
+	lbValue tag_data = lb_string_elem(p, tag);
+	LLVMValueRef switch_instr = LLVMBuildSwitch(p->builder, tag_len.value, default_block->block, cast(unsigned)len_count);
+
+	for (isize i = 0; i < cases.count; /**/) {
+		isize len = cases[i].value.len;
+		isize end = i+1;
+		while (end < cases.count && cases[end].value.len == len) {
+			end += 1;
+		}
+
+		lbBlock *block = lb_create_block(p, "switch.string.len");
+		LLVMAddCase(switch_instr, lb_const_int(p->module, t_int, len).value, block->block);
+		lb_start_block(p, block);
+		lb_build_string_switch_node(p, tag, tag_data, slice_array(cases, i, end), 0, default_block);
+
+		i = end;
+	}
+}
+
+
 void lb_build_switch_stmt(lbProcedure *p, AstSwitchStmt *ss, Scope *scope) {
 	lb_open_scope(p, scope);
 
@@ -4844,6 +5055,8 @@ void lb_build_switch_stmt(lbProcedure *p, AstSwitchStmt *ss, Scope *scope) {
 
 	bool default_found = false;
 	bool is_trivial = lb_switch_stmt_can_be_trivial_jump_table(ss, &default_found);
+	bool is_string_table = !is_trivial && lb_switch_stmt_can_be_string_table(ss);
+	bool is_jump_table = is_trivial || is_string_table;
 
 	auto body_blocks = slice_make<lbBlock *>(permanent_allocator(), body->stmts.count);
 	for_array(i, body->stmts) {
@@ -4872,6 +5085,22 @@ void lb_build_switch_stmt(lbProcedure *p, AstSwitchStmt *ss, Scope *scope) {
 		}
 
 		switch_instr = LLVMBuildSwitch(p->builder, tag.value, end_block, cast(unsigned)num_cases);
+	} else if (is_string_table) {
+		auto cases = array_make<lbStringSwitchCase>(heap_allocator());
+		defer (array_free(&cases));
+		for_array(i, body->stmts) {
+			ast_node(cc, CaseClause, body->stmts[i]);
+			for_array(j, cc->list) {
+				Ast *expr = unparen_expr(cc->list[j]);
+				lbStringSwitchCase c = {};
+				c.value = type_and_value_of_expr(expr).value.value_string;
+				c.expr  = expr;
+				c.body  = body_blocks[i];
+				array_add(&cases, c);
+			}
+		}
+
+		lb_build_string_switch(p, tag, cases, default_block ? default_block : done);
 	}
 
 
@@ -4889,7 +5118,7 @@ void lb_build_switch_stmt(lbProcedure *p, AstSwitchStmt *ss, Scope *scope) {
 			// default case
 			default_stmts = cc->stmts;
 			default_fall  = fall;
-			if (switch_instr == nullptr) {
+			if (!is_jump_table) {
 				default_block = body;
 			} else {
 				GB_ASSERT(default_block != nullptr);
@@ -4901,14 +5130,17 @@ void lb_build_switch_stmt(lbProcedure *p, AstSwitchStmt *ss, Scope *scope) {
 		for_array(j, cc->list) {
 			Ast *expr = unparen_expr(cc->list[j]);
 
+			if (is_string_table) {
+				continue;
+			}
 			if (switch_instr != nullptr) {
 				lbValue on_val = {};
-				if (expr->tav.mode == Addressing_Type) {
+				if (expr->tav->mode == Addressing_Type) {
 					GB_ASSERT(is_type_typeid(tag.type));
-					lbValue e = lb_typeid(p->module, expr->tav.type);
+					lbValue e = lb_typeid(p->module, expr->tav->type);
 					on_val = lb_emit_conv(p, e, tag.type);
 				} else {
-					GB_ASSERT(expr->tav.mode == Addressing_Constant);
+					GB_ASSERT(expr->tav->mode == Addressing_Constant);
 					GB_ASSERT(!is_ast_range(expr));
 
 					on_val = lb_build_expr(p, expr);
@@ -4939,9 +5171,9 @@ void lb_build_switch_stmt(lbProcedure *p, AstSwitchStmt *ss, Scope *scope) {
 				lbValue cond_rhs = lb_emit_comp(p, op, tag, rhs);
 				cond = lb_emit_arith(p, Token_And, cond_lhs, cond_rhs, t_bool);
 			} else {
-				if (expr->tav.mode == Addressing_Type) {
+				if (expr->tav->mode == Addressing_Type) {
 					GB_ASSERT(is_type_typeid(tag.type));
-					lbValue e = lb_typeid(p->module, expr->tav.type);
+					lbValue e = lb_typeid(p->module, expr->tav->type);
 					e = lb_emit_conv(p, e, tag.type);
 					cond = lb_emit_comp(p, Token_CmpEq, tag, e);
 				} else {
@@ -4961,13 +5193,13 @@ void lb_build_switch_stmt(lbProcedure *p, AstSwitchStmt *ss, Scope *scope) {
 		lb_pop_target_list(p);
 
 		lb_emit_jump(p, done);
-		if (switch_instr == nullptr) {
+		if (!is_jump_table) {
 			lb_start_block(p, next_cond);
 		}
 	}
 
 	if (default_block != nullptr) {
-		if (switch_instr == nullptr) {
+		if (!is_jump_table) {
 			lb_emit_jump(p, default_block);
 		}
 		lb_start_block(p, default_block);
@@ -5245,11 +5477,11 @@ void lb_build_static_variables(lbProcedure *p, AstValueDecl *vd) {
 		if (vd->values.count > 0) {
 			GB_ASSERT(vd->names.count == vd->values.count);
 			Ast *ast_value = vd->values[i];
-			GB_ASSERT(ast_value->tav.mode == Addressing_Constant ||
-			          ast_value->tav.mode == Addressing_Invalid);
+			GB_ASSERT(ast_value->tav->mode == Addressing_Constant ||
+			          ast_value->tav->mode == Addressing_Invalid);
 
 			bool allow_local = false;
-			value = lb_const_value(p->module, ast_value->tav.type, ast_value->tav.value, allow_local);
+			value = lb_const_value(p->module, ast_value->tav->type, ast_value->tav->value, allow_local);
 		}
 
 		Ast *ident = vd->names[i];
@@ -5791,7 +6023,7 @@ void lb_build_assign_stmt(lbProcedure *p, AstAssignStmt *as) {
 	op_ += Token_Add - Token_AddEq; // Convert += to +
 	TokenKind op = cast(TokenKind)op_;
 	if (op == Token_CmpAnd || op == Token_CmpOr) {
-		Type *type = as->lhs[0]->tav.type;
+		Type *type = as->lhs[0]->tav->type;
 		lbValue new_value = lb_emit_logical_binary_expr(p, op, as->lhs[0], as->rhs[0], type);
 
 		lbAddr lhs = lb_build_addr(p, as->lhs[0]);
@@ -6076,7 +6308,77 @@ lbValue lb_emit_clamp(lbProcedure *p, Type *t, lbValue x, lbValue min, lbValue m
 
 
 
+// NOTE: The contents of a large '#load' are not made into an LLVM constant, as that copies the whole file
+// into LLVM and it is then folded and emitted like any other constant. Instead, the file is included directly
+// into the object file with `.incbin` in the module level assembly.
+// `shared` follows what the constant would have done: strings are shared within a module (see `const_strings`)
+// whereas each byte slice has its own copy, as the data is writable
+enum : isize {LB_LOAD_FILE_INCBIN_MIN_SIZE = 1<<16};
+
+LLVMValueRef lb_load_file_data_ptr(lbModule *m, String const &str, bool shared) {
+	if (str.len < LB_LOAD_FILE_INCBIN_MIN_SIZE || is_arch_wasm()) {
+		return nullptr;
+	}
+	LoadFileCache *cache = load_file_cache_from_data(m->info, str);
+	if (cache == nullptr || cache->file.handle == nullptr) {
+		// NOTE: Only a memory mapped file is a regular file which can be included again as it was read
+		return nullptr;
+	}
+	// NOTE: The assembler reads the file again, so it must not have changed since it was checked
+	char *c_path = alloc_cstring(heap_allocator(), cache->path);
+	bool unchanged = loaded_file_is_unchanged(c_path, &cache->file);
+	gb_free(heap_allocator(), c_path);
+	if (!unchanged) {
+		return nullptr;
+	}
+	if (shared) {
+		LLVMValueRef *found = map_get(&m->load_file_data_ptrs, hash_pointer(cache));
+		if (found != nullptr) {
+			return *found;
+		}
+	}
+
+	u32 id = cast(u32)gb_atomic32_fetch_add(&m->gen->global_array_index, 1);
+	char name[32] = {};
+	gb_snprintf(name, gb_size_of(name), "__odin_load_file_%x", id);
+
+	// NOTE: This is in `.data` as the constant strings it replaces are not read-only either
+	gbString s = gb_string_make(heap_allocator(), "");
+	defer (gb_string_free(s));
+	s = gb_string_append_fmt(s, ".data\n.p2align 4\n%s:\n.incbin \"", name);
+	for (isize i = 0; i < cache->path.len; i++) {
+		u8 c = cache->path[i];
+		if (c == '\\' || c == '"') {
+			s = gb_string_appendc(s, "\\");
+		}
+		s = gb_string_append_length(s, &c, 1);
+	}
+	// NOTE: Exactly as many bytes as were checked are included, and it is null terminated like every
+	// other constant string. The section is reset as later code may expect to still be in `.text`
+	s = gb_string_append_fmt(s, "\", 0, %td\n.byte 0\n.text\n", cache->data.len);
+	LLVMAppendModuleInlineAsm(m->mod, s, gb_string_length(s));
+
+	// NOTE: The leading \1 stops LLVM from adding a prefix to the name, so it is the same as the label above
+	char llvm_name[33] = {};
+	gb_snprintf(llvm_name, gb_size_of(llvm_name), "\1%s", name);
+	LLVMTypeRef type = LLVMArrayType(LLVMInt8TypeInContext(m->ctx), cast(unsigned)(cache->data.len+1));
+	LLVMValueRef global_data = LLVMAddGlobal(m->mod, type, llvm_name);
+	LLVMSetVisibility(global_data, LLVMHiddenVisibility);
+
+	LLVMValueRef indices[2] = {llvm_zero(m), llvm_zero(m)};
+	LLVMValueRef ptr = LLVMConstInBoundsGEP(global_data, indices, 2);
+	if (shared) {
+		map_set(&m->load_file_data_ptrs, hash_pointer(cache), ptr);
+	}
+	return ptr;
+}
+
 LLVMValueRef lb_find_or_add_entity_string_ptr(lbModule *m, String const &str) {
+	LLVMValueRef load_file_ptr = lb_load_file_data_ptr(m, str, true);
+	if (load_file_ptr != nullptr) {
+		return load_file_ptr;
+	}
+
 	StringHashKey key = string_hash_string(str);
 	LLVMValueRef *found = string_map_get(&m->const_strings, key);
 	if (found != nullptr) {
@@ -6123,30 +6425,32 @@ lbValue lb_find_or_add_entity_string(lbModule *m, String const &str) {
 }
 
 lbValue lb_find_or_add_entity_string_byte_slice(lbModule *m, String const &str) {
-	LLVMValueRef indices[2] = {llvm_zero(m), llvm_zero(m)};
-	LLVMValueRef data = LLVMConstStringInContext(m->ctx,
-		cast(char const *)str.text,
-		cast(unsigned)str.len,
-		false);
+	LLVMValueRef ptr = lb_load_file_data_ptr(m, str, false);
+	if (ptr == nullptr) {
+		LLVMValueRef indices[2] = {llvm_zero(m), llvm_zero(m)};
+		LLVMValueRef data = LLVMConstStringInContext(m->ctx,
+			cast(char const *)str.text,
+			cast(unsigned)str.len,
+			false);
 
 
-	char *name = nullptr;
-	{
-		isize max_len = 7+8+1;
-		name = gb_alloc_array(permanent_allocator(), char, max_len);
-		u32 id = cast(u32)gb_atomic32_fetch_add(&m->gen->global_array_index, 1);
-		isize len = gb_snprintf(name, max_len, "csbs$%x", id);
-		len -= 1;
-	}
-	LLVMValueRef global_data = LLVMAddGlobal(m->mod, LLVMTypeOf(data), name);
-	LLVMSetInitializer(global_data, data);
-	LLVMSetLinkage(global_data, LLVMInternalLinkage);
+		char *name = nullptr;
+		{
+			isize max_len = 7+8+1;
+			name = gb_alloc_array(permanent_allocator(), char, max_len);
+			u32 id = cast(u32)gb_atomic32_fetch_add(&m->gen->global_array_index, 1);
+			isize len = gb_snprintf(name, max_len, "csbs$%x", id);
+			len -= 1;
+		}
+		LLVMValueRef global_data = LLVMAddGlobal(m->mod, LLVMTypeOf(data), name);
+		LLVMSetInitializer(global_data, data);
+		LLVMSetLinkage(global_data, LLVMInternalLinkage);
 
-	LLVMValueRef ptr = nullptr;
-	if (str.len != 0) {
-		ptr = LLVMConstInBoundsGEP(global_data, indices, 2);
-	} else {
-		ptr = LLVMConstNull(lb_type(m, t_u8_ptr));
+		if (str.len != 0) {
+			ptr = LLVMConstInBoundsGEP(global_data, indices, 2);
+		} else {
+			ptr = LLVMConstNull(lb_type(m, t_u8_ptr));
+		}
 	}
 	LLVMValueRef len = LLVMConstInt(lb_type(m, t_int), str.len, true);
 	LLVMValueRef values[2] = {ptr, len};
@@ -6325,20 +6629,36 @@ lbValue lb_find_procedure_value_from_entity(lbModule *m, Entity *e) {
 	return {};
 }
 
-void lb_set_entity_from_other_modules_linkage_correctly(lbModule *other_module, Entity *e, String const &name) {
-	if (other_module == nullptr) {
+void lb_set_entity_from_other_modules_linkage_correctly(lbModule *m, lbModule *other_module, Entity *e, String const &name) {
+	if (other_module == nullptr || other_module == m) {
 		return;
 	}
-	char const *cname = alloc_cstring(temporary_allocator(), name);
+	// NOTE: The other module may be being generated on another thread,
+	// so record the correction and apply it once all procedures have been generated
+	lbEntityCorrection ec = {};
+	ec.other_module = other_module;
+	ec.e = e;
+	ec.cname = alloc_cstring(permanent_allocator(), name);
+	array_add(&m->entities_to_correct_linkage, ec);
+}
 
-	LLVMValueRef other_global = nullptr;
-	if (e->kind == Entity_Variable) {
-		other_global = LLVMGetNamedGlobal(other_module->mod, cname);
-	} else if (e->kind == Entity_Procedure) {
-		other_global = LLVMGetNamedFunction(other_module->mod, cname);
-	}
-	if (other_global) {
-		LLVMSetLinkage(other_global, LLVMExternalLinkage);
+void lb_correct_entity_linkage(lbGenerator *gen) {
+	for_array(j, gen->modules.entries) {
+		lbModule *m = gen->modules.entries[j].value;
+		for_array(i, m->entities_to_correct_linkage) {
+			lbEntityCorrection ec = m->entities_to_correct_linkage[i];
+
+			LLVMValueRef other_global = nullptr;
+			if (ec.e->kind == Entity_Variable) {
+				other_global = LLVMGetNamedGlobal(ec.other_module->mod, ec.cname);
+			} else if (ec.e->kind == Entity_Procedure) {
+				other_global = LLVMGetNamedFunction(ec.other_module->mod, ec.cname);
+			}
+			if (other_global) {
+				LLVMSetLinkage(other_global, LLVMExternalLinkage);
+			}
+		}
+		array_clear(&m->entities_to_correct_linkage);
 	}
 }
 
@@ -6382,7 +6702,7 @@ lbValue lb_find_value_from_entity(lbModule *m, Entity *e) {
 
 			LLVMSetLinkage(g.value, LLVMExternalLinkage);
 
-			lb_set_entity_from_other_modules_linkage_correctly(other_module, e, name);
+			lb_set_entity_from_other_modules_linkage_correctly(m, other_module, e, name);
 
 			// LLVMSetLinkage(other_g.value, LLVMExternalLinkage);
 
@@ -6430,15 +6750,23 @@ LLVMValueRef lb_big_int_to_llvm(lbModule *m, Type *original_type, BigInt const *
 	size_t nails = 0;
 	mp_endian endian = MP_LITTLE_ENDIAN;
 
-	max_count = mp_pack_count(a, nails, size);
-	GB_ASSERT_MSG(sz >= max_count, "max_count: %tu, sz: %tu, written: %tu", max_count, sz, written);
-	GB_ASSERT(gb_size_of(rop64) >= sz);
+	if (!big_int_is_big(a)) {
+		u64 v = cast(u64)(a->small < 0 ? -a->small : a->small);
+		for (; v != 0; v >>= 8) {
+			rop[max_count++] = cast(u8)v;
+		}
+		GB_ASSERT_MSG(sz >= max_count, "max_count: %tu, sz: %tu", max_count, sz);
+	} else {
+		max_count = mp_pack_count(&a->big, nails, size);
+		GB_ASSERT_MSG(sz >= max_count, "max_count: %tu, sz: %tu, written: %tu", max_count, sz, written);
+		GB_ASSERT(gb_size_of(rop64) >= sz);
 
-	mp_err err = mp_pack(rop, sz, &written,
-	                     MP_LSB_FIRST,
-	                     size, endian, nails,
-	                     a);
-	GB_ASSERT(err == MP_OKAY);
+		mp_err err = mp_pack(rop, sz, &written,
+		                     MP_LSB_FIRST,
+		                     size, endian, nails,
+		                     &a->big);
+		GB_ASSERT(err == MP_OKAY);
+	}
 
 	if (!is_type_endian_little(original_type)) {
 		for (size_t i = 0; i < sz/2; i++) {
@@ -6539,6 +6867,7 @@ lbValue lb_const_value(lbModule *m, Type *type, ExactValue value, bool allow_loc
 				Entity *e = alloc_entity_constant(nullptr, make_token_ident(name), t, value);
 				array_data = LLVMAddGlobal(m->mod, lb_type(m, t), str);
 				LLVMSetInitializer(array_data, backing_array.value);
+				LLVMSetLinkage(array_data, LLVMInternalLinkage);
 
 				lbValue g = {};
 				g.value = array_data;
@@ -6748,8 +7077,8 @@ lbValue lb_const_value(lbModule *m, Type *type, ExactValue value, bool allow_loc
 						ast_node(fv, FieldValue, elem);
 						if (is_ast_range(fv->field)) {
 							ast_node(ie, BinaryExpr, fv->field);
-							TypeAndValue lo_tav = ie->left->tav;
-							TypeAndValue hi_tav = ie->right->tav;
+							TypeAndValue lo_tav = *ie->left->tav;
+							TypeAndValue hi_tav = *ie->right->tav;
 							GB_ASSERT(lo_tav.mode == Addressing_Constant);
 							GB_ASSERT(hi_tav.mode == Addressing_Constant);
 
@@ -6760,7 +7089,7 @@ lbValue lb_const_value(lbModule *m, Type *type, ExactValue value, bool allow_loc
 								hi += 1;
 							}
 							if (lo == i) {
-								TypeAndValue tav = fv->value->tav;
+								TypeAndValue tav = *fv->value->tav;
 								LLVMValueRef val = lb_const_value(m, elem_type, tav.value, allow_local).value;
 								for (i64 k = lo; k < hi; k++) {
 									values[value_index++] = val;
@@ -6771,11 +7100,11 @@ lbValue lb_const_value(lbModule *m, Type *type, ExactValue value, bool allow_loc
 								break;
 							}
 						} else {
-							TypeAndValue index_tav = fv->field->tav;
+							TypeAndValue index_tav = *fv->field->tav;
 							GB_ASSERT(index_tav.mode == Addressing_Constant);
 							i64 index = exact_value_to_i64(index_tav.value);
 							if (index == i) {
-								TypeAndValue tav = fv->value->tav;
+								TypeAndValue tav = *fv->value->tav;
 								LLVMValueRef val = lb_const_value(m, elem_type, tav.value, allow_local).value;
 								values[value_index++] = val;
 								found = true;
@@ -6797,7 +7126,7 @@ lbValue lb_const_value(lbModule *m, Type *type, ExactValue value, bool allow_loc
 				LLVMValueRef *values = gb_alloc_array(temporary_allocator(), LLVMValueRef, cast(isize)type->Array.count);
 
 				for (isize i = 0; i < elem_count; i++) {
-					TypeAndValue tav = cl->elems[i]->tav;
+					TypeAndValue tav = *cl->elems[i]->tav;
 					GB_ASSERT(tav.mode != Addressing_Invalid);
 					values[i] = lb_const_value(m, elem_type, tav.value, allow_local).value;
 				}
@@ -6832,8 +7161,8 @@ lbValue lb_const_value(lbModule *m, Type *type, ExactValue value, bool allow_loc
 						ast_node(fv, FieldValue, elem);
 						if (is_ast_range(fv->field)) {
 							ast_node(ie, BinaryExpr, fv->field);
-							TypeAndValue lo_tav = ie->left->tav;
-							TypeAndValue hi_tav = ie->right->tav;
+							TypeAndValue lo_tav = *ie->left->tav;
+							TypeAndValue hi_tav = *ie->right->tav;
 							GB_ASSERT(lo_tav.mode == Addressing_Constant);
 							GB_ASSERT(hi_tav.mode == Addressing_Constant);
 
@@ -6844,7 +7173,7 @@ lbValue lb_const_value(lbModule *m, Type *type, ExactValue value, bool allow_loc
 								hi += 1;
 							}
 							if (lo == i) {
-								TypeAndValue tav = fv->value->tav;
+								TypeAndValue tav = *fv->value->tav;
 								LLVMValueRef val = lb_const_value(m, elem_type, tav.value, allow_local).value;
 								for (i64 k = lo; k < hi; k++) {
 									values[value_index++] = val;
@@ -6855,11 +7184,11 @@ lbValue lb_const_value(lbModule *m, Type *type, ExactValue value, bool allow_loc
 								break;
 							}
 						} else {
-							TypeAndValue index_tav = fv->field->tav;
+							TypeAndValue index_tav = *fv->field->tav;
 							GB_ASSERT(index_tav.mode == Addressing_Constant);
 							i64 index = exact_value_to_i64(index_tav.value);
 							if (index == i) {
-								TypeAndValue tav = fv->value->tav;
+								TypeAndValue tav = *fv->value->tav;
 								LLVMValueRef val = lb_const_value(m, elem_type, tav.value, allow_local).value;
 								values[value_index++] = val;
 								found = true;
@@ -6881,7 +7210,7 @@ lbValue lb_const_value(lbModule *m, Type *type, ExactValue value, bool allow_loc
 				LLVMValueRef *values = gb_alloc_array(temporary_allocator(), LLVMValueRef, cast(isize)type->EnumeratedArray.count);
 
 				for (isize i = 0; i < elem_count; i++) {
-					TypeAndValue tav = cl->elems[i]->tav;
+					TypeAndValue tav = *cl->elems[i]->tav;
 					GB_ASSERT(tav.mode != Addressing_Invalid);
 					values[i] = lb_const_value(m, elem_type, tav.value, allow_local).value;
 				}
@@ -6906,7 +7235,7 @@ lbValue lb_const_value(lbModule *m, Type *type, ExactValue value, bool allow_loc
 			LLVMValueRef *values = gb_alloc_array(temporary_allocator(), LLVMValueRef, total_elem_count);
 
 			for (isize i = 0; i < elem_count; i++) {
-				TypeAndValue tav = cl->elems[i]->tav;
+				TypeAndValue tav = *cl->elems[i]->tav;
 				GB_ASSERT(tav.mode != Addressing_Invalid);
 				values[i] = lb_const_value(m, elem_type, tav.value, allow_local).value;
 			}
@@ -6948,7 +7277,7 @@ lbValue lb_const_value(lbModule *m, Type *type, ExactValue value, bool allow_loc
 						ast_node(fv, FieldValue, cl->elems[i]);
 						String name = fv->field->Ident.token.string;
 
-						TypeAndValue tav = fv->value->tav;
+						TypeAndValue tav = *fv->value->tav;
 						GB_ASSERT(tav.mode != Addressing_Invalid);
 
 						Selection sel = lookup_field(type, name, false);
@@ -6961,7 +7290,7 @@ lbValue lb_const_value(lbModule *m, Type *type, ExactValue value, bool allow_loc
 				} else {
 					for_array(i, cl->elems) {
 						Entity *f = type->Struct.fields[i];
-						TypeAndValue tav = cl->elems[i]->tav;
+						TypeAndValue tav = *cl->elems[i]->tav;
 						ExactValue val = {};
 						if (tav.mode != Addressing_Invalid) {
 							val = tav.value;
@@ -7044,7 +7373,7 @@ lbValue lb_const_value(lbModule *m, Type *type, ExactValue value, bool allow_loc
 				Ast *e = cl->elems[i];
 				GB_ASSERT(e->kind != Ast_FieldValue);
 
-				TypeAndValue tav = e->tav;
+				TypeAndValue tav = *e->tav;
 				if (tav.mode != Addressing_Constant) {
 					continue;
 				}
@@ -7084,14 +7413,12 @@ lbValue lb_const_value(lbModule *m, Type *type, ExactValue value, bool allow_loc
 	return lb_const_nil(m, original_type);
 }
 
-lbValue lb_emit_source_code_location(lbProcedure *p, String const &procedure, TokenPos const &pos) {
-	lbModule *m = p->module;
-
+lbValue lb_const_source_code_location(lbModule *m, String const &procedure, TokenPos const &pos) {
 	LLVMValueRef fields[4] = {};
-	fields[0]/*file*/      = lb_find_or_add_entity_string(p->module, get_file_path_string(pos.file_id)).value;
+	fields[0]/*file*/      = lb_find_or_add_entity_string(m, get_file_path_string(pos.file_id)).value;
 	fields[1]/*line*/      = lb_const_int(m, t_i32, pos.line).value;
 	fields[2]/*column*/    = lb_const_int(m, t_i32, pos.column).value;
-	fields[3]/*procedure*/ = lb_find_or_add_entity_string(p->module, procedure).value;
+	fields[3]/*procedure*/ = lb_find_or_add_entity_string(m, procedure).value;
 
 	lbValue res = {};
 	res.value = llvm_const_named_struct(lb_type(m, t_source_code_location), fields, gb_count_of(fields));
@@ -7099,6 +7426,10 @@ lbValue lb_emit_source_code_location(lbProcedure *p, String const &procedure, To
 	return res;
 }
 
+lbValue lb_emit_source_code_location(lbProcedure *p, String const &procedure, TokenPos const &pos) {
+	return lb_const_source_code_location(p->module, procedure, pos);
+}
+
 lbValue lb_emit_source_code_location(lbProcedure *p, Ast *node) {
 	String proc_name = {};
 	if (p->entity) {
@@ -7789,12 +8120,12 @@ lbValue lb_build_binary_expr(lbProcedure *p, Ast *expr) {
 
 	case Token_CmpEq:
 	case Token_NotEq:
-		if (is_type_untyped_nil(be->right->tav.type)) {
+		if (is_type_untyped_nil(be->right->tav->type)) {
 			lbValue left = lb_build_expr(p, be->left);
 			lbValue cmp = lb_emit_comp_against_nil(p, be->op.kind, left);
 			Type *type = default_type(tv.type);
 			return lb_emit_conv(p, cmp, type);
-		} else if (is_type_untyped_nil(be->left->tav.type)) {
+		} else if (is_type_untyped_nil(be->left->tav->type)) {
 			lbValue right = lb_build_expr(p, be->right);
 			lbValue cmp = lb_emit_comp_against_nil(p, be->op.kind, right);
 			Type *type = default_type(tv.type);
@@ -7809,11 +8140,11 @@ lbValue lb_build_binary_expr(lbProcedure *p, Ast *expr) {
 			lbValue left = {};
 			lbValue right = {};
 
-			if (be->left->tav.mode == Addressing_Type) {
-				left = lb_typeid(p->module, be->left->tav.type);
+			if (be->left->tav->mode == Addressing_Type) {
+				left = lb_typeid(p->module, be->left->tav->type);
 			}
-			if (be->right->tav.mode == Addressing_Type) {
-				right = lb_typeid(p->module, be->right->tav.type);
+			if (be->right->tav->mode == Addressing_Type) {
+				right = lb_typeid(p->module, be->right->tav->type);
 			}
 			if (left.value == nullptr)  left  = lb_build_expr(p, be->left);
 			if (right.value == nullptr) right = lb_build_expr(p, be->right);
@@ -7842,14 +8173,7 @@ lbValue lb_build_binary_expr(lbProcedure *p, Ast *expr) {
 			case Type_Map:
 				{
 					lbValue addr = lb_address_from_load_or_generate_local(p, right);
-					lbValue h = lb_gen_map_header(p, addr, rt);
-					lbValue key = lb_gen_map_hash(p, left, rt->Map.key);
-
-					auto args = array_make<lbValue>(permanent_allocator(), 2);
-					args[0] = h;
-					args[1] = key;
-
-					lbValue ptr = lb_emit_runtime_call(p, "__dynamic_map_get", args);
+					lbValue ptr = lb_emit_map_get(p, addr, rt, left);
 					if (be->op.kind == Token_in) {
 						return lb_emit_conv(p, lb_emit_comp_against_nil(p, Token_NotEq, ptr), t_bool);
 					} else {
@@ -10355,8 +10679,8 @@ lbValue lb_build_builtin_proc(lbProcedure *p, Ast *expr, TypeAndValue const &tv,
 
 			bool is_inlinable = false;
 
-			if (ce->args[2]->tav.mode == Addressing_Constant) {
-				ExactValue ev = exact_value_to_integer(ce->args[2]->tav.value);
+			if (ce->args[2]->tav->mode == Addressing_Constant) {
+				ExactValue ev = exact_value_to_integer(ce->args[2]->tav->value);
 				i64 const_len = exact_value_to_i64(ev);
 				// TODO(bill): Determine when it is better to do the `*.inline` versions
 				if (const_len <= 4*build_context.word_size) {
@@ -10609,7 +10933,7 @@ lbValue lb_build_builtin_proc(lbProcedure *p, Ast *expr, TypeAndValue const &tv,
 	case BuiltinProc_atomic_cxchgweak_failacq:
 	case BuiltinProc_atomic_cxchgweak_acq_failrelaxed:
 	case BuiltinProc_atomic_cxchgweak_acqrel_failrelaxed: {
-		Type *type = expr->tav.type;
+		Type *type = expr->tav->type;
 
 		lbValue address = lb_build_expr(p, ce->args[0]);
 		Type *elem = type_deref(address.type);
@@ -10674,10 +10998,10 @@ lbValue lb_build_builtin_proc(lbProcedure *p, Ast *expr, TypeAndValue const &tv,
 
 
 	case BuiltinProc_type_equal_proc:
-		return lb_get_equal_proc_for_type(p->module, ce->args[0]->tav.type);
+		return lb_get_equal_proc_for_type(p->module, ce->args[0]->tav->type);
 
 	case BuiltinProc_type_hasher_proc:
-		return lb_get_hasher_proc_for_type(p->module, ce->args[0]->tav.type);
+		return lb_get_hasher_proc_for_type(p->module, ce->args[0]->tav->type);
 
 	case BuiltinProc_fixed_point_mul:
 	case BuiltinProc_fixed_point_div:
@@ -10841,8 +11165,8 @@ lbValue lb_build_call_expr_internal(lbProcedure *p, Ast *expr) {
 	// NOTE(bill): Regular call
 	lbValue value = {};
 	Ast *proc_expr = unparen_expr(ce->proc);
-	if (proc_expr->tav.mode == Addressing_Constant) {
-		ExactValue v = proc_expr->tav.value;
+	if (proc_expr->tav->mode == Addressing_Constant) {
+		ExactValue v = proc_expr->tav->value;
 		switch (v.kind) {
 		case ExactValue_Integer:
 			{
@@ -10851,7 +11175,7 @@ lbValue lb_build_call_expr_internal(lbProcedure *p, Ast *expr) {
 				x.value = LLVMConstInt(lb_type(m, t_uintptr), u, false);
 				x.type = t_uintptr;
 				x = lb_emit_conv(p, x, t_rawptr);
-				value = lb_emit_conv(p, x, proc_expr->tav.type);
+				value = lb_emit_conv(p, x, proc_expr->tav->type);
 				break;
 			}
 		case ExactValue_Pointer:
@@ -10861,7 +11185,7 @@ lbValue lb_build_call_expr_internal(lbProcedure *p, Ast *expr) {
 				x.value = LLVMConstInt(lb_type(m, t_uintptr), u, false);
 				x.type = t_uintptr;
 				x = lb_emit_conv(p, x, t_rawptr);
-				value = lb_emit_conv(p, x, proc_expr->tav.type);
+				value = lb_emit_conv(p, x, proc_expr->tav->type);
 				break;
 			}
 		}
@@ -11538,14 +11862,17 @@ lbValue lb_get_equal_proc_for_type(lbModule *m, Type *type) {
 		return {compare_proc->value, compare_proc->type};
 	}
 
-	static u32 proc_index = 0;
+	static std::atomic<u32> proc_index;
 
 	char buf[16] = {};
-	isize n = gb_snprintf(buf, 16, "__$equal%u", ++proc_index);
+	isize n = gb_snprintf(buf, 16, "__$equal%u", 1+proc_index.fetch_add(1, std::memory_order_relaxed));
 	char *str = gb_alloc_str_len(permanent_allocator(), buf, n-1);
 	String proc_name = make_string_c(str);
 
 	lbProcedure *p = lb_create_dummy_procedure(m, proc_name, t_equal_proc);
+	// NOTE: The name is only unique within this build, and so it must not clash with
+	// the same name in a cached object file from a previous build (-incremental)
+	LLVMSetLinkage(p->value, LLVMInternalLinkage);
 	map_set(&m->equal_procs, key, p);
 	lb_begin_procedure_body(p);
 
@@ -11694,14 +12021,17 @@ lbValue lb_get_hasher_proc_for_type(lbModule *m, Type *type) {
 		return {(*found)->value, (*found)->type};
 	}
 
-	static u32 proc_index = 0;
+	static std::atomic<u32> proc_index;
 
 	char buf[16] = {};
-	isize n = gb_snprintf(buf, 16, "__$hasher%u", ++proc_index);
+	isize n = gb_snprintf(buf, 16, "__$hasher%u", 1+proc_index.fetch_add(1, std::memory_order_relaxed));
 	char *str = gb_alloc_str_len(permanent_allocator(), buf, n-1);
 	String proc_name = make_string_c(str);
 
 	lbProcedure *p = lb_create_dummy_procedure(m, proc_name, t_hasher_proc);
+	// NOTE: The name is only unique within this build, and so it must not clash with
+	// the same name in a cached object file from a previous build (-incremental)
+	LLVMSetLinkage(p->value, LLVMInternalLinkage);
 	map_set(&m->hasher_procs, key, p);
 	lb_begin_procedure_body(p);
 	defer (lb_end_procedure_body(p));
@@ -12207,6 +12537,9 @@ lbValue lb_emit_comp(lbProcedure *p, TokenKind op_kind, lbValue left, lbValue ri
 
 
 lbValue lb_generate_anonymous_proc_lit(lbModule *m, String const &prefix_name, Ast *expr, lbProcedure *parent) {
+	mutex_lock(&m->gen->anonymous_proc_lits_mutex);
+	defer (mutex_unlock(&m->gen->anonymous_proc_lits_mutex));
+
 	lbProcedure **found = map_get(&m->gen->anonymous_proc_lits, hash_pointer(expr));
 	if (found) {
 		return lb_find_procedure_value_from_entity(m, (*found)->entity);
@@ -12216,11 +12549,20 @@ lbValue lb_generate_anonymous_proc_lit(lbModule *m, String const &prefix_name, A
 
 	// NOTE(bill): Generate a new name
 	// parent$count
-	isize name_len = prefix_name.len + 1 + 8 + 1;
+	isize name_len = prefix_name.len + 6 + 16 + 1;
 	char *name_text = gb_alloc_array(permanent_allocator(), char, name_len);
-	i32 name_id = cast(i32)m->gen->anonymous_proc_lits.entries.count;
-
-	name_len = gb_snprintf(name_text, name_len, "%.*s$anon-%d", LIT(prefix_name), name_id);
+	// NOTE: Modules may be generated at once, so the id must not depend upon the order in which they are.
+	// It is counted per parent procedure, otherwise it is made from where the literal is
+	if (parent != nullptr) {
+		i32 name_id = cast(i32)parent->children.count;
+		name_len = gb_snprintf(name_text, name_len, "%.*s$anon-%d", LIT(prefix_name), name_id);
+	} else {
+		TokenPos pos = ast_token(expr).pos;
+		String path = get_file_path_string(pos.file_id);
+		u64 name_id = fnv64a(path.text, path.len);
+		name_id = fnv64a(&pos.offset, gb_size_of(pos.offset)) ^ (name_id*0x100000001b3ull);
+		name_len = gb_snprintf(name_text, name_len, "%.*s$anon-%016llx", LIT(prefix_name), cast(unsigned long long)name_id);
+	}
 	String name = make_string((u8 *)name_text, name_len-1);
 
 	Type *type = type_of_expr(expr);
@@ -12473,7 +12815,7 @@ lbValue lb_find_ident(lbProcedure *p, lbModule *m, Entity *e, Ast *expr) {
 
 			String name = lb_get_entity_name(other_module, e);
 
-			lb_set_entity_from_other_modules_linkage_correctly(other_module, e, name);
+			lb_set_entity_from_other_modules_linkage_correctly(m, other_module, e, name);
 
 			lbValue g = {};
 			g.value = LLVMAddGlobal(m->mod, lb_type(m, e->type), alloc_cstring(permanent_allocator(), name));
@@ -12497,7 +12839,7 @@ lbValue lb_find_ident(lbProcedure *p, lbModule *m, Entity *e, Ast *expr) {
 
 bool lb_is_expr_constant_zero(Ast *expr) {
 	GB_ASSERT(expr != nullptr);
-	auto v = exact_value_to_integer(expr->tav.value);
+	auto v = exact_value_to_integer(expr->tav->value);
 	if (v.kind == ExactValue_Integer) {
 		return big_int_cmp_zero(&v.value_integer) == 0;
 	}
@@ -13143,6 +13485,20 @@ lbValue lb_const_hash(lbModule *m, lbValue key, Type *key_type) {
 	return hashed_key;
 }
 
+// NOTE: `key` must already be converted to `key_type` and `key_ptr` must point to it
+lbValue lb_gen_map_key_hash(lbProcedure *p, lbValue key, Type *key_type, lbValue key_ptr) {
+	lbValue hashed_key = lb_const_hash(p->module, key, key_type);
+	if (hashed_key.value == nullptr) {
+		lbValue hasher = lb_get_hasher_proc_for_type(p->module, key_type);
+
+		auto args = array_make<lbValue>(permanent_allocator(), 2);
+		args[0] = key_ptr;
+		args[1] = lb_const_int(p->module, t_uintptr, 0);
+		hashed_key = lb_emit_call(p, hasher, args);
+	}
+	return hashed_key;
+}
+
 lbValue lb_gen_map_hash(lbProcedure *p, lbValue key, Type *key_type) {
 	Type *hash_type = t_u64;
 	lbAddr v = lb_add_local_generated(p, t_map_hash, true);
@@ -13153,15 +13509,7 @@ lbValue lb_gen_map_hash(lbProcedure *p, lbValue key, Type *key_type) {
 	lbValue key_ptr = lb_address_from_load_or_generate_local(p, key);
 	key_ptr = lb_emit_conv(p, key_ptr, t_rawptr);
 
-	lbValue hashed_key = lb_const_hash(p->module, key, key_type);
-	if (hashed_key.value == nullptr) {
-		lbValue hasher = lb_get_hasher_proc_for_type(p->module, key_type);
-
-		auto args = array_make<lbValue>(permanent_allocator(), 2);
-		args[0] = key_ptr;
-		args[1] = lb_const_int(p->module, t_uintptr, 0);
-		hashed_key = lb_emit_call(p, hasher, args);
-	}
+	lbValue hashed_key = lb_gen_map_key_hash(p, key, key_type, key_ptr);
 
 	lb_emit_store(p, lb_emit_struct_ep(p, vp, 0), hashed_key);
 	lb_emit_store(p, lb_emit_struct_ep(p, vp, 1), key_ptr);
@@ -13169,6 +13517,127 @@ lbValue lb_gen_map_hash(lbProcedure *p, lbValue key, Type *key_type) {
 	return lb_addr_load(p, v);
 }
 
+// NOTE: Keys which are equal if and only if their bits are equal, and so can be compared in place
+bool lb_is_map_key_simple(Type *key_type) {
+	Type *t = core_type(base_enum_type(key_type)); // NOTE: An enum key is compared as its backing integer
+	if (is_type_integer(t) || is_type_pointer(t) || is_type_typeid(t)) {
+		return true;
+	}
+	return false;
+}
+
+// NOTE: The same lookup as `__dynamic_map_get` but for a single map type, so the keys are compared in place
+// rather than through the procedures in the `Map_Header`. The caller passes the hash of the key, as with
+// `Map_Hash`, so a constant key is hashed at compile time (see `lb_gen_map_key_hash`)
+lbValue lb_get_map_get_proc_for_type(lbModule *m, Type *map_type) {
+	map_type = base_type(map_type);
+	GB_ASSERT(map_type->kind == Type_Map);
+	Type *key_type = map_type->Map.key;
+	GB_ASSERT(lb_is_map_key_simple(key_type));
+
+	auto key = hash_type(map_type);
+	lbProcedure **found = map_get(&m->map_get_procs, key);
+	if (found) {
+		GB_ASSERT(*found != nullptr);
+		return {(*found)->value, (*found)->type};
+	}
+
+	static std::atomic<u32> proc_index;
+
+	char buf[16] = {};
+	isize n = gb_snprintf(buf, 16, "__$map_get%u", 1+proc_index.fetch_add(1, std::memory_order_relaxed));
+	char *str = gb_alloc_str_len(permanent_allocator(), buf, n-1);
+	String proc_name = make_string_c(str);
+
+	lbProcedure *p = lb_create_dummy_procedure(m, proc_name, t_map_get_proc);
+	// NOTE: The name is only unique within this build, and so it must not clash with
+	// the same name in a cached object file from a previous build (-incremental)
+	LLVMSetLinkage(p->value, LLVMInternalLinkage);
+	map_set(&m->map_get_procs, key, p);
+	lb_begin_procedure_body(p);
+	defer (lb_end_procedure_body(p));
+
+	LLVMAttributeRef nonnull_attr = lb_create_enum_attribute(m->ctx, "nonnull");
+	LLVMAddAttributeAtIndex(p->value, 1+0, nonnull_attr);
+	LLVMAddAttributeAtIndex(p->value, 1+1, nonnull_attr);
+
+	Type *raw_map_ptr = alloc_type_pointer(map_type->Map.internal_type);
+	lbValue raw_map = lb_emit_conv(p, {LLVMGetParam(p->value, 0), t_rawptr}, raw_map_ptr);
+	lbValue key_ptr = {LLVMGetParam(p->value, 1), t_rawptr};
+	lbValue hash    = {LLVMGetParam(p->value, 2), t_uintptr};
+
+	lbBlock *block_find    = lb_create_block(p, "map.find");
+	lbBlock *block_loop    = lb_create_block(p, "map.loop");
+	lbBlock *block_entry   = lb_create_block(p, "map.entry");
+	lbBlock *block_key     = lb_create_block(p, "map.key");
+	lbBlock *block_next    = lb_create_block(p, "map.next");
+	lbBlock *block_found   = lb_create_block(p, "map.found");
+	lbBlock *block_missing = lb_create_block(p, "map.missing");
+
+	lbValue hashes = lb_emit_load(p, lb_emit_struct_ep(p, raw_map, 0));
+	lbValue hash_count = lb_emit_conv(p, lb_slice_len(p, hashes), t_uintptr);
+	lbValue zero = lb_const_int(m, t_uintptr, 0);
+	lb_emit_if(p, lb_emit_comp(p, Token_NotEq, hash_count, zero), block_find, block_missing);
+
+	lb_start_block(p, block_find);
+	lbValue key_value = lb_emit_load(p, lb_emit_conv(p, key_ptr, alloc_type_pointer(key_type)));
+
+	lbValue hash_index = lb_emit_arith(p, Token_Mod, hash, hash_count, t_uintptr);
+	lbValue entries = lb_dynamic_array_elem(p, lb_emit_load(p, lb_emit_struct_ep(p, raw_map, 1)));
+	lbAddr entry_index = lb_add_local_generated(p, t_int, false);
+	lb_addr_store(p, entry_index, lb_emit_load(p, lb_emit_ptr_offset(p, lb_slice_elem(p, hashes), hash_index)));
+	lb_emit_jump(p, block_loop);
+
+	lb_start_block(p, block_loop);
+	lbValue index = lb_addr_load(p, entry_index);
+	lb_emit_if(p, lb_emit_comp(p, Token_GtEq, index, lb_const_int(m, t_int, 0)), block_entry, block_missing);
+
+	lb_start_block(p, block_entry);
+	lbValue entry = lb_emit_ptr_offset(p, entries, index);
+	lbValue entry_hash = lb_emit_load(p, lb_emit_struct_ep(p, entry, 0));
+	lb_emit_if(p, lb_emit_comp(p, Token_CmpEq, entry_hash, hash), block_key, block_next);
+
+	lb_start_block(p, block_key);
+	lbValue entry_key = lb_emit_load(p, lb_emit_struct_ep(p, entry, 2));
+	lb_emit_if(p, lb_emit_comp(p, Token_CmpEq, entry_key, key_value), block_found, block_next);
+
+	lb_start_block(p, block_next);
+	lb_addr_store(p, entry_index, lb_emit_load(p, lb_emit_struct_ep(p, entry, 1)));
+	lb_emit_jump(p, block_loop);
+
+	lb_start_block(p, block_found);
+	lbValue value_ptr = lb_emit_conv(p, lb_emit_struct_ep(p, entry, 3), t_rawptr);
+	LLVMBuildRet(p->builder, value_ptr.value);
+
+	lb_start_block(p, block_missing);
+	LLVMBuildRet(p->builder, LLVMConstNull(lb_type(m, t_rawptr)));
+
+	return {p->value, p->type};
+}
+
+// NOTE: Returns a pointer to the value of `key` or `nil`
+lbValue lb_emit_map_get(lbProcedure *p, lbValue map_ptr, Type *map_type, lbValue key) {
+	map_type = base_type(map_type);
+	GB_ASSERT(map_type->kind == Type_Map);
+	Type *key_type = map_type->Map.key;
+
+	if (lb_is_map_key_simple(key_type)) {
+		key = lb_emit_conv(p, key, key_type);
+		lbValue key_ptr = lb_emit_conv(p, lb_address_from_load_or_generate_local(p, key), t_rawptr);
+
+		auto args = array_make<lbValue>(permanent_allocator(), 3);
+		args[0] = lb_emit_conv(p, map_ptr, t_rawptr);
+		args[1] = key_ptr;
+		args[2] = lb_gen_map_key_hash(p, key, key_type, key_ptr);
+		return lb_emit_call(p, lb_get_map_get_proc_for_type(p->module, map_type), args);
+	}
+
+	auto args = array_make<lbValue>(permanent_allocator(), 2);
+	args[0] = lb_gen_map_header(p, map_ptr, map_type);
+	args[1] = lb_gen_map_hash(p, key, key_type);
+	return lb_emit_runtime_call(p, "__dynamic_map_get", args);
+}
+
 void lb_insert_dynamic_map_key_and_value(lbProcedure *p, lbAddr addr, Type *map_type,
                                          lbValue map_key, lbValue map_value, Ast *node) {
 	map_type = base_type(map_type);
@@ -13255,8 +13724,8 @@ lbAddr lb_build_addr(lbProcedure *p, Ast *expr) {
 					a = lb_addr_get_ptr(p, addr);
 				}
 
-				GB_ASSERT(is_type_array(expr->tav.type));
-				return lb_addr_swizzle(a, expr->tav.type, swizzle_count, swizzle_indices);
+				GB_ASSERT(is_type_array(expr->tav->type));
+				return lb_addr_swizzle(a, expr->tav->type, swizzle_count, swizzle_indices);
 			}
 
 			Selection sel = lookup_field(type, selector, false);
@@ -13377,7 +13846,7 @@ lbAddr lb_build_addr(lbProcedure *p, Ast *expr) {
 			return lb_addr_soa_variable(val, index, ie->index);
 		}
 
-		if (ie->expr->tav.mode == Addressing_SoaVariable) {
+		if (ie->expr->tav->mode == Addressing_SoaVariable) {
 			// SOA Structures for slices/dynamic arrays
 			GB_ASSERT(is_type_pointer(type_of_expr(ie->expr)));
 
@@ -13853,8 +14322,8 @@ lbAddr lb_build_addr(lbProcedure *p, Ast *expr) {
 						}
 						if (is_ast_range(fv->field)) {
 							ast_node(ie, BinaryExpr, fv->field);
-							TypeAndValue lo_tav = ie->left->tav;
-							TypeAndValue hi_tav = ie->right->tav;
+							TypeAndValue lo_tav = *ie->left->tav;
+							TypeAndValue hi_tav = *ie->right->tav;
 							GB_ASSERT(lo_tav.mode == Addressing_Constant);
 							GB_ASSERT(hi_tav.mode == Addressing_Constant);
 
@@ -13875,7 +14344,7 @@ lbAddr lb_build_addr(lbProcedure *p, Ast *expr) {
 							}
 
 						} else {
-							auto tav = fv->field->tav;
+							auto tav = *fv->field->tav;
 							GB_ASSERT(tav.mode == Addressing_Constant);
 							i64 index = exact_value_to_i64(tav.value);
 
@@ -13946,8 +14415,8 @@ lbAddr lb_build_addr(lbProcedure *p, Ast *expr) {
 						}
 						if (is_ast_range(fv->field)) {
 							ast_node(ie, BinaryExpr, fv->field);
-							TypeAndValue lo_tav = ie->left->tav;
-							TypeAndValue hi_tav = ie->right->tav;
+							TypeAndValue lo_tav = *ie->left->tav;
+							TypeAndValue hi_tav = *ie->right->tav;
 							GB_ASSERT(lo_tav.mode == Addressing_Constant);
 							GB_ASSERT(hi_tav.mode == Addressing_Constant);
 
@@ -13968,7 +14437,7 @@ lbAddr lb_build_addr(lbProcedure *p, Ast *expr) {
 							}
 
 						} else {
-							auto tav = fv->field->tav;
+							auto tav = *fv->field->tav;
 							GB_ASSERT(tav.mode == Addressing_Constant);
 							i64 index = exact_value_to_i64(tav.value);
 
@@ -14049,8 +14518,8 @@ lbAddr lb_build_addr(lbProcedure *p, Ast *expr) {
 
 						if (is_ast_range(fv->field)) {
 							ast_node(ie, BinaryExpr, fv->field);
-							TypeAndValue lo_tav = ie->left->tav;
-							TypeAndValue hi_tav = ie->right->tav;
+							TypeAndValue lo_tav = *ie->left->tav;
+							TypeAndValue hi_tav = *ie->right->tav;
 							GB_ASSERT(lo_tav.mode == Addressing_Constant);
 							GB_ASSERT(hi_tav.mode == Addressing_Constant);
 
@@ -14071,8 +14540,8 @@ lbAddr lb_build_addr(lbProcedure *p, Ast *expr) {
 							}
 
 						} else {
-							GB_ASSERT(fv->field->tav.mode == Addressing_Constant);
-							i64 index = exact_value_to_i64(fv->field->tav.value);
+							GB_ASSERT(fv->field->tav->mode == Addressing_Constant);
+							i64 index = exact_value_to_i64(fv->field->tav->value);
 
 							lbValue field_expr = lb_build_expr(p, fv->value);
 							GB_ASSERT(!is_type_tuple(field_expr.type));
@@ -14153,8 +14622,8 @@ lbAddr lb_build_addr(lbProcedure *p, Ast *expr) {
 					ast_node(fv, FieldValue, elem);
 					if (is_ast_range(fv->field)) {
 						ast_node(ie, BinaryExpr, fv->field);
-						TypeAndValue lo_tav = ie->left->tav;
-						TypeAndValue hi_tav = ie->right->tav;
+						TypeAndValue lo_tav = *ie->left->tav;
+						TypeAndValue hi_tav = *ie->right->tav;
 						GB_ASSERT(lo_tav.mode == Addressing_Constant);
 						GB_ASSERT(hi_tav.mode == Addressing_Constant);
 
@@ -14172,9 +14641,9 @@ lbAddr lb_build_addr(lbProcedure *p, Ast *expr) {
 							lb_emit_store(p, ep, value);
 						}
 					} else {
-						GB_ASSERT(fv->field->tav.mode == Addressing_Constant);
+						GB_ASSERT(fv->field->tav->mode == Addressing_Constant);
 
-						i64 field_index = exact_value_to_i64(fv->field->tav.value);
+						i64 field_index = exact_value_to_i64(fv->field->tav->value);
 
 						lbValue ev = lb_build_expr(p, fv->value);
 						lbValue value = lb_emit_conv(p, ev, et);
@@ -14365,17 +14834,22 @@ void lb_init_module(lbModule *m, Checker *c) {
 	map_init(&m->procedure_values, a);
 	string_map_init(&m->procedures, a);
 	string_map_init(&m->const_strings, a);
+	map_init(&m->load_file_data_ptrs, a);
 	map_init(&m->anonymous_proc_lits, a);
 	map_init(&m->function_type_map, a);
 	map_init(&m->equal_procs, a);
 	map_init(&m->hasher_procs, a);
+	map_init(&m->map_get_procs, a);
 	array_init(&m->procedures_to_generate, a, 0, 1024);
 	array_init(&m->foreign_library_paths,  a, 0, 1024);
 	array_init(&m->missing_procedures_to_check, a, 0, 16);
 
 	map_init(&m->debug_values, a);
+	map_init(&m->debug_canonical_types, a);
 	array_init(&m->debug_incomplete_types, a, 0, 1024);
 
+	array_init(&m->entities_to_correct_linkage, a, 0, 0);
+
 }
 
 
@@ -14430,6 +14904,11 @@ bool lb_init_generator(lbGenerator *gen, Checker *c) {
 	map_init(&gen->anonymous_proc_lits, heap_allocator(), 1024);
 
 	gb_mutex_init(&gen->mutex);
+	mutex_init(&gen->anonymous_proc_lits_mutex);
+
+	if (build_context.incremental) {
+		lb_cache_init();
+	}
 
 	if (USE_SEPARATE_MODULES) {
 		for_array(i, gen->info->packages.entries) {
@@ -14474,6 +14953,7 @@ lbAddr lb_add_global_generated(lbModule *m, Type *type, lbValue value) {
 	lbValue g = {};
 	g.type = alloc_type_pointer(type);
 	g.value = LLVMAddGlobal(m->mod, lb_type(m, type), cast(char const *)str);
+	LLVMSetLinkage(g.value, LLVMInternalLinkage);
 	if (value.value != nullptr) {
 		GB_ASSERT_MSG(LLVMIsConstant(value.value), LLVMPrintValueToString(value.value));
 		LLVMSetInitializer(g.value, value.value);
@@ -14513,35 +14993,76 @@ lbValue lb_get_type_info_ptr(lbModule *m, Type *type) {
 }
 
 
-lbValue lb_type_info_member_types_offset(lbProcedure *p, isize count) {
-	GB_ASSERT(p->module == &p->module->gen->default_module);
-	lbValue offset = lb_emit_array_epi(p, lb_global_type_info_member_types.addr, lb_global_type_info_member_types_index);
-	lb_global_type_info_member_types_index += cast(i32)count;
-	return offset;
-}
-lbValue lb_type_info_member_names_offset(lbProcedure *p, isize count) {
-	GB_ASSERT(p->module == &p->module->gen->default_module);
-	lbValue offset = lb_emit_array_epi(p, lb_global_type_info_member_names.addr, lb_global_type_info_member_names_index);
-	lb_global_type_info_member_names_index += cast(i32)count;
+// NOTE: Returns a constant pointer to the next 'count' elements of the member array
+// and the slots of their constant initializers in 'values_'
+lbValue lb_type_info_member_array_offset(lbModule *m, lbTypeInfoMemberArray *array, isize count, LLVMValueRef **values_) {
+	GB_ASSERT(m == &m->gen->default_module);
+	Type *array_type = type_deref(array->addr.addr.type);
+	GB_ASSERT(array->index+count <= array_type->Array.count);
+
+	LLVMValueRef indices[2] = {
+		llvm_zero(m),
+		LLVMConstInt(lb_type(m, t_int), cast(unsigned long long)array->index, false),
+	};
+	lbValue offset = {};
+	offset.value = LLVMConstInBoundsGEP(array->addr.addr.value, indices, gb_count_of(indices));
+	offset.type = alloc_type_pointer(array_type->Array.elem);
+
+	*values_ = array->values + array->index;
+	array->index += count;
 	return offset;
 }
-lbValue lb_type_info_member_offsets_offset(lbProcedure *p, isize count) {
-	GB_ASSERT(p->module == &p->module->gen->default_module);
-	lbValue offset = lb_emit_array_epi(p, lb_global_type_info_member_offsets.addr, lb_global_type_info_member_offsets_index);
-	lb_global_type_info_member_offsets_index += cast(i32)count;
-	return offset;
+
+void lb_type_info_member_array_init(lbTypeInfoMemberArray *array) {
+	if (array->addr.addr.value != nullptr) {
+		Type *array_type = type_deref(array->addr.addr.type);
+		array->values = gb_alloc_array(heap_allocator(), LLVMValueRef, array_type->Array.count);
+	}
 }
-lbValue lb_type_info_member_usings_offset(lbProcedure *p, isize count) {
-	GB_ASSERT(p->module == &p->module->gen->default_module);
-	lbValue offset = lb_emit_array_epi(p, lb_global_type_info_member_usings.addr, lb_global_type_info_member_usings_index);
-	lb_global_type_info_member_usings_index += cast(i32)count;
-	return offset;
+
+void lb_type_info_member_array_set_initializer(lbModule *m, lbTypeInfoMemberArray *array) {
+	if (array->addr.addr.value == nullptr) {
+		return;
+	}
+	Type *array_type = type_deref(array->addr.addr.type);
+	LLVMTypeRef elem_type = lb_type(m, array_type->Array.elem);
+	for (i64 i = 0; i < array_type->Array.count; i++) {
+		if (array->values[i] == nullptr) {
+			array->values[i] = LLVMConstNull(elem_type);
+		}
+	}
+	LLVMValueRef init = llvm_const_array(elem_type, array->values, array_type->Array.count);
+	LLVMSetInitializer(array->addr.addr.value, init);
+	LLVMSetGlobalConstant(array->addr.addr.value, true);
+
+	gb_free(heap_allocator(), array->values);
+	array->values = nullptr;
 }
-lbValue lb_type_info_member_tags_offset(lbProcedure *p, isize count) {
-	GB_ASSERT(p->module == &p->module->gen->default_module);
-	lbValue offset = lb_emit_array_epi(p, lb_global_type_info_member_tags.addr, lb_global_type_info_member_tags_index);
-	lb_global_type_info_member_tags_index += cast(i32)count;
-	return offset;
+
+// NOTE: The variant union of a Type_Info with a specific variant, as a literal struct
+// with the same layout as the union: {alignment prefix, variant, padding, tag}
+LLVMValueRef lb_const_type_info_variant(lbModule *m, Type *variant_type, LLVMValueRef variant_value) {
+	Type *ut = base_type(get_struct_field_type(t_type_info, 4));
+	GB_ASSERT(ut->kind == Type_Union);
+	GB_ASSERT(!is_type_union_maybe_pointer(ut));
+
+	i64 block_size   = ut->Union.variant_block_size;
+	i64 variant_size = type_size_of(variant_type);
+	GB_ASSERT(variant_size <= block_size);
+
+	if (variant_value == nullptr) {
+		variant_value = LLVMConstNull(lb_type(m, variant_type));
+	}
+
+	LLVMValueRef fields[4] = {};
+	unsigned field_count = 0;
+	fields[field_count++] = LLVMConstNull(lb_alignment_prefix_type_hack(m, type_align_of(ut)));
+	fields[field_count++] = variant_value;
+	if (variant_size < block_size) {
+		fields[field_count++] = LLVMConstNull(LLVMArrayType(lb_type(m, t_u8), cast(unsigned)(block_size - variant_size)));
+	}
+	fields[field_count++] = lb_const_union_tag(m, ut, variant_type).value;
+	return LLVMConstStructInContext(m->ctx, fields, field_count, false);
 }
 
 lbValue lb_generate_local_array(lbProcedure *p, Type *elem_type, i64 count, bool zero_init) {
@@ -14549,6 +15070,17 @@ lbValue lb_generate_local_array(lbProcedure *p, Type *elem_type, i64 count, bool
 	return lb_addr_get_ptr(p, addr);
 }
 
+lbValue lb_const_array_elem(lbModule *m, lbValue array_ptr) {
+	Type *t = type_deref(array_ptr.type);
+	GB_ASSERT(is_type_array(t));
+	LLVMValueRef indices[2] = {llvm_zero(m), llvm_zero(m)};
+
+	lbValue res = {};
+	res.value = LLVMConstInBoundsGEP(array_ptr.value, indices, gb_count_of(indices));
+	res.type = alloc_type_pointer(t->Array.elem);
+	return res;
+}
+
 lbValue lb_generate_global_array(lbModule *m, Type *elem_type, i64 count, String prefix, i64 id) {
 	Token token = {Token_Ident};
 	isize name_len = prefix.len + 1 + 20;
@@ -14572,8 +15104,7 @@ lbValue lb_generate_global_array(lbModule *m, Type *elem_type, i64 count, String
 }
 
 
-void lb_setup_type_info_data(lbProcedure *p) { // NOTE(bill): Setup type_info data
-	lbModule *m = p->module;
+void lb_setup_type_info_data(lbModule *m) { // NOTE: Setup type_info data
 	LLVMContextRef ctx = m->ctx;
 	CheckerInfo *info = m->info;
 
@@ -14601,9 +15132,16 @@ void lb_setup_type_info_data(lbProcedure *p) { // NOTE(bill): Setup type_info da
 	Type *t_type_info_flags = type_info_flags_entity->type;
 
 
-	i32 type_info_member_types_index = 0;
-	i32 type_info_member_names_index = 0;
-	i32 type_info_member_offsets_index = 0;
+	lb_type_info_member_array_init(&lb_global_type_info_member_types);
+	lb_type_info_member_array_init(&lb_global_type_info_member_names);
+	lb_type_info_member_array_init(&lb_global_type_info_member_offsets);
+	lb_type_info_member_array_init(&lb_global_type_info_member_usings);
+	lb_type_info_member_array_init(&lb_global_type_info_member_tags);
+
+	// NOTE: The whole table is built as constants, so no code is run at startup to set it up
+	isize entry_count = base_type(lb_global_type_info_data_entity->type)->Array.count;
+	LLVMValueRef *entries = gb_alloc_array(heap_allocator(), LLVMValueRef, entry_count);
+	defer (gb_free(heap_allocator(), entries));
 
 	for_array(type_info_type_index, info->type_info_types) {
 		Type *t = info->type_info_types[type_info_type_index];
@@ -14616,21 +15154,17 @@ void lb_setup_type_info_data(lbProcedure *p) { // NOTE(bill): Setup type_info da
 			continue;
 		}
 
-		lbValue tag = {};
-		lbValue ti_ptr = lb_emit_array_epi(p, lb_global_type_info_data_ptr(m), cast(i32)entry_index);
-		lbValue variant_ptr = lb_emit_struct_ep(p, ti_ptr, 4);
+		// NOTE: Computing the size also sets the layout (e.g. the union block size) used below
+		i64 size  = type_size_of(t);
+		i64 align = type_align_of(t);
 
-		lbValue type_info_flags = lb_const_int(p->module, t_type_info_flags, type_info_flags_of_type(t));
-
-		lb_emit_store(p, lb_emit_struct_ep(p, ti_ptr, 0), lb_const_int(m, t_int, type_size_of(t)));
-		lb_emit_store(p, lb_emit_struct_ep(p, ti_ptr, 1), lb_const_int(m, t_int, type_align_of(t)));
-		lb_emit_store(p, lb_emit_struct_ep(p, ti_ptr, 2), type_info_flags);
-		lb_emit_store(p, lb_emit_struct_ep(p, ti_ptr, 3), lb_typeid(m, t));
+		Type *tag_type = nullptr;
+		LLVMValueRef variant_value = nullptr;
 
 
 		switch (t->kind) {
 		case Type_Named: {
-			tag = lb_const_ptr_cast(m, variant_ptr, t_type_info_named_ptr);
+			tag_type = t_type_info_named;
 
 			LLVMValueRef pkg_name = nullptr;
 			if (t->Named.type_name->pkg) {
@@ -14648,19 +15182,19 @@ void lb_setup_type_info_data(lbProcedure *p) { // NOTE(bill): Setup type_info da
 			}
 			TokenPos pos = t->Named.type_name->token.pos;
 
-			lbValue loc = lb_emit_source_code_location(p, proc_name, pos);
+			lbValue loc = lb_const_source_code_location(m, proc_name, pos);
 
 			LLVMValueRef vals[4] = {
-				lb_const_string(p->module, t->Named.type_name->token.string).value,
+				lb_const_string(m, t->Named.type_name->token.string).value,
 				lb_get_type_info_ptr(m, t->Named.base).value,
 				pkg_name,
 				loc.value
 			};
 
 			lbValue res = {};
-			res.type = type_deref(tag.type);
+			res.type = tag_type;
 			res.value = llvm_const_named_struct(lb_type(m, res.type), vals, gb_count_of(vals));
-			lb_emit_store(p, tag, res);
+			variant_value = res.value;
 			break;
 		}
 
@@ -14671,7 +15205,7 @@ void lb_setup_type_info_data(lbProcedure *p) { // NOTE(bill): Setup type_info da
 			case Basic_b16:
 			case Basic_b32:
 			case Basic_b64:
-				tag = lb_const_ptr_cast(m, variant_ptr, t_type_info_boolean_ptr);
+				tag_type = t_type_info_boolean;
 				break;
 
 			case Basic_i8:
@@ -14705,7 +15239,7 @@ void lb_setup_type_info_data(lbProcedure *p) { // NOTE(bill): Setup type_info da
 			case Basic_int:
 			case Basic_uint:
 			case Basic_uintptr: {
-				tag = lb_const_ptr_cast(m, variant_ptr, t_type_info_integer_ptr);
+				tag_type = t_type_info_integer;
 
 				lbValue is_signed = lb_const_bool(m, t_bool, (t->Basic.flags & BasicFlag_Unsigned) == 0);
 				// NOTE(bill): This is matches the runtime layout
@@ -14723,14 +15257,14 @@ void lb_setup_type_info_data(lbProcedure *p) { // NOTE(bill): Setup type_info da
 				};
 
 				lbValue res = {};
-				res.type = type_deref(tag.type);
+				res.type = tag_type;
 				res.value = llvm_const_named_struct(lb_type(m, res.type), vals, gb_count_of(vals));
-				lb_emit_store(p, tag, res);
+				variant_value = res.value;
 				break;
 			}
 
 			case Basic_rune:
-				tag = lb_const_ptr_cast(m, variant_ptr, t_type_info_rune_ptr);
+				tag_type = t_type_info_rune;
 				break;
 
 			case Basic_f16:
@@ -14743,7 +15277,7 @@ void lb_setup_type_info_data(lbProcedure *p) { // NOTE(bill): Setup type_info da
 			case Basic_f32be:
 			case Basic_f64be:
 				{
-					tag = lb_const_ptr_cast(m, variant_ptr, t_type_info_float_ptr);
+					tag_type = t_type_info_float;
 
 					// NOTE(bill): This is matches the runtime layout
 					u8 endianness_value = 0;
@@ -14759,58 +15293,58 @@ void lb_setup_type_info_data(lbProcedure *p) { // NOTE(bill): Setup type_info da
 					};
 
 					lbValue res = {};
-					res.type = type_deref(tag.type);
+					res.type = tag_type;
 					res.value = llvm_const_named_struct(lb_type(m, res.type), vals, gb_count_of(vals));
-					lb_emit_store(p, tag, res);
+					variant_value = res.value;
 				}
 				break;
 
 			case Basic_complex32:
 			case Basic_complex64:
 			case Basic_complex128:
-				tag = lb_const_ptr_cast(m, variant_ptr, t_type_info_complex_ptr);
+				tag_type = t_type_info_complex;
 				break;
 
 			case Basic_quaternion64:
 			case Basic_quaternion128:
 			case Basic_quaternion256:
-				tag = lb_const_ptr_cast(m, variant_ptr, t_type_info_quaternion_ptr);
+				tag_type = t_type_info_quaternion;
 				break;
 
 			case Basic_rawptr:
-				tag = lb_const_ptr_cast(m, variant_ptr, t_type_info_pointer_ptr);
+				tag_type = t_type_info_pointer;
 				break;
 
 			case Basic_string:
-				tag = lb_const_ptr_cast(m, variant_ptr, t_type_info_string_ptr);
+				tag_type = t_type_info_string;
 				break;
 
 			case Basic_cstring:
 				{
-					tag = lb_const_ptr_cast(m, variant_ptr, t_type_info_string_ptr);
+					tag_type = t_type_info_string;
 					LLVMValueRef vals[1] = {
 						lb_const_bool(m, t_bool, true).value,
 					};
 
 					lbValue res = {};
-					res.type = type_deref(tag.type);
+					res.type = tag_type;
 					res.value = llvm_const_named_struct(lb_type(m, res.type), vals, gb_count_of(vals));
-					lb_emit_store(p, tag, res);
+					variant_value = res.value;
 				}
 				break;
 
 			case Basic_any:
-				tag = lb_const_ptr_cast(m, variant_ptr, t_type_info_any_ptr);
+				tag_type = t_type_info_any;
 				break;
 
 			case Basic_typeid:
-				tag = lb_const_ptr_cast(m, variant_ptr, t_type_info_typeid_ptr);
+				tag_type = t_type_info_typeid;
 				break;
 			}
 			break;
 
 		case Type_Pointer: {
-			tag = lb_const_ptr_cast(m, variant_ptr, t_type_info_pointer_ptr);
+			tag_type = t_type_info_pointer;
 			lbValue gep = lb_get_type_info_ptr(m, t->Pointer.elem);
 
 			LLVMValueRef vals[1] = {
@@ -14818,13 +15352,13 @@ void lb_setup_type_info_data(lbProcedure *p) { // NOTE(bill): Setup type_info da
 			};
 
 			lbValue res = {};
-			res.type = type_deref(tag.type);
+			res.type = tag_type;
 			res.value = llvm_const_named_struct(lb_type(m, res.type), vals, gb_count_of(vals));
-			lb_emit_store(p, tag, res);
+			variant_value = res.value;
 			break;
 		}
 		case Type_Array: {
-			tag = lb_const_ptr_cast(m, variant_ptr, t_type_info_array_ptr);
+			tag_type = t_type_info_array;
 			i64 ez = type_size_of(t->Array.elem);
 
 			LLVMValueRef vals[3] = {
@@ -14834,43 +15368,31 @@ void lb_setup_type_info_data(lbProcedure *p) { // NOTE(bill): Setup type_info da
 			};
 
 			lbValue res = {};
-			res.type = type_deref(tag.type);
+			res.type = tag_type;
 			res.value = llvm_const_named_struct(lb_type(m, res.type), vals, gb_count_of(vals));
-			lb_emit_store(p, tag, res);
+			variant_value = res.value;
 			break;
 		}
 		case Type_EnumeratedArray: {
-			tag = lb_const_ptr_cast(m, variant_ptr, t_type_info_enumerated_array_ptr);
+			tag_type = t_type_info_enumerated_array;
 
 			LLVMValueRef vals[6] = {
 				lb_get_type_info_ptr(m, t->EnumeratedArray.elem).value,
 				lb_get_type_info_ptr(m, t->EnumeratedArray.index).value,
 				lb_const_int(m, t_int, type_size_of(t->EnumeratedArray.elem)).value,
 				lb_const_int(m, t_int, t->EnumeratedArray.count).value,
-
-				// Unions
-				LLVMConstNull(lb_type(m, t_type_info_enum_value)),
-				LLVMConstNull(lb_type(m, t_type_info_enum_value)),
+				lb_const_value(m, t_i64, t->EnumeratedArray.min_value).value,
+				lb_const_value(m, t_i64, t->EnumeratedArray.max_value).value,
 			};
 
 			lbValue res = {};
-			res.type = type_deref(tag.type);
+			res.type = tag_type;
 			res.value = llvm_const_named_struct(lb_type(m, res.type), vals, gb_count_of(vals));
-			lb_emit_store(p, tag, res);
-
-			// NOTE(bill): Union assignment
-			lbValue min_value = lb_emit_struct_ep(p, tag, 4);
-			lbValue max_value = lb_emit_struct_ep(p, tag, 5);
-
-			lbValue min_v = lb_const_value(m, t_i64, t->EnumeratedArray.min_value);
-			lbValue max_v = lb_const_value(m, t_i64, t->EnumeratedArray.max_value);
-
-			lb_emit_store(p, min_value, min_v);
-			lb_emit_store(p, max_value, max_v);
+			variant_value = res.value;
 			break;
 		}
 		case Type_DynamicArray: {
-			tag = lb_const_ptr_cast(m, variant_ptr, t_type_info_dynamic_array_ptr);
+			tag_type = t_type_info_dynamic_array;
 
 			LLVMValueRef vals[2] = {
 				lb_get_type_info_ptr(m, t->DynamicArray.elem).value,
@@ -14878,13 +15400,13 @@ void lb_setup_type_info_data(lbProcedure *p) { // NOTE(bill): Setup type_info da
 			};
 
 			lbValue res = {};
-			res.type = type_deref(tag.type);
+			res.type = tag_type;
 			res.value = llvm_const_named_struct(lb_type(m, res.type), vals, gb_count_of(vals));
-			lb_emit_store(p, tag, res);
+			variant_value = res.value;
 			break;
 		}
 		case Type_Slice: {
-			tag = lb_const_ptr_cast(m, variant_ptr, t_type_info_slice_ptr);
+			tag_type = t_type_info_slice;
 
 			LLVMValueRef vals[2] = {
 				lb_get_type_info_ptr(m, t->Slice.elem).value,
@@ -14892,13 +15414,13 @@ void lb_setup_type_info_data(lbProcedure *p) { // NOTE(bill): Setup type_info da
 			};
 
 			lbValue res = {};
-			res.type = type_deref(tag.type);
+			res.type = tag_type;
 			res.value = llvm_const_named_struct(lb_type(m, res.type), vals, gb_count_of(vals));
-			lb_emit_store(p, tag, res);
+			variant_value = res.value;
 			break;
 		}
 		case Type_Proc: {
-			tag = lb_const_ptr_cast(m, variant_ptr, t_type_info_procedure_ptr);
+			tag_type = t_type_info_procedure;
 
 			LLVMValueRef params = LLVMConstNull(lb_type(m, t_type_info_ptr));
 			LLVMValueRef results = LLVMConstNull(lb_type(m, t_type_info_ptr));
@@ -14917,31 +15439,28 @@ void lb_setup_type_info_data(lbProcedure *p) { // NOTE(bill): Setup type_info da
 			};
 
 			lbValue res = {};
-			res.type = type_deref(tag.type);
+			res.type = tag_type;
 			res.value = llvm_const_named_struct(lb_type(m, res.type), vals, gb_count_of(vals));
-			lb_emit_store(p, tag, res);
+			variant_value = res.value;
 			break;
 		}
 		case Type_Tuple: {
-			tag = lb_const_ptr_cast(m, variant_ptr, t_type_info_tuple_ptr);
+			tag_type = t_type_info_tuple;
 
 
-			lbValue memory_types = lb_type_info_member_types_offset(p, t->Tuple.variables.count);
-			lbValue memory_names = lb_type_info_member_names_offset(p, t->Tuple.variables.count);
+			LLVMValueRef *types = nullptr;
+			LLVMValueRef *names = nullptr;
+			lbValue memory_types = lb_type_info_member_array_offset(m, &lb_global_type_info_member_types, t->Tuple.variables.count, &types);
+			lbValue memory_names = lb_type_info_member_array_offset(m, &lb_global_type_info_member_names, t->Tuple.variables.count, &names);
 
 
 			for_array(i, t->Tuple.variables) {
 				// NOTE(bill): offset is not used for tuples
 				Entity *f = t->Tuple.variables[i];
 
-				lbValue index     = lb_const_int(m, t_int, i);
-				lbValue type_info = lb_emit_ptr_offset(p, memory_types, index);
-
-				// TODO(bill): Make this constant if possible, 'lb_const_store' does not work
-				lb_emit_store(p, type_info, lb_type_info(m, f->type));
+				types[i] = lb_type_info(m, f->type).value;
 				if (f->token.string.len > 0) {
-					lbValue name = lb_emit_ptr_offset(p, memory_names, index);
-					lb_emit_store(p, name, lb_const_string(m, f->token.string));
+					names[i] = lb_const_string(m, f->token.string).value;
 				}
 			}
 
@@ -14956,15 +15475,15 @@ void lb_setup_type_info_data(lbProcedure *p) { // NOTE(bill): Setup type_info da
 			};
 
 			lbValue res = {};
-			res.type = type_deref(tag.type);
+			res.type = tag_type;
 			res.value = llvm_const_named_struct(lb_type(m, res.type), vals, gb_count_of(vals));
-			lb_emit_store(p, tag, res);
+			variant_value = res.value;
 
 			break;
 		}
 
 		case Type_Enum:
-			tag = lb_const_ptr_cast(m, variant_ptr, t_type_info_enum_ptr);
+			tag_type = t_type_info_enum;
 
 			{
 				GB_ASSERT(t->Enum.base_type != nullptr);
@@ -15001,8 +15520,8 @@ void lb_setup_type_info_data(lbProcedure *p) { // NOTE(bill): Setup type_info da
 
 					lbValue v_count = lb_const_int(m, t_int, fields.count);
 
-					vals[1] = llvm_const_slice(m, lb_array_elem(p, name_array), v_count);
-					vals[2] = llvm_const_slice(m, lb_array_elem(p, value_array), v_count);
+					vals[1] = llvm_const_slice(m, lb_const_array_elem(m, name_array), v_count);
+					vals[2] = llvm_const_slice(m, lb_const_array_elem(m, value_array), v_count);
 				} else {
 					vals[1] = LLVMConstNull(lb_type(m, base_type(t_type_info_enum)->Struct.fields[1]->type));
 					vals[2] = LLVMConstNull(lb_type(m, base_type(t_type_info_enum)->Struct.fields[2]->type));
@@ -15010,29 +15529,26 @@ void lb_setup_type_info_data(lbProcedure *p) { // NOTE(bill): Setup type_info da
 
 
 				lbValue res = {};
-				res.type = type_deref(tag.type);
+				res.type = tag_type;
 				res.value = llvm_const_named_struct(lb_type(m, res.type), vals, gb_count_of(vals));
-				lb_emit_store(p, tag, res);
+				variant_value = res.value;
 			}
 			break;
 
 		case Type_Union: {
-			tag = lb_const_ptr_cast(m, variant_ptr, t_type_info_union_ptr);
+			tag_type = t_type_info_union;
 
 			{
 				LLVMValueRef vals[7] = {};
 
 				isize variant_count = gb_max(0, t->Union.variants.count);
-				lbValue memory_types = lb_type_info_member_types_offset(p, variant_count);
+				LLVMValueRef *types = nullptr;
+				lbValue memory_types = lb_type_info_member_array_offset(m, &lb_global_type_info_member_types, variant_count, &types);
 
 				// NOTE(bill): Zeroth is nil so ignore it
 				for (isize variant_index = 0; variant_index < variant_count; variant_index++) {
 					Type *vt = t->Union.variants[variant_index];
-					lbValue tip = lb_get_type_info_ptr(m, vt);
-
-					lbValue index     = lb_const_int(m, t_int, variant_index);
-					lbValue type_info = lb_emit_ptr_offset(p, memory_types, index);
-					lb_emit_store(p, type_info, lb_type_info(m, vt));
+					types[variant_index] = lb_type_info(m, vt).value;
 				}
 
 				lbValue count = lb_const_int(m, t_int, variant_count);
@@ -15059,21 +15575,21 @@ void lb_setup_type_info_data(lbProcedure *p) { // NOTE(bill): Setup type_info da
 
 				for (isize i = 0; i < gb_count_of(vals); i++) {
 					if (vals[i] == nullptr) {
-						vals[i]  = LLVMConstNull(lb_type(m, get_struct_field_type(tag.type, i)));
+						vals[i]  = LLVMConstNull(lb_type(m, get_struct_field_type(tag_type, i)));
 					}
 				}
 
 				lbValue res = {};
-				res.type = type_deref(tag.type);
+				res.type = tag_type;
 				res.value = llvm_const_named_struct(lb_type(m, res.type), vals, gb_count_of(vals));
-				lb_emit_store(p, tag, res);
+				variant_value = res.value;
 			}
 
 			break;
 		}
 
 		case Type_Struct: {
-			tag = lb_const_ptr_cast(m, variant_ptr, t_type_info_struct_ptr);
+			tag_type = t_type_info_struct;
 
 			LLVMValueRef vals[12] = {};
 
@@ -15091,8 +15607,7 @@ void lb_setup_type_info_data(lbProcedure *p) { // NOTE(bill): Setup type_info da
 
 
 				if (t->Struct.soa_kind != StructSoa_None) {
-					lbValue kind = lb_emit_struct_ep(p, tag, 9);
-					Type *kind_type = type_deref(kind.type);
+					Type *kind_type = get_struct_field_type(tag_type, 9);
 
 					lbValue soa_kind = lb_const_value(m, kind_type, exact_value_i64(t->Struct.soa_kind));
 					lbValue soa_type = lb_type_info(m, t->Struct.soa_elem);
@@ -15106,41 +15621,38 @@ void lb_setup_type_info_data(lbProcedure *p) { // NOTE(bill): Setup type_info da
 
 			isize count = t->Struct.fields.count;
 			if (count > 0) {
-				lbValue memory_types   = lb_type_info_member_types_offset  (p, count);
-				lbValue memory_names   = lb_type_info_member_names_offset  (p, count);
-				lbValue memory_offsets = lb_type_info_member_offsets_offset(p, count);
-				lbValue memory_usings  = lb_type_info_member_usings_offset (p, count);
-				lbValue memory_tags    = lb_type_info_member_tags_offset   (p, count);
+				LLVMValueRef *types   = nullptr;
+				LLVMValueRef *names   = nullptr;
+				LLVMValueRef *offsets = nullptr;
+				LLVMValueRef *usings  = nullptr;
+				LLVMValueRef *tags    = nullptr;
+				lbValue memory_types   = lb_type_info_member_array_offset(m, &lb_global_type_info_member_types,   count, &types);
+				lbValue memory_names   = lb_type_info_member_array_offset(m, &lb_global_type_info_member_names,   count, &names);
+				lbValue memory_offsets = lb_type_info_member_array_offset(m, &lb_global_type_info_member_offsets, count, &offsets);
+				lbValue memory_usings  = lb_type_info_member_array_offset(m, &lb_global_type_info_member_usings,  count, &usings);
+				lbValue memory_tags    = lb_type_info_member_array_offset(m, &lb_global_type_info_member_tags,    count, &tags);
 
 				type_set_offsets(t); // NOTE(bill): Just incase the offsets have not been set yet
 				for (isize source_index = 0; source_index < count; source_index++) {
 					// TODO(bill): Order fields in source order not layout order
 					Entity *f = t->Struct.fields[source_index];
-					lbValue tip = lb_get_type_info_ptr(m, f->type);
 					i64 foffset = 0;
 					if (!t->Struct.is_raw_union) {
 						foffset = t->Struct.offsets[f->Variable.field_index];
 					}
 					GB_ASSERT(f->kind == Entity_Variable && f->flags & EntityFlag_Field);
 
-					lbValue index     = lb_const_int(m, t_int, source_index);
-					lbValue type_info = lb_emit_ptr_offset(p, memory_types,   index);
-					lbValue offset    = lb_emit_ptr_offset(p, memory_offsets, index);
-					lbValue is_using  = lb_emit_ptr_offset(p, memory_usings,  index);
-
-					lb_emit_store(p, type_info, lb_type_info(m, f->type));
+					types[source_index] = lb_type_info(m, f->type).value;
 					if (f->token.string.len > 0) {
-						lbValue name = lb_emit_ptr_offset(p, memory_names,   index);
-						lb_emit_store(p, name, lb_const_string(m, f->token.string));
+						names[source_index] = lb_const_string(m, f->token.string).value;
 					}
-					lb_emit_store(p, offset, lb_const_int(m, t_uintptr, foffset));
-					lb_emit_store(p, is_using, lb_const_bool(m, t_bool, (f->flags&EntityFlag_Using) != 0));
+					offsets[source_index] = lb_const_int(m, t_uintptr, foffset).value;
+					usings[source_index]  = lb_const_bool(m, t_bool, (f->flags&EntityFlag_Using) != 0).value;
 
 					if (t->Struct.tags.count > 0) {
 						String tag_string = t->Struct.tags[source_index];
 						if (tag_string.len > 0) {
-							lbValue tag_ptr = lb_emit_ptr_offset(p, memory_tags, index);
-							lb_emit_store(p, tag_ptr, lb_const_string(m, tag_string));
+							tags[source_index] = lb_const_string(m, tag_string).value;
 						}
 					}
 
@@ -15155,21 +15667,21 @@ void lb_setup_type_info_data(lbProcedure *p) { // NOTE(bill): Setup type_info da
 			}
 			for (isize i = 0; i < gb_count_of(vals); i++) {
 				if (vals[i] == nullptr) {
-					vals[i]  = LLVMConstNull(lb_type(m, get_struct_field_type(tag.type, i)));
+					vals[i]  = LLVMConstNull(lb_type(m, get_struct_field_type(tag_type, i)));
 				}
 			}
 
 
 			lbValue res = {};
-			res.type = type_deref(tag.type);
+			res.type = tag_type;
 			res.value = llvm_const_named_struct(lb_type(m, res.type), vals, gb_count_of(vals));
-			lb_emit_store(p, tag, res);
+			variant_value = res.value;
 
 			break;
 		}
 
 		case Type_Map: {
-			tag = lb_const_ptr_cast(m, variant_ptr, t_type_info_map_ptr);
+			tag_type = t_type_info_map;
 			init_map_internal_types(t);
 
 			LLVMValueRef vals[5] = {
@@ -15181,15 +15693,15 @@ void lb_setup_type_info_data(lbProcedure *p) { // NOTE(bill): Setup type_info da
 			};
 
 			lbValue res = {};
-			res.type = type_deref(tag.type);
+			res.type = tag_type;
 			res.value = llvm_const_named_struct(lb_type(m, res.type), vals, gb_count_of(vals));
-			lb_emit_store(p, tag, res);
+			variant_value = res.value;
 			break;
 		}
 
 		case Type_BitSet:
 			{
-				tag = lb_const_ptr_cast(m, variant_ptr, t_type_info_bit_set_ptr);
+				tag_type = t_type_info_bit_set;
 
 				GB_ASSERT(is_type_typed(t->BitSet.elem));
 
@@ -15205,15 +15717,15 @@ void lb_setup_type_info_data(lbProcedure *p) { // NOTE(bill): Setup type_info da
 				}
 
 				lbValue res = {};
-				res.type = type_deref(tag.type);
+				res.type = tag_type;
 				res.value = llvm_const_named_struct(lb_type(m, res.type), vals, gb_count_of(vals));
-				lb_emit_store(p, tag, res);
+				variant_value = res.value;
 			}
 			break;
 
 		case Type_SimdVector:
 			{
-				tag = lb_const_ptr_cast(m, variant_ptr, t_type_info_simd_vector_ptr);
+				tag_type = t_type_info_simd_vector;
 
 				LLVMValueRef vals[3] = {};
 
@@ -15222,97 +15734,106 @@ void lb_setup_type_info_data(lbProcedure *p) { // NOTE(bill): Setup type_info da
 				vals[2] = lb_const_int(m, t_int, t->SimdVector.count).value;
 
 				lbValue res = {};
-				res.type = type_deref(tag.type);
+				res.type = tag_type;
 				res.value = llvm_const_named_struct(lb_type(m, res.type), vals, gb_count_of(vals));
-				lb_emit_store(p, tag, res);
+				variant_value = res.value;
 			}
 			break;
 
 		case Type_RelativePointer:
 			{
-				tag = lb_const_ptr_cast(m, variant_ptr, t_type_info_relative_pointer_ptr);
+				tag_type = t_type_info_relative_pointer;
 				LLVMValueRef vals[2] = {
 					lb_get_type_info_ptr(m, t->RelativePointer.pointer_type).value,
 					lb_get_type_info_ptr(m, t->RelativePointer.base_integer).value,
 				};
 
 				lbValue res = {};
-				res.type = type_deref(tag.type);
+				res.type = tag_type;
 				res.value = llvm_const_named_struct(lb_type(m, res.type), vals, gb_count_of(vals));
-				lb_emit_store(p, tag, res);
+				variant_value = res.value;
 			}
 			break;
 		case Type_RelativeSlice:
 			{
-				tag = lb_const_ptr_cast(m, variant_ptr, t_type_info_relative_slice_ptr);
+				tag_type = t_type_info_relative_slice;
 				LLVMValueRef vals[2] = {
 					lb_get_type_info_ptr(m, t->RelativeSlice.slice_type).value,
 					lb_get_type_info_ptr(m, t->RelativeSlice.base_integer).value,
 				};
 
 				lbValue res = {};
-				res.type = type_deref(tag.type);
+				res.type = tag_type;
 				res.value = llvm_const_named_struct(lb_type(m, res.type), vals, gb_count_of(vals));
-				lb_emit_store(p, tag, res);
+				variant_value = res.value;
 			}
 			break;
 
 		}
 
 
-		if (tag.value != nullptr) {
-			Type *tag_type = type_deref(tag.type);
+		if (tag_type != nullptr) {
 			GB_ASSERT(is_type_named(tag_type));
-			// lb_emit_store_union_variant(p, variant_ptr, lb_emit_load(p, tag), tag_type);
-			lb_emit_store_union_variant_tag(p, variant_ptr, tag_type);
+			LLVMValueRef fields[5] = {
+				lb_const_int(m, t_int, size).value,
+				lb_const_int(m, t_int, align).value,
+				lb_const_int(m, t_type_info_flags, type_info_flags_of_type(t)).value,
+				lb_typeid(m, t).value,
+				lb_const_type_info_variant(m, tag_type, variant_value),
+			};
+			entries[entry_index] = LLVMConstStructInContext(ctx, fields, gb_count_of(fields), false);
 		} else {
 			if (t != t_llvm_bool) {
 				GB_PANIC("Unhandled Type_Info variant: %s", type_to_string(t));
 			}
 		}
 	}
-}
 
-struct lbGlobalVariable {
-	lbValue var;
-	lbValue init;
-	DeclInfo *decl;
-	bool is_initialized;
-};
+	lb_type_info_member_array_set_initializer(m, &lb_global_type_info_member_types);
+	lb_type_info_member_array_set_initializer(m, &lb_global_type_info_member_names);
+	lb_type_info_member_array_set_initializer(m, &lb_global_type_info_member_offsets);
+	lb_type_info_member_array_set_initializer(m, &lb_global_type_info_member_usings);
+	lb_type_info_member_array_set_initializer(m, &lb_global_type_info_member_tags);
 
-lbProcedure *lb_create_startup_type_info(lbModule *m) {
-	LLVMPassManagerRef default_function_pass_manager = LLVMCreateFunctionPassManagerForModule(m->mod);
-	lb_populate_function_pass_manager(m, default_function_pass_manager, false, build_context.optimization_level);
-	LLVMFinalizeFunctionPassManager(default_function_pass_manager);
-
-	Type *params  = alloc_type_tuple();
-	Type *results = alloc_type_tuple();
-
-	Type *proc_type = alloc_type_proc(nullptr, nullptr, 0, nullptr, 0, false, ProcCC_CDecl);
-
-	lbProcedure *p = lb_create_dummy_procedure(m, str_lit(LB_STARTUP_TYPE_INFO_PROC_NAME), proc_type);
-	p->is_startup = true;
-	LLVMSetLinkage(p->value, LLVMInternalLinkage);
+	{
+		// NOTE: Each entry has the type of its own variant, so the table is a literal struct rather
+		// than an array of Type_Info. It has the same layout, so it replaces the zero initialized array
+		LLVMValueRef zero_entry = LLVMConstNull(lb_type(m, t_type_info));
+		for (isize i = 0; i < entry_count; i++) {
+			if (entries[i] == nullptr) {
+				entries[i] = zero_entry;
+			}
+		}
+		LLVMValueRef init = LLVMConstStructInContext(ctx, entries, cast(unsigned)entry_count, false);
+		GB_ASSERT(LLVMABISizeOfType(LLVMGetModuleDataLayout(m->mod), LLVMTypeOf(init)) == cast(unsigned long long)type_size_of(lb_global_type_info_data_entity->type));
 
-	lb_begin_procedure_body(p);
+		LLVMValueRef old_global = lb_global_type_info_data_ptr(m).value;
+		LLVMValueRef g = LLVMAddGlobal(m->mod, LLVMTypeOf(init), "");
+		LLVMSetInitializer(g, init);
+		LLVMSetLinkage(g, LLVMGetLinkage(old_global));
+		LLVMSetGlobalConstant(g, true);
+		LLVMSetAlignment(g, cast(unsigned)type_align_of(t_type_info));
 
-	lb_setup_type_info_data(p);
+		lbValue value = {};
+		value.value = LLVMConstBitCast(g, LLVMTypeOf(old_global));
+		value.type = alloc_type_pointer(lb_global_type_info_data_entity->type);
 
-	lb_end_procedure_body(p);
+		LLVMReplaceAllUsesWith(old_global, value.value);
+		LLVMDeleteGlobal(old_global);
+		LLVMSetValueName2(g, LB_TYPE_INFO_DATA_NAME, gb_strlen(LB_TYPE_INFO_DATA_NAME));
 
-	if (!m->debug_builder && LLVMVerifyFunction(p->value, LLVMReturnStatusAction)) {
-		gb_printf_err("LLVM CODE GEN FAILED FOR PROCEDURE: %s\n", "main");
-		LLVMDumpValue(p->value);
-		gb_printf_err("\n\n\n\n");
-		LLVMVerifyFunction(p->value, LLVMAbortProcessAction);
+		lb_add_entity(m, lb_global_type_info_data_entity, value);
 	}
-
-	lb_run_function_pass_manager(default_function_pass_manager, p);
-
-	return p;
 }
 
-lbProcedure *lb_create_startup_runtime(lbModule *main_module, lbProcedure *startup_type_info, Array<lbGlobalVariable> &global_variables) { // Startup Runtime
+struct lbGlobalVariable {
+	lbValue var;
+	lbValue init;
+	DeclInfo *decl;
+	bool is_initialized;
+};
+
+lbProcedure *lb_create_startup_runtime(lbModule *main_module, Array<lbGlobalVariable> &global_variables) { // Startup Runtime
 	LLVMPassManagerRef default_function_pass_manager = LLVMCreateFunctionPassManagerForModule(main_module->mod);
 	lb_populate_function_pass_manager(main_module, default_function_pass_manager, false, build_context.optimization_level);
 	LLVMFinalizeFunctionPassManager(default_function_pass_manager);
@@ -15327,8 +15848,6 @@ lbProcedure *lb_create_startup_runtime(lbModule *main_module, lbProcedure *start
 
 	lb_begin_procedure_body(p);
 
-	LLVMBuildCall2(p->builder, LLVMGetElementType(lb_type(main_module, startup_type_info->type)), startup_type_info->value, nullptr, 0, "");
-
 	for_array(i, global_variables) {
 		auto *var = &global_variables[i];
 		if (var->is_initialized) {
@@ -15546,38 +16065,40 @@ String lb_filepath_ll_for_module(lbModule *m) {
 
 	return path;
 }
+String lb_object_file_extension(void) {
+	if (build_context.build_mode == BuildMode_Assembly) {
+		return STR_LIT(".S");
+	}
+	if (is_arch_wasm()) {
+		return STR_LIT(".wasm.o");
+	}
+	switch (build_context.metrics.os) {
+	case TargetOs_windows:
+		return STR_LIT(".obj");
+	default:
+	case TargetOs_darwin:
+	case TargetOs_linux:
+	case TargetOs_essence:
+		return STR_LIT(".o");
+	}
+}
+
 String lb_filepath_obj_for_module(lbModule *m) {
 	String path = m->gen->output_base;
 	if (m->pkg) {
 		path = concatenate3_strings(permanent_allocator(), path, STR_LIT("-"), m->pkg->name);
 	}
+	return concatenate_strings(permanent_allocator(), path, lb_object_file_extension());
+}
 
-	String ext = {};
 
-	if (build_context.build_mode == BuildMode_Assembly) {
-		ext = STR_LIT(".S");
-	} else {
-		if (is_arch_wasm()) {
-			ext = STR_LIT(".wasm.o");
-		} else {
-			switch (build_context.metrics.os) {
-			case TargetOs_windows:
-				ext = STR_LIT(".obj");
-				break;
-			default:
-			case TargetOs_darwin:
-			case TargetOs_linux:
-			case TargetOs_essence:
-				ext = STR_LIT(".o");
-				break;
-			}
-		}
+String lb_module_trace_name(lbModule *m) {
+	if (m->pkg) {
+		return m->pkg->name;
 	}
-
-	return concatenate_strings(permanent_allocator(), path, ext);
+	return str_lit("<default>");
 }
 
-
 bool lb_is_module_empty(lbModule *m) {
 	if (LLVMGetFirstFunction(m->mod) == nullptr &&
 	    LLVMGetFirstGlobal(m->mod) == nullptr) {
@@ -15613,6 +16134,7 @@ WORKER_TASK_PROC(lb_llvm_emit_worker_proc) {
 	char *llvm_error = nullptr;
 
 	auto wd = cast(lbLLVMEmitWorker *)data;
+	TRACE_SCOPE(str_lit("LLVM Emit Object"), lb_module_trace_name(wd->m));
 
 	if (LLVMTargetMachineEmitToFile(wd->target_machine, wd->m->mod, cast(char *)wd->filepath_obj.text, wd->code_gen_file_type, &llvm_error)) {
 		gb_printf_err("LLVM Error: %s\n", llvm_error);
@@ -15626,6 +16148,7 @@ WORKER_TASK_PROC(lb_llvm_function_pass_worker_proc) {
 	GB_ASSERT(MULTITHREAD_OBJECT_GENERATION);
 
 	auto m = cast(lbModule *)data;
+	TRACE_SCOPE(str_lit("LLVM Function Passes"), lb_module_trace_name(m));
 
 	LLVMPassManagerRef default_function_pass_manager = LLVMCreateFunctionPassManagerForModule(m->mod);
 	LLVMPassManagerRef function_pass_manager_minimal = LLVMCreateFunctionPassManagerForModule(m->mod);
@@ -15691,6 +16214,10 @@ WORKER_TASK_PROC(lb_llvm_function_pass_worker_proc) {
 		lbProcedure *p = m->hasher_procs.entries[i].value;
 		lb_run_function_pass_manager(default_function_pass_manager, p);
 	}
+	for_array(i, m->map_get_procs.entries) {
+		lbProcedure *p = m->map_get_procs.entries[i].value;
+		lb_run_function_pass_manager(default_function_pass_manager, p);
+	}
 
 	return 0;
 }
@@ -15699,12 +16226,19 @@ WORKER_TASK_PROC(lb_llvm_function_pass_worker_proc) {
 struct lbLLVMModulePassWorkerData {
 	lbModule *m;
 	LLVMTargetMachineRef target_machine;
+
+	// NOTE: Only used by lb_llvm_pass_and_emit_worker_proc
+	bool do_emit;
+	bool is_empty;
+	LLVMCodeGenFileType code_gen_file_type;
+	String filepath_obj;
 };
 
 WORKER_TASK_PROC(lb_llvm_module_pass_worker_proc) {
 	GB_ASSERT(MULTITHREAD_OBJECT_GENERATION);
 
 	auto wd = cast(lbLLVMModulePassWorkerData *)data;
+	TRACE_SCOPE(str_lit("LLVM Module Passes"), lb_module_trace_name(wd->m));
 
 	LLVMPassManagerRef module_pass_manager = LLVMCreatePassManager();
 	lb_populate_module_pass_manager(wd->target_machine, module_pass_manager, build_context.optimization_level);
@@ -15713,6 +16247,43 @@ WORKER_TASK_PROC(lb_llvm_module_pass_worker_proc) {
 	return 0;
 }
 
+WORKER_TASK_PROC(lb_llvm_pass_and_emit_worker_proc) {
+	GB_ASSERT(MULTITHREAD_OBJECT_GENERATION);
+
+	auto wd = cast(lbLLVMModulePassWorkerData *)data;
+	lbModule *m = wd->m;
+
+	lb_llvm_function_pass_worker_proc(m);
+	lb_llvm_module_pass_worker_proc(wd);
+
+	if (!wd->do_emit) {
+		return 0;
+	}
+
+	// NOTE: The module is emitted as soon as its own passes have finished
+	// rather than waiting for every other module to be optimized
+	char *llvm_error = nullptr;
+	if (LLVMVerifyModule(m->mod, LLVMReturnStatusAction, &llvm_error)) {
+		gb_printf_err("LLVM Error:\n%s\n", llvm_error);
+		gb_exit(1);
+	}
+	LLVMDisposeMessage(llvm_error);
+
+	wd->is_empty = lb_is_module_empty(m);
+	if (wd->is_empty) {
+		return 0;
+	}
+
+	TRACE_SCOPE(str_lit("LLVM Emit Object"), lb_module_trace_name(m));
+	llvm_error = nullptr;
+	if (LLVMTargetMachineEmitToFile(wd->target_machine, m->mod, cast(char *)wd->filepath_obj.text, wd->code_gen_file_type, &llvm_error)) {
+		gb_printf_err("LLVM Error: %s\n", llvm_error);
+		gb_exit(1);
+	}
+
+	return 0;
+}
+
 
 void lb_generate_procedure(lbModule *m, lbProcedure *p) {
 	if (p->is_done) {
@@ -15754,6 +16325,16 @@ void lb_generate_procedure(lbModule *m, lbProcedure *p) {
 }
 
 
+WORKER_TASK_PROC(lb_generate_procedures_worker_proc) {
+	lbModule *m = cast(lbModule *)data;
+	TRACE_SCOPE(str_lit("LLVM Generate Procedures"), lb_module_trace_name(m));
+	for_array(i, m->procedures_to_generate) {
+		lbProcedure *p = m->procedures_to_generate[i];
+		lb_generate_procedure(m, p);
+	}
+	return 0;
+}
+
 void lb_generate_code(lbGenerator *gen) {
 	#define TIME_SECTION(str) do { if (build_context.show_more_timings) timings_start_section(&global_timings, str_lit(str)); } while (0)
 	#define TIME_SECTION_WITH_LEN(str, len) do { if (build_context.show_more_timings) timings_start_section(&global_timings, make_string((u8 *)str, len)); } while (0)
@@ -15767,6 +16348,11 @@ void lb_generate_code(lbGenerator *gen) {
 
 	thread_pool_init(&lb_thread_pool, heap_allocator(), worker_count, "LLVMBackend");
 	defer (thread_pool_destroy(&lb_thread_pool));
+	if (do_threading) {
+		// NOTE: The workers are started once and reused by every phase, so that each thread
+		// (and its permanent arena) is only created once
+		thread_pool_start(&lb_thread_pool);
+	}
 
 	lbModule *default_module = &gen->default_module;
 	CheckerInfo *info = gen->info;
@@ -15943,7 +16529,7 @@ void lb_generate_code(lbGenerator *gen) {
 					LLVMValueRef g = LLVMAddGlobal(m->mod, lb_type(m, t), name);
 					LLVMSetInitializer(g, LLVMConstNull(lb_type(m, t)));
 					LLVMSetLinkage(g, LLVMInternalLinkage);
-					lb_global_type_info_member_types = lb_addr({g, alloc_type_pointer(t)});
+					lb_global_type_info_member_types.addr = lb_addr({g, alloc_type_pointer(t)});
 
 				}
 				{
@@ -15952,7 +16538,7 @@ void lb_generate_code(lbGenerator *gen) {
 					LLVMValueRef g = LLVMAddGlobal(m->mod, lb_type(m, t), name);
 					LLVMSetInitializer(g, LLVMConstNull(lb_type(m, t)));
 					LLVMSetLinkage(g, LLVMInternalLinkage);
-					lb_global_type_info_member_names = lb_addr({g, alloc_type_pointer(t)});
+					lb_global_type_info_member_names.addr = lb_addr({g, alloc_type_pointer(t)});
 				}
 				{
 					char const *name = LB_TYPE_INFO_OFFSETS_NAME;
@@ -15960,7 +16546,7 @@ void lb_generate_code(lbGenerator *gen) {
 					LLVMValueRef g = LLVMAddGlobal(m->mod, lb_type(m, t), name);
 					LLVMSetInitializer(g, LLVMConstNull(lb_type(m, t)));
 					LLVMSetLinkage(g, LLVMInternalLinkage);
-					lb_global_type_info_member_offsets = lb_addr({g, alloc_type_pointer(t)});
+					lb_global_type_info_member_offsets.addr = lb_addr({g, alloc_type_pointer(t)});
 				}
 
 				{
@@ -15969,7 +16555,7 @@ void lb_generate_code(lbGenerator *gen) {
 					LLVMValueRef g = LLVMAddGlobal(m->mod, lb_type(m, t), name);
 					LLVMSetInitializer(g, LLVMConstNull(lb_type(m, t)));
 					LLVMSetLinkage(g, LLVMInternalLinkage);
-					lb_global_type_info_member_usings = lb_addr({g, alloc_type_pointer(t)});
+					lb_global_type_info_member_usings.addr = lb_addr({g, alloc_type_pointer(t)});
 				}
 
 				{
@@ -15978,7 +16564,7 @@ void lb_generate_code(lbGenerator *gen) {
 					LLVMValueRef g = LLVMAddGlobal(m->mod, lb_type(m, t), name);
 					LLVMSetInitializer(g, LLVMConstNull(lb_type(m, t)));
 					LLVMSetLinkage(g, LLVMInternalLinkage);
-					lb_global_type_info_member_tags = lb_addr({g, alloc_type_pointer(t)});
+					lb_global_type_info_member_tags.addr = lb_addr({g, alloc_type_pointer(t)});
 				}
 			}
 		}
@@ -16027,7 +16613,7 @@ void lb_generate_code(lbGenerator *gen) {
 			continue;
 		}
 
-		if (!ptr_set_exists(min_dep_set, e)) {
+		if (!id_set_exists(min_dep_set, e)) {
 			continue;
 		}
 		DeclInfo *decl = decl_info_of_entity(e);
@@ -16178,7 +16764,7 @@ void lb_generate_code(lbGenerator *gen) {
 			}
 		}
 
-		if (!polymorphic_struct && !ptr_set_exists(min_dep_set, e)) {
+		if (!polymorphic_struct && !id_set_exists(min_dep_set, e)) {
 			// NOTE(bill): Nothing depends upon it so doesn't need to be built
 			continue;
 		}
@@ -16204,19 +16790,37 @@ void lb_generate_code(lbGenerator *gen) {
 	}
 
 
+	if (build_context.incremental) {
+		TIME_SECTION("LLVM Incremental Cache Lookup");
+		lb_cache_lookup_modules(gen);
+	}
+
 	TIME_SECTION("LLVM Runtime Type Information Creation");
-	lbProcedure *startup_type_info = lb_create_startup_type_info(default_module);
+	lb_setup_type_info_data(default_module);
 
 	TIME_SECTION("LLVM Runtime Startup Creation (Global Variables)");
-	lbProcedure *startup_runtime = lb_create_startup_runtime(default_module, startup_type_info, global_variables);
+	lbProcedure *startup_runtime = lb_create_startup_runtime(default_module, global_variables);
 
 
 	TIME_SECTION("LLVM Procedure Generation");
-	for_array(j, gen->modules.entries) {
-		lbModule *m = gen->modules.entries[j].value;
-		for_array(i, m->procedures_to_generate) {
-			lbProcedure *p = m->procedures_to_generate[i];
-			lb_generate_procedure(m, p);
+	if (do_threading) {
+		// NOTE: Each module has its own LLVMContextRef, so the modules can be generated independently
+		for_array(j, gen->modules.entries) {
+			lbModule *m = gen->modules.entries[j].value;
+			if (m->procedures_to_generate.count == 0 || m->cache_object_path.len != 0) {
+				continue;
+			}
+			thread_pool_add_task(&lb_thread_pool, lb_generate_procedures_worker_proc, m);
+		}
+
+		thread_pool_wait(&lb_thread_pool);
+	} else {
+		for_array(j, gen->modules.entries) {
+			lbModule *m = gen->modules.entries[j].value;
+			if (m->cache_object_path.len != 0) {
+				continue;
+			}
+			lb_generate_procedures_worker_proc(m);
 		}
 	}
 
@@ -16235,6 +16839,8 @@ void lb_generate_code(lbGenerator *gen) {
 		}
 	}
 
+	lb_correct_entity_linkage(gen);
+
 	if (build_context.ODIN_DEBUG) {
 		TIME_SECTION("LLVM Debug Info Complete Types and Finalize");
 		for_array(j, gen->modules.entries) {
@@ -16247,36 +16853,106 @@ void lb_generate_code(lbGenerator *gen) {
 	}
 
 
-	TIME_SECTION("LLVM Function Pass");
-	for_array(i, gen->modules.entries) {
-		lbModule *m = gen->modules.entries[i].value;
+	llvm_error = nullptr;
+	defer (LLVMDisposeMessage(llvm_error));
 
-		lb_llvm_function_pass_worker_proc(m);
+	LLVMCodeGenFileType code_gen_file_type = LLVMObjectFile;
+	if (build_context.build_mode == BuildMode_Assembly) {
+		code_gen_file_type = LLVMAssemblyFile;
 	}
 
-	TIME_SECTION("LLVM Module Pass");
+	TIME_SECTION("LLVM Add Foreign Library Paths");
 
-	for_array(i, gen->modules.entries) {
-		lbModule *m = gen->modules.entries[i].value;
+	for_array(j, gen->modules.entries) {
+		lbModule *m = gen->modules.entries[j].value;
+		for_array(i, m->info->required_foreign_imports_through_force) {
+			Entity *e = m->info->required_foreign_imports_through_force[i];
+			lb_add_foreign_library_path(m, e);
+		}
+	}
 
-		auto wd = gb_alloc_item(permanent_allocator(), lbLLVMModulePassWorkerData);
-		wd->m = m;
-		wd->target_machine = target_machines[i];
+	// NOTE: The textual IR must be printed after the passes but before emission,
+	// so only pipeline the passes with the object emission when it is not required
+	bool print_modules = build_context.keep_temp_files || build_context.build_mode == BuildMode_LLVM_IR;
+	bool emit_with_passes = do_threading && !print_modules;
 
-		lb_llvm_module_pass_worker_proc(wd);
-	}
+	if (do_threading) {
+		if (emit_with_passes) {
+			TIME_SECTION("LLVM Passes and Object Generation");
+		} else {
+			TIME_SECTION("LLVM Function and Module Passes");
+		}
 
+		auto worker_data = array_make<lbLLVMModulePassWorkerData *>(heap_allocator(), gen->modules.entries.count);
+		defer (array_free(&worker_data));
 
-	llvm_error = nullptr;
-	defer (LLVMDisposeMessage(llvm_error));
+		for_array(j, gen->modules.entries) {
+			lbModule *m = gen->modules.entries[j].value;
 
-	LLVMCodeGenFileType code_gen_file_type = LLVMObjectFile;
-	if (build_context.build_mode == BuildMode_Assembly) {
-		code_gen_file_type = LLVMAssemblyFile;
+			auto wd = gb_alloc_item(permanent_allocator(), lbLLVMModulePassWorkerData);
+			wd->m = m;
+			wd->target_machine = target_machines[j];
+			wd->do_emit = emit_with_passes;
+			wd->code_gen_file_type = code_gen_file_type;
+			wd->filepath_obj = lb_filepath_obj_for_module(m);
+			worker_data[j] = wd;
+
+			if (m->cache_object_path.len != 0) {
+				continue;
+			}
+			thread_pool_add_task(&lb_thread_pool, lb_llvm_pass_and_emit_worker_proc, wd);
+		}
+
+		thread_pool_wait(&lb_thread_pool);
+
+		if (emit_with_passes) {
+			// NOTE: Keep the object paths in module order so the link is deterministic
+			for_array(j, worker_data) {
+				lbLLVMModulePassWorkerData *wd = worker_data[j];
+				if (wd->m->cache_object_path.len != 0) {
+					lb_cache_use_object(wd->m, wd->filepath_obj);
+				} else if (wd->is_empty) {
+					continue;
+				} else {
+					lb_cache_store_object(wd->m, wd->filepath_obj);
+				}
+				array_add(&gen->output_object_paths, wd->filepath_obj);
+				array_add(&gen->output_temp_paths, lb_filepath_ll_for_module(wd->m));
+			}
+			return;
+		}
+	} else {
+		TIME_SECTION("LLVM Function Pass");
+		for_array(i, gen->modules.entries) {
+			lbModule *m = gen->modules.entries[i].value;
+			if (m->cache_object_path.len != 0) {
+				continue;
+			}
+
+			lb_llvm_function_pass_worker_proc(m);
+		}
+
+		TIME_SECTION("LLVM Module Pass");
+
+		for_array(i, gen->modules.entries) {
+			lbModule *m = gen->modules.entries[i].value;
+			if (m->cache_object_path.len != 0) {
+				continue;
+			}
+
+			auto wd = gb_alloc_item(permanent_allocator(), lbLLVMModulePassWorkerData);
+			wd->m = m;
+			wd->target_machine = target_machines[i];
+
+			lb_llvm_module_pass_worker_proc(wd);
+		}
 	}
 
 	for_array(j, gen->modules.entries) {
 		lbModule *m = gen->modules.entries[j].value;
+		if (m->cache_object_path.len != 0) {
+			continue;
+		}
 		if (LLVMVerifyModule(m->mod, LLVMReturnStatusAction, &llvm_error)) {
 			gb_printf_err("LLVM Error:\n%s\n", llvm_error);
 			if (build_context.keep_temp_files) {
@@ -16293,8 +16969,7 @@ void lb_generate_code(lbGenerator *gen) {
 		}
 	}
 	llvm_error = nullptr;
-	if (build_context.keep_temp_files ||
-	    build_context.build_mode == BuildMode_LLVM_IR) {
+	if (print_modules) {
 		TIME_SECTION("LLVM Print Module to File");
 
 		for_array(j, gen->modules.entries) {
@@ -16319,21 +16994,6 @@ void lb_generate_code(lbGenerator *gen) {
 		}
 	}
 
-
-	TIME_SECTION("LLVM Add Foreign Library Paths");
-
-	for_array(j, gen->modules.entries) {
-		lbModule *m = gen->modules.entries[j].value;
-		for_array(i, m->info->required_foreign_imports_through_force) {
-			Entity *e = m->info->required_foreign_imports_through_force[i];
-			lb_add_foreign_library_path(m, e);
-		}
-
-		if (lb_is_module_empty(m)) {
-			continue;
-		}
-	}
-
 	TIME_SECTION("LLVM Object Generation");
 
 	if (do_threading) {
@@ -16356,11 +17016,16 @@ void lb_generate_code(lbGenerator *gen) {
 			thread_pool_add_task(&lb_thread_pool, lb_llvm_emit_worker_proc, wd);
 		}
 
-		thread_pool_start(&lb_thread_pool);
-		thread_pool_wait_to_process(&lb_thread_pool);
+		thread_pool_wait(&lb_thread_pool);
 	} else {
 		for_array(j, gen->modules.entries) {
 			lbModule *m = gen->modules.entries[j].value;
+			if (m->cache_object_path.len != 0) {
+				String filepath_obj = lb_filepath_obj_for_module(m);
+				lb_cache_use_object(m, filepath_obj);
+				array_add(&gen->output_object_paths, filepath_obj);
+				continue;
+			}
 			if (lb_is_module_empty(m)) {
 				continue;
 			}
@@ -16379,6 +17044,7 @@ void lb_generate_code(lbGenerator *gen) {
 				gb_exit(1);
 				return;
 			}
+			lb_cache_store_object(m, filepath_obj);
 		}
 	}
 
@@ -86,6 +86,12 @@ struct lbIncompleteDebugType {
 	LLVMMetadataRef metadata;
 };
 
+struct lbEntityCorrection {
+	lbModule *  other_module;
+	Entity *    e;
+	char const *cname;
+};
+
 struct lbModule {
 	LLVMModuleRef mod;
 	LLVMContextRef ctx;
@@ -107,25 +113,36 @@ struct lbModule {
 	Array<lbProcedure *> missing_procedures_to_check;
 
 	StringMap<LLVMValueRef> const_strings;
+	Map<LLVMValueRef>       load_file_data_ptrs; // Key: LoadFileCache *
 
 	Map<lbProcedure *> anonymous_proc_lits; // Key: Ast *
 	Map<struct lbFunctionType *> function_type_map; // Key: Type *
 
 	Map<lbProcedure *> equal_procs; // Key: Type *
 	Map<lbProcedure *> hasher_procs; // Key: Type *
+	Map<lbProcedure *> map_get_procs; // Key: Type *
 
 	u32 nested_type_name_guid;
 
 	Array<lbProcedure *> procedures_to_generate;
 	Array<String> foreign_library_paths;
 
+	// NOTE: Only used by -incremental, see llvm_backend_cache.cpp
+	u64    cache_fingerprint;
+	String cache_object_path; // set if the object file can be reused
+
 	lbProcedure *curr_procedure;
 
 	LLVMDIBuilderRef debug_builder;
 	LLVMMetadataRef debug_compile_unit;
 	Map<LLVMMetadataRef> debug_values; // Key: Pointer
+	Map<Type *>          debug_canonical_types; // Key: type_hash (multi map)
 
 	Array<lbIncompleteDebugType> debug_incomplete_types;
+
+	// NOTE: Linkage changes to globals which live in other modules are deferred
+	// until all the modules have been generated, as each module may be generated on its own thread
+	Array<lbEntityCorrection> entities_to_correct_linkage;
 };
 
 struct lbGenerator {
@@ -141,6 +158,7 @@ struct lbGenerator {
 	Map<lbModule *> modules_through_ctx; // Key: LLVMContextRef *
 	lbModule default_module;
 
+	BlockingMutex      anonymous_proc_lits_mutex;
 	Map<lbProcedure *> anonymous_proc_lits; // Key: Ast *
 
 	gbAtomic32 global_array_index;
@@ -283,6 +301,7 @@ bool lb_init_generator(lbGenerator *gen, Checker *c);
 void lb_generate_module(lbGenerator *gen);
 
 String lb_mangle_name(lbModule *m, Entity *e);
+String lb_object_file_extension(void);
 String lb_get_entity_name(lbModule *m, Entity *e, String name = {});
 
 LLVMAttributeRef lb_create_enum_attribute(LLVMContextRef ctx, char const *name, u64 value=0);
@@ -398,6 +417,7 @@ lbValue lb_generate_local_array(lbProcedure *p, Type *elem_type, i64 count, bool
 lbValue lb_generate_global_array(lbModule *m, Type *elem_type, i64 count, String prefix, i64 id);
 lbValue lb_gen_map_header(lbProcedure *p, lbValue map_val_ptr, Type *map_type);
 lbValue lb_gen_map_hash(lbProcedure *p, lbValue key, Type *key_type);
+lbValue lb_gen_map_key_hash(lbProcedure *p, lbValue key, Type *key_type, lbValue key_ptr);
 void    lb_insert_dynamic_map_key_and_value(lbProcedure *p, lbAddr addr, Type *map_type, lbValue map_key, lbValue map_value, Ast *node);
 
 lbValue lb_find_procedure_value_from_entity(lbModule *m, Entity *e);
@@ -411,6 +431,8 @@ lbValue lb_handle_param_value(lbProcedure *p, Type *parameter_type, ParameterVal
 
 lbValue lb_get_equal_proc_for_type(lbModule *m, Type *type);
 lbValue lb_get_hasher_proc_for_type(lbModule *m, Type *type);
+lbValue lb_get_map_get_proc_for_type(lbModule *m, Type *map_type);
+lbValue lb_emit_map_get(lbProcedure *p, lbValue map_ptr, Type *map_type, lbValue key);
 lbValue lb_emit_conv(lbProcedure *p, lbValue value, Type *t);
 
 LLVMMetadataRef lb_debug_type(lbModule *m, Type *type);
@@ -427,7 +449,6 @@ void lb_mem_zero_addr(lbProcedure *p, LLVMValueRef ptr, Type *type);
 
 
 #define LB_STARTUP_RUNTIME_PROC_NAME   "__$startup_runtime"
-#define LB_STARTUP_TYPE_INFO_PROC_NAME "__$startup_type_info"
 #define LB_TYPE_INFO_DATA_NAME       "__$type_info_data"
 #define LB_TYPE_INFO_TYPES_NAME      "__$type_info_types_data"
 #define LB_TYPE_INFO_NAMES_NAME      "__$type_info_names_data"
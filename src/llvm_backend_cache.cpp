@@ -0,0 +1,312 @@
+// NOTE: Incremental compilation (-incremental)
+// Every package is its own module (as with -use-separate-modules) and the object file generated for it
+// is stored in the cache directory (-cache-dir:<path>), keyed by a fingerprint of everything which can
+// affect the code generated for that package. A module with a cached object file skips procedure
+// generation, the LLVM passes, and the object emission entirely.
+//
+// The fingerprint of a package's module is made from:
+//     The global fingerprint:
+//         The compiler version, the command line, and the target
+//         The layout of the runtime type information table, as its indices are baked into each object
+//         The contents of every file loaded with '#load'
+//         The signature of every package: its files with the bodies of the top level procedures masked out,
+//         but not their lengths, so that the offset of every declaration outside of those bodies is included
+//     The full contents of the package's own files
+//     The link names of the procedures generated within the module
+//
+// The signatures of every package are used rather than only those of its transitive imports, as the
+// instantiations of a polymorphic procedure are generated within the module of the package which
+// declares it, even if they were instantiated with the types of another package.
+//
+// Layout of a cache entry:
+//     <cache-dir>/<fingerprint>.o    - the object file
+//     <cache-dir>/<fingerprint>.libs - the foreign libraries required by the object, one per line
+
+#define LB_CACHE_VERSION 2
+
+gb_global BlockingMutex     lb_cache_stable_ids_mutex;
+gb_global Map<Entity *>     lb_cache_stable_ids; // Key: stable entity id
+gb_global std::atomic<bool> lb_cache_stable_ids_collided;
+
+void lb_cache_init(void) {
+	mutex_init(&lb_cache_stable_ids_mutex);
+	map_init(&lb_cache_stable_ids, heap_allocator());
+}
+
+u64 lb_cache_hash_string(String const &s) {
+	return fnv64a(s.text, s.len);
+}
+
+// NOTE: Entity ids depend upon the order in which things were checked, and thus they differ between
+// builds, so -incremental uses a suffix derived from the declaration instead for the names which require one
+u64 lb_cache_stable_entity_id(Entity *e, String const &prefix) {
+	u64 h = type_hash_combine(LB_CACHE_VERSION, lb_cache_hash_string(prefix));
+	if (e->file != nullptr) {
+		h = type_hash_combine(h, lb_cache_hash_string(e->file->fullpath));
+	} else if (e->pkg != nullptr) {
+		h = type_hash_combine(h, lb_cache_hash_string(e->pkg->fullpath));
+	}
+	h = type_hash_combine(h, cast(u64)e->token.pos.offset);
+	if (is_type_polymorphic(e->type, true)) {
+		// NOTE: Each instantiation of a polymorphic procedure shares its declaration
+		gbString str = type_to_string(e->type);
+		h = type_hash_combine(h, fnv64a(str, gb_string_length(str)));
+		gb_string_free(str);
+	}
+	if (h == 0) {
+		h = 1;
+	}
+
+	mutex_lock(&lb_cache_stable_ids_mutex);
+	defer (mutex_unlock(&lb_cache_stable_ids_mutex));
+
+	HashKey key = hash_integer(h);
+	Entity **found = map_get(&lb_cache_stable_ids, key);
+	if (found != nullptr && *found != e) {
+		// NOTE: Fallback to the unstable entity id, which means no object may be reused nor stored
+		lb_cache_stable_ids_collided = true;
+		return 0;
+	}
+	map_set(&lb_cache_stable_ids, key, e);
+	return h;
+}
+
+u64 lb_cache_type_hash(Type *t) {
+	gbString str = type_to_string(t);
+	u64 h = fnv64a(str, gb_string_length(str));
+	gb_string_free(str);
+	if (t->kind == Type_Named && t->Named.type_name != nullptr) {
+		// NOTE: Different named types may share the same name, e.g. those declared within procedures
+		Entity *e = t->Named.type_name;
+		if (e->file != nullptr) {
+			h = type_hash_combine(h, lb_cache_hash_string(e->file->fullpath));
+		}
+		h = type_hash_combine(h, cast(u64)e->token.pos.offset);
+	}
+	return h;
+}
+
+u64 lb_cache_file_contents_hash(AstFile *f) {
+	Tokenizer *t = &f->tokenizer;
+	u64 h = lb_cache_hash_string(f->fullpath);
+	return type_hash_combine(h, fnv64a(t->start, t->end - t->start));
+}
+
+// NOTE: The bodies of the top level procedures cannot affect the code generated for any other package,
+// other than through the length of each body, as that moves the offsets which the stable entity ids use
+u64 lb_cache_file_signature_hash(AstFile *f) {
+	Tokenizer *t = &f->tokenizer;
+	isize size = t->end - t->start;
+	u64 h = lb_cache_hash_string(f->fullpath);
+
+	isize prev = 0;
+	for_array(i, f->decls) {
+		Ast *decl = f->decls[i];
+		if (decl->kind != Ast_ValueDecl || decl->ValueDecl.is_mutable) {
+			continue;
+		}
+		for_array(j, decl->ValueDecl.values) {
+			Ast *value = unparen_expr(decl->ValueDecl.values[j]);
+			if (value == nullptr || value->kind != Ast_ProcLit) {
+				continue;
+			}
+			Ast *body = value->ProcLit.body;
+			if (body == nullptr || body->kind != Ast_BlockStmt) {
+				continue;
+			}
+			isize lo = body->BlockStmt.open.pos.offset;
+			isize hi = body->BlockStmt.close.pos.offset;
+			if (lo < prev || hi < lo || hi > size) {
+				continue;
+			}
+			h = type_hash_combine(h, fnv64a(t->start+prev, lo-prev));
+			h = type_hash_combine(h, cast(u64)(hi-lo));
+			prev = hi;
+		}
+	}
+	h = type_hash_combine(h, fnv64a(t->start+prev, size-prev));
+	return h;
+}
+
+u64 lb_cache_global_fingerprint(lbGenerator *gen) {
+	CheckerInfo *info = gen->info;
+
+	u64 h = type_hash_combine(LB_CACHE_VERSION, lb_cache_hash_string(ODIN_VERSION));
+#if defined(GIT_SHA)
+	h = type_hash_combine(h, fnv64a(GIT_SHA, gb_strlen(GIT_SHA)));
+#endif
+	h = type_hash_combine(h, build_context.command_line_hash);
+	h = type_hash_combine(h, lb_cache_hash_string(odin_root_dir()));
+	h = type_hash_combine(h, lb_cache_hash_string(build_context.metrics.target_triplet));
+	h = type_hash_combine(h, lb_cache_hash_string(build_context.metrics.target_data_layout));
+	h = type_hash_combine(h, info->load_files_hash.load(std::memory_order_relaxed));
+
+	// NOTE: This mirrors the indices from `lb_type_info_index`
+	auto *set = &info->minimum_dependency_type_info_set;
+	h = type_hash_combine(h, cast(u64)set->entries.count);
+	for_array(i, set->entries) {
+		Type *t = info->type_info_types[set->entries[i].ptr];
+		h = type_hash_combine(h, cast(u64)(i+1));
+		h = type_hash_combine(h, lb_cache_type_hash(t));
+		h = type_hash_combine(h, cast(u64)type_size_of(t));
+		h = type_hash_combine(h, cast(u64)type_align_of(t));
+	}
+
+	// NOTE: The order of the packages and files depends upon the order in which they were parsed,
+	// so their hashes are combined in an order independent way
+	u64 signatures = 0;
+	for_array(i, info->packages.entries) {
+		AstPackage *pkg = info->packages.entries[i].value;
+		for_array(j, pkg->files) {
+			signatures += lb_cache_file_signature_hash(pkg->files[j]);
+		}
+	}
+	h = type_hash_combine(h, signatures);
+	return h;
+}
+
+u64 lb_cache_module_fingerprint(lbModule *m, u64 global_fingerprint) {
+	GB_ASSERT(m->pkg != nullptr);
+	AstPackage *pkg = m->pkg;
+
+	u64 h = type_hash_combine(global_fingerprint, lb_cache_hash_string(pkg->fullpath));
+
+	u64 files = 0;
+	for_array(i, pkg->files) {
+		files += lb_cache_file_contents_hash(pkg->files[i]);
+	}
+	h = type_hash_combine(h, files);
+
+	u64 procedures = 0;
+	for_array(i, m->procedures_to_generate) {
+		procedures += lb_cache_hash_string(m->procedures_to_generate[i]->name);
+	}
+	h = type_hash_combine(h, cast(u64)m->procedures_to_generate.count);
+	h = type_hash_combine(h, procedures);
+	if (h == 0) {
+		h = 1;
+	}
+	return h;
+}
+
+String lb_cache_entry_path(u64 fingerprint, String const &ext) {
+	String dir = build_context.cache_dir;
+	isize len = dir.len + 1 + 16 + ext.len + 1;
+	char *text = gb_alloc_array(permanent_allocator(), char, len);
+	len = gb_snprintf(text, len, "%.*s/%016llx%.*s", LIT(dir), cast(unsigned long long)fingerprint, LIT(ext));
+	return make_string(cast(u8 *)text, len-1);
+}
+
+bool lb_cache_load_foreign_library_paths(lbModule *m, String const &path) {
+	if (!gb_file_exists(cast(char const *)path.text)) {
+		return false;
+	}
+	gbFileContents fc = gb_file_read_contents(heap_allocator(), true, cast(char const *)path.text);
+	if (fc.data == nullptr) {
+		// NOTE: No foreign libraries are required
+		return true;
+	}
+	String contents = make_string(cast(u8 *)fc.data, fc.size);
+	isize line_start = 0;
+	for (isize i = 0; i <= contents.len; i++) {
+		if (i < contents.len && contents[i] != '\n') {
+			continue;
+		}
+		String line = substring(contents, line_start, i);
+		if (line.len > 0) {
+			array_add(&m->foreign_library_paths, copy_string(permanent_allocator(), line));
+		}
+		line_start = i+1;
+	}
+	gb_file_free_contents(&fc);
+	return true;
+}
+
+// NOTE: Must be called once all of the procedures to generate are known, but before they are generated
+void lb_cache_lookup_modules(lbGenerator *gen) {
+	if (build_context.build_mode == BuildMode_Assembly ||
+	    build_context.build_mode == BuildMode_LLVM_IR ||
+	    build_context.keep_temp_files) {
+		// NOTE: These require the textual output of every module
+		return;
+	}
+
+	u64 global_fingerprint = lb_cache_global_fingerprint(gen);
+
+	String ext = lb_object_file_extension();
+	for_array(i, gen->modules.entries) {
+		lbModule *m = gen->modules.entries[i].value;
+		if (m->pkg == nullptr) {
+			// NOTE: The default module contains the global variables, the type information and the startup
+			// procedures, which depend upon every package, so it is always generated
+			continue;
+		}
+		m->cache_fingerprint = lb_cache_module_fingerprint(m, global_fingerprint);
+		if (lb_cache_stable_ids_collided) {
+			continue;
+		}
+
+		String obj_path = lb_cache_entry_path(m->cache_fingerprint, ext);
+		if (!gb_file_exists(cast(char const *)obj_path.text)) {
+			continue;
+		}
+		String libs_path = lb_cache_entry_path(m->cache_fingerprint, str_lit(".libs"));
+		if (!lb_cache_load_foreign_library_paths(m, libs_path)) {
+			continue;
+		}
+		m->cache_object_path = obj_path;
+	}
+}
+
+bool lb_cache_copy_file(String const &src, String const &dst) {
+	char const *dst_path = cast(char const *)dst.text;
+	// NOTE: `gb_file_copy` does not truncate an existing file
+	gb_file_remove(dst_path);
+	return gb_file_copy(cast(char const *)src.text, dst_path, false);
+}
+
+// NOTE: Copies a cached object into place, so that the object files are the same for the linker
+// as they would be without -incremental
+void lb_cache_use_object(lbModule *m, String const &filepath_obj) {
+	GB_ASSERT(m->cache_object_path.len != 0);
+	if (!lb_cache_copy_file(m->cache_object_path, filepath_obj)) {
+		gb_printf_err("Failed to copy the cached object file '%.*s' to '%.*s'\n", LIT(m->cache_object_path), LIT(filepath_obj));
+		gb_exit(1);
+	}
+}
+
+void lb_cache_store_object(lbModule *m, String const &filepath_obj) {
+	if (m->cache_fingerprint == 0 || m->cache_object_path.len != 0 || lb_cache_stable_ids_collided) {
+		return;
+	}
+
+	// NOTE: Write to a temporary file and then move it into place, so that other compiler processes
+	// never see a partially written entry. The libraries are written first as the object marks the entry as complete
+	String libs_path = lb_cache_entry_path(m->cache_fingerprint, str_lit(".libs"));
+	String obj_path  = lb_cache_entry_path(m->cache_fingerprint, lb_object_file_extension());
+
+	char tmp_path[1024] = {};
+	gb_snprintf(tmp_path, gb_size_of(tmp_path), "%.*s.%u.tmp", LIT(libs_path), gb_thread_current_id());
+
+	gbFile file = {};
+	if (gb_file_create(&file, tmp_path) != gbFileError_None) {
+		return;
+	}
+	bool ok = true;
+	for_array(i, m->foreign_library_paths) {
+		String lib = m->foreign_library_paths[i];
+		ok = ok && gb_file_write(&file, lib.text, lib.len) && gb_file_write(&file, "\n", 1);
+	}
+	gb_file_close(&file);
+	gb_file_remove(cast(char const *)libs_path.text);
+	if (!ok || !gb_file_move(tmp_path, cast(char const *)libs_path.text)) {
+		gb_file_remove(tmp_path);
+		return;
+	}
+
+	gb_snprintf(tmp_path, gb_size_of(tmp_path), "%.*s.%u.tmp", LIT(obj_path), gb_thread_current_id());
+	if (!lb_cache_copy_file(filepath_obj, make_string_c(tmp_path)) ||
+	    !gb_file_move(tmp_path, cast(char const *)obj_path.text)) {
+		gb_file_remove(tmp_path);
+	}
+}
@@ -594,6 +594,7 @@ enum BuildFlagKind {
 	BuildFlag_ShowUnused,
 	BuildFlag_ShowUnusedWithLocation,
 	BuildFlag_ShowMoreTimings,
+	BuildFlag_TraceFile,
 	BuildFlag_ShowSystemCalls,
 	BuildFlag_ThreadCount,
 	BuildFlag_KeepTempFiles,
@@ -609,8 +610,10 @@ enum BuildFlagKind {
 	BuildFlag_NoEntryPoint,
 	BuildFlag_UseLLD,
 	BuildFlag_UseSeparateModules,
+	BuildFlag_Incremental,
 	BuildFlag_ThreadedChecker,
 	BuildFlag_NoThreadedChecker,
+	BuildFlag_ThreadedGlobalChecker,
 	BuildFlag_ShowDebugMessages,
 	BuildFlag_Vet,
 	BuildFlag_VetExtra,
@@ -618,6 +621,7 @@ enum BuildFlagKind {
 	BuildFlag_IgnoreUnknownAttributes,
 	BuildFlag_ExtraLinkerFlags,
 	BuildFlag_Microarch,
+	BuildFlag_CacheDir,
 
 	BuildFlag_TestName,
 
@@ -719,6 +723,7 @@ bool parse_build_flags(Array<String> args) {
 	add_flag(&build_flags, BuildFlag_OptimizationMode,  str_lit("O"),                   BuildFlagParam_String, Command__does_build);
 	add_flag(&build_flags, BuildFlag_ShowTimings,       str_lit("show-timings"),        BuildFlagParam_None, Command__does_check);
 	add_flag(&build_flags, BuildFlag_ShowMoreTimings,   str_lit("show-more-timings"),   BuildFlagParam_None, Command__does_check);
+	add_flag(&build_flags, BuildFlag_TraceFile,         str_lit("trace-file"),          BuildFlagParam_String, Command__does_check);
 	add_flag(&build_flags, BuildFlag_ShowUnused,        str_lit("show-unused"),         BuildFlagParam_None, Command_check);
 	add_flag(&build_flags, BuildFlag_ShowUnusedWithLocation, str_lit("show-unused-with-location"), BuildFlagParam_None, Command_check);
 	add_flag(&build_flags, BuildFlag_ShowSystemCalls,   str_lit("show-system-calls"),   BuildFlagParam_None, Command_all);
@@ -736,8 +741,10 @@ bool parse_build_flags(Array<String> args) {
 	add_flag(&build_flags, BuildFlag_NoEntryPoint,      str_lit("no-entry-point"),      BuildFlagParam_None, Command__does_check &~ Command_test);
 	add_flag(&build_flags, BuildFlag_UseLLD,            str_lit("lld"),                 BuildFlagParam_None, Command__does_build);
 	add_flag(&build_flags, BuildFlag_UseSeparateModules,str_lit("use-separate-modules"),BuildFlagParam_None, Command__does_build);
+	add_flag(&build_flags, BuildFlag_Incremental,       str_lit("incremental"),         BuildFlagParam_None, Command__does_build);
 	add_flag(&build_flags, BuildFlag_ThreadedChecker,   str_lit("threaded-checker"),    BuildFlagParam_None, Command__does_check);
 	add_flag(&build_flags, BuildFlag_NoThreadedChecker, str_lit("no-threaded-checker"), BuildFlagParam_None, Command__does_check);
+	add_flag(&build_flags, BuildFlag_ThreadedGlobalChecker, str_lit("threaded-global-checker"), BuildFlagParam_None, Command__does_check);
 	add_flag(&build_flags, BuildFlag_ShowDebugMessages, str_lit("show-debug-messages"), BuildFlagParam_None, Command_all);
 	add_flag(&build_flags, BuildFlag_Vet,               str_lit("vet"),                 BuildFlagParam_None, Command__does_check);
 	add_flag(&build_flags, BuildFlag_VetExtra,          str_lit("vet-extra"),           BuildFlagParam_None, Command__does_check);
@@ -745,6 +752,7 @@ bool parse_build_flags(Array<String> args) {
 	add_flag(&build_flags, BuildFlag_IgnoreUnknownAttributes, str_lit("ignore-unknown-attributes"), BuildFlagParam_None, Command__does_check);
 	add_flag(&build_flags, BuildFlag_ExtraLinkerFlags,  str_lit("extra-linker-flags"),              BuildFlagParam_String, Command__does_build);
 	add_flag(&build_flags, BuildFlag_Microarch,         str_lit("microarch"),                       BuildFlagParam_String, Command__does_build);
+	add_flag(&build_flags, BuildFlag_CacheDir,          str_lit("cache-dir"),                       BuildFlagParam_String, Command__does_check);
 
 	add_flag(&build_flags, BuildFlag_TestName,         str_lit("test-name"),                       BuildFlagParam_String, Command_test);
 
@@ -972,6 +980,17 @@ bool parse_build_flags(Array<String> args) {
 							build_context.show_timings = true;
 							build_context.show_more_timings = true;
 							break;
+						case BuildFlag_TraceFile: {
+							GB_ASSERT(value.kind == ExactValue_String);
+							String path = string_trim_whitespace(value.value_string);
+							if (path.len == 0) {
+								gb_printf_err("Invalid -trace-file path, got '%.*s'\n", LIT(value.value_string));
+								bad_flags = true;
+								break;
+							}
+							build_context.trace_file = path;
+							break;
+						}
 						case BuildFlag_ShowSystemCalls:
 							GB_ASSERT(value.kind == ExactValue_Invalid);
 							build_context.show_system_calls = true;
@@ -1225,6 +1244,12 @@ bool parse_build_flags(Array<String> args) {
 							build_context.use_separate_modules = true;
 							break;
 
+						case BuildFlag_Incremental:
+							// NOTE: Each package must be its own object file to be reused
+							build_context.incremental = true;
+							build_context.use_separate_modules = true;
+							break;
+
 						case BuildFlag_ThreadedChecker:
 							#if defined(DEFAULT_TO_THREADED_CHECKER)
 							gb_printf_err("-threaded-checker is the default on this platform\n");
@@ -1241,6 +1266,10 @@ bool parse_build_flags(Array<String> args) {
 							build_context.threaded_checker = false;
 							break;
 
+						case BuildFlag_ThreadedGlobalChecker:
+							build_context.threaded_global_checker = true;
+							break;
+
 						case BuildFlag_ShowDebugMessages:
 							build_context.show_debug_messages = true;
 							break;
@@ -1273,6 +1302,19 @@ bool parse_build_flags(Array<String> args) {
 							string_to_lower(&build_context.microarch);
 							break;
 
+						case BuildFlag_CacheDir: {
+							GB_ASSERT(value.kind == ExactValue_String);
+							String path = string_trim_whitespace(value.value_string);
+							String fullpath = path_to_fullpath(heap_allocator(), path);
+							if (!path_is_directory(fullpath)) {
+								gb_printf_err("Invalid -cache-dir path, expected a directory, got '%.*s'\n", LIT(path));
+								bad_flags = true;
+								break;
+							}
+							build_context.cache_dir = fullpath;
+							break;
+						}
+
 						case BuildFlag_TestName:
 							GB_ASSERT(value.kind == ExactValue_String);
 							{
@@ -1464,6 +1506,11 @@ bool parse_build_flags(Array<String> args) {
 		}
 	}
 
+	if (build_context.incremental && build_context.cache_dir.len == 0) {
+		gb_printf_err("-incremental requires a cache directory to be set with -cache-dir:<path>\n");
+		bad_flags = true;
+	}
+
 	if (build_context.query_data_set_settings.ok) {
 		if (build_context.query_data_set_settings.kind == QueryDataSet_Invalid) {
 			gb_printf_err("'odin query' requires a flag determining the kind of query data set to be returned\n");
@@ -1476,6 +1523,15 @@ bool parse_build_flags(Array<String> args) {
 	return !bad_flags;
 }
 
+void write_trace_file(Timings *t) {
+	if (build_context.trace_file.len == 0) {
+		return;
+	}
+	if (!trace_write_file(build_context.trace_file, t)) {
+		gb_printf_err("Failed to write the trace file '%.*s'\n", LIT(build_context.trace_file));
+	}
+}
+
 void show_timings(Checker *c, Timings *t) {
 	Parser *p      = c->parser;
 	isize lines    = p->total_line_count;
@@ -1496,6 +1552,26 @@ void show_timings(Checker *c, Timings *t) {
 	}
 
 	timings_print_all(t);
+	if (build_context.show_more_timings) {
+		isize total_used = 0;
+		isize total_reserved = 0;
+
+		gb_mutex_lock(&permanent_arenas.mutex);
+		gb_printf("\n");
+		gb_printf("Permanent Arenas\n");
+		for_array(i, permanent_arenas.arenas) {
+			Arena *arena = permanent_arenas.arenas[i];
+			total_used     += arena->total_used;
+			total_reserved += arena->total_reserved;
+			gb_printf("Thread %3d    - %10.3f MiB used - %10.3f MiB reserved\n", cast(int)i,
+			          cast(f64)arena->total_used/(1024*1024),
+			          cast(f64)arena->total_reserved/(1024*1024));
+		}
+		gb_printf("Total         - %10.3f MiB used - %10.3f MiB reserved\n",
+		          cast(f64)total_used/(1024*1024),
+		          cast(f64)total_reserved/(1024*1024));
+		gb_mutex_unlock(&permanent_arenas.mutex);
+	}
 	if (build_context.show_debug_messages && build_context.show_more_timings) {
 		{
 			gb_printf("\n");
@@ -1701,6 +1777,12 @@ void print_show_help(String const arg0, String const &command) {
 		print_usage_line(2, "Shows an advanced overview of the timings of different stages within the compiler in milliseconds");
 		print_usage_line(0, "");
 
+		print_usage_line(1, "-trace-file:<path>");
+		print_usage_line(2, "Writes the per-thread timings of the compiler to a Chrome Trace Event JSON file");
+		print_usage_line(2, "The file can be viewed with chrome://tracing or https://ui.perfetto.dev");
+		print_usage_line(2, "Example: -trace-file:odin_trace.json");
+		print_usage_line(0, "");
+
 		print_usage_line(1, "-thread-count:<integer>");
 		print_usage_line(2, "Override the number of threads the compiler will use to compile with");
 		print_usage_line(2, "Example: -thread-count:2");
@@ -1786,6 +1868,13 @@ void print_show_help(String const arg0, String const &command) {
 		print_usage_line(2, "Normally, a single build unit is generated for a standard project");
 		print_usage_line(0, "");
 
+		print_usage_line(1, "-incremental");
+		print_usage_line(1, "[EXPERIMENTAL]");
+		print_usage_line(2, "Reuses the object file of each package whose code has not changed since a previous build");
+		print_usage_line(2, "The object files are stored in the directory set with -cache-dir:<path>");
+		print_usage_line(2, "Implies -use-separate-modules");
+		print_usage_line(0, "");
+
 	}
 
 	if (check) {
@@ -1800,6 +1889,12 @@ void print_show_help(String const arg0, String const &command) {
 		print_usage_line(0, "");
 		#endif
 
+		print_usage_line(1, "-threaded-global-checker");
+		print_usage_line(1, "[EXPERIMENTAL]");
+		print_usage_line(2, "Check the global declarations of independent packages in parallel");
+		print_usage_line(2, "Packages at the same depth in the import graph are checked at the same time");
+		print_usage_line(0, "");
+
 		print_usage_line(1, "-vet");
 		print_usage_line(2, "Do extra checks on the code");
 		print_usage_line(2, "Extra checks include:");
@@ -1844,6 +1939,12 @@ void print_show_help(String const arg0, String const &command) {
 	}
 
 	if (check) {
+		print_usage_line(1, "-cache-dir:<path>");
+		print_usage_line(2, "Caches the tokens of each parsed file in the given directory");
+		print_usage_line(2, "Unchanged files are loaded from the cache rather than being tokenized again");
+		print_usage_line(2, "Example: -cache-dir:.odin-cache");
+		print_usage_line(0, "");
+
 		print_usage_line(1, "-disallow-do");
 		print_usage_line(2, "Disallows the 'do' keyword in the project");
 		print_usage_line(0, "");
@@ -1940,7 +2041,7 @@ void print_show_unused(Checker *c) {
 		if (e->token.string == "_") {
 			continue;
 		}
-		if (ptr_set_exists(&info->minimum_dependency_set, e)) {
+		if (id_set_exists(&info->minimum_dependency_set, e)) {
 			continue;
 		}
 		array_add(&unused, e);
@@ -2006,13 +2107,13 @@ int main(int arg_count, char const **arg_ptr) {
 
 	TIME_SECTION("initialization");
 
-	arena_init(&permanent_arena, heap_allocator());
+	init_permanent_arenas();
 	temp_allocator_init(&temporary_allocator_data, 16*1024*1024);
 	arena_init(&global_ast_arena, heap_allocator());
-	permanent_arena.use_mutex = true;
 
 	init_string_buffer_memory();
 	init_string_interner();
+	init_fullpath_cache();
 	init_global_error_collector();
 	init_keyword_hash_table();
 	init_type_mutex();
@@ -2147,6 +2248,19 @@ int main(int arg_count, char const **arg_ptr) {
 		return 1;
 	}
 
+	if (build_context.incremental) {
+		// NOTE: Any change to the command line must invalidate the cached object files
+		u64 h = 0;
+		for_array(i, args) {
+			h = type_hash_combine(h, fnv64a(args[i].text, args[i].len));
+		}
+		build_context.command_line_hash = h;
+	}
+
+	if (build_context.trace_file.len != 0) {
+		trace_init();
+	}
+
 	if (build_context.show_help) {
 		print_show_help(args[0], command);
 		return 0;
@@ -2221,6 +2335,7 @@ int main(int arg_count, char const **arg_ptr) {
 				show_timings(checker, &global_timings);
 			}
 		}
+		write_trace_file(&global_timings);
 
 		if (global_error_collector.count != 0) {
 			return 1;
@@ -2246,6 +2361,7 @@ int main(int arg_count, char const **arg_ptr) {
 			if (build_context.show_timings) {
 				show_timings(checker, &global_timings);
 			}
+			write_trace_file(&global_timings);
 			return 1;
 		}
 		break;
@@ -2254,6 +2370,7 @@ int main(int arg_count, char const **arg_ptr) {
 	if (build_context.show_timings) {
 		show_timings(checker, &global_timings);
 	}
+	write_trace_file(&global_timings);
 
 	remove_temp_files(gen);
 
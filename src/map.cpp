@@ -55,13 +55,14 @@ gb_inline bool operator!=(HashKey a, HashKey b) { return !hash_key_equal(a, b);
 template <typename T>
 struct MapEntry {
 	HashKey  key;
-	isize    next;
+	isize    next; // NOTE: The next entry with the same key, only used by the `multi_map_*` procedures
 	T        value;
 };
 
+// NOTE: The index only refers to the first entry of each key, see `hash_index.cpp`
 template <typename T>
 struct Map {
-	Array<isize>        hashes;
+	HashIndex           index;
 	Array<MapEntry<T> > entries;
 };
 
@@ -90,17 +91,17 @@ template <typename T> void  multi_map_remove_all(Map<T> *h, HashKey const &key);
 
 template <typename T>
 gb_inline void map_init(Map<T> *h, gbAllocator a, isize capacity) {
-	array_init(&h->hashes,  a, capacity);
 	array_init(&h->entries, a, 0, capacity);
-	for (isize i = 0; i < capacity; i++) {
-		h->hashes.data[i] = -1;
+	h->index = {};
+	if (capacity > 0) {
+		hash_index_init(&h->index, a, capacity);
 	}
 }
 
 template <typename T>
 gb_inline void map_destroy(Map<T> *h) {
+	hash_index_destroy(&h->index, h->entries.allocator);
 	array_free(&h->entries);
-	array_free(&h->hashes);
 }
 
 template <typename T>
@@ -115,83 +116,72 @@ gb_internal isize map__add_entry(Map<T> *h, HashKey const &key) {
 template <typename T>
 gb_internal MapFindResult map__find(Map<T> *h, HashKey const &key) {
 	MapFindResult fr = {-1, -1, -1};
-	if (h->hashes.count > 0) {
-		// fr.hash_index  = u128_to_i64(key.key % u128_from_i64(h->hashes.count));
-		fr.hash_index = key.key % h->hashes.count;
-		fr.entry_index = h->hashes.data[fr.hash_index];
-		while (fr.entry_index >= 0) {
-			if (hash_key_equal(h->entries.data[fr.entry_index].key, key)) {
-				return fr;
-			}
-			fr.entry_prev = fr.entry_index;
-			fr.entry_index = h->entries.data[fr.entry_index].next;
+	fr.hash_index = hash_index_find(&h->index, key.key, [h, key, &fr](u32 index) -> bool {
+		if (hash_key_equal(h->entries.data[index].key, key)) {
+			fr.entry_index = index;
+			return true;
 		}
-	}
+		return false;
+	});
 	return fr;
 }
 
 template <typename T>
 gb_internal MapFindResult map__find_from_entry(Map<T> *h, MapEntry<T> *e) {
-	MapFindResult fr = {-1, -1, -1};
-	if (h->hashes.count > 0) {
-		fr.hash_index  = e->key.key % h->hashes.count;
-		fr.entry_index = h->hashes.data[fr.hash_index];
-		while (fr.entry_index >= 0) {
-			if (&h->entries.data[fr.entry_index] == e) {
-				return fr;
-			}
-			fr.entry_prev = fr.entry_index;
-			fr.entry_index = h->entries.data[fr.entry_index].next;
+	MapFindResult fr = map__find(h, e->key);
+	while (fr.entry_index >= 0) {
+		if (&h->entries.data[fr.entry_index] == e) {
+			return fr;
 		}
+		fr.entry_prev = fr.entry_index;
+		fr.entry_index = h->entries.data[fr.entry_index].next;
 	}
 	return fr;
 }
 
-template <typename T>
-gb_internal b32 map__full(Map<T> *h) {
-	return 0.75f * h->hashes.count <= h->entries.count;
-}
-
-#define MAP_ARRAY_GROW_FORMULA(x) (4*(x) + 7)
-GB_STATIC_ASSERT(MAP_ARRAY_GROW_FORMULA(0) > 0);
-
 template <typename T>
 gb_inline void map_grow(Map<T> *h) {
-	isize new_count = MAP_ARRAY_GROW_FORMULA(h->entries.count);
-	map_rehash(h, new_count);
+	map_rehash(h, 2*h->entries.count);
 }
 
 template <typename T>
 void map_rehash(Map<T> *h, isize new_count) {
-	isize i, j;
-	Map<T> nh = {};
-	map_init(&nh, h->hashes.allocator, new_count);
-	array_resize(&nh.hashes, new_count);
-	array_reserve(&nh.entries, h->entries.count);
-	for (i = 0; i < new_count; i++) {
-		nh.hashes.data[i] = -1;
-	}
-	for (i = 0; i < h->entries.count; i++) {
-		MapEntry<T> *e = &h->entries.data[i];
-		MapFindResult fr;
-		if (nh.hashes.count == 0) {
-			map_grow(&nh);
-		}
-		fr = map__find(&nh, e->key);
-		j = map__add_entry(&nh, e->key);
-		if (fr.entry_prev < 0) {
-			nh.hashes.data[fr.hash_index] = j;
-		} else {
-			nh.entries.data[fr.entry_prev].next = j;
+	new_count = gb_max(new_count, h->entries.count);
+	gbAllocator a = h->entries.allocator;
+	hash_index_destroy(&h->index, a);
+	hash_index_init(&h->index, a, new_count);
+
+	// NOTE: Only the first entry of each key is in the index, which is any entry not in another's chain
+	// so it is only needed if some key has more than one entry
+	bool *in_chain = nullptr;
+	if (MAP_ENABLE_MULTI_MAP) {
+		for_array(i, h->entries) {
+			isize next = h->entries.data[i].next;
+			if (next < 0) {
+				continue;
+			}
+			if (in_chain == nullptr) {
+				in_chain = gb_alloc_array(a, bool, h->entries.count);
+				gb_zero_size(in_chain, h->entries.count);
+			}
+			in_chain[next] = true;
 		}
-		nh.entries.data[j].next = fr.entry_index;
-		nh.entries.data[j].value = e->value;
-		if (map__full(&nh)) {
-			map_grow(&nh);
+	}
+	for_array(i, h->entries) {
+		if (in_chain == nullptr || !in_chain[i]) {
+			hash_index_insert(&h->index, h->entries.data[i].key.key, cast(u32)i);
 		}
 	}
-	map_destroy(h);
-	*h = nh;
+	if (in_chain != nullptr) {
+		gb_free(a, in_chain);
+	}
+}
+
+template <typename T>
+gb_internal void map__reserve_one(Map<T> *h) {
+	if (h->index.capacity == 0 || hash_index_needs_grow(&h->index)) {
+		map_grow(h);
+	}
 }
 
 template <typename T>
@@ -212,49 +202,43 @@ T &map_must_get(Map<T> *h, HashKey const &key) {
 
 template <typename T>
 void map_set(Map<T> *h, HashKey const &key, T const &value) {
-	isize index;
-	MapFindResult fr;
-	if (h->hashes.count == 0) {
-		map_grow(h);
-	}
-	fr = map__find(h, key);
+	MapFindResult fr = map__find(h, key);
 	if (fr.entry_index >= 0) {
-		index = fr.entry_index;
-	} else {
-		index = map__add_entry(h, key);
-		if (fr.entry_prev >= 0) {
-			h->entries.data[fr.entry_prev].next = index;
-		} else {
-			h->hashes.data[fr.hash_index] = index;
-		}
+		h->entries.data[fr.entry_index].value = value;
+		return;
 	}
+	map__reserve_one(h);
+	isize index = map__add_entry(h, key);
 	h->entries.data[index].value = value;
-
-	if (map__full(h)) {
-		map_grow(h);
-	}
+	hash_index_insert(&h->index, key.key, cast(u32)index);
 }
 
 
+// NOTE: Moves the last entry into the place of the erased one to keep the entries dense
 template <typename T>
 void map__erase(Map<T> *h, MapFindResult const &fr) {
-	MapFindResult last;
-	if (fr.entry_prev < 0) {
-		h->hashes.data[fr.hash_index] = h->entries.data[fr.entry_index].next;
+	isize next = h->entries.data[fr.entry_index].next;
+	if (fr.entry_prev >= 0) {
+		h->entries.data[fr.entry_prev].next = next;
+	} else if (next >= 0) {
+		*hash_index_slot(&h->index, fr.hash_index) = cast(u32)next;
 	} else {
-		h->entries.data[fr.entry_prev].next = h->entries.data[fr.entry_index].next;
+		hash_index_erase(&h->index, fr.hash_index);
 	}
-	if (fr.entry_index == h->entries.count-1) {
-		array_pop(&h->entries);
-		return;
-	}
-	h->entries.data[fr.entry_index] = h->entries.data[h->entries.count-1];
-	last = map__find(h, h->entries.data[fr.entry_index].key);
-	if (last.entry_prev >= 0) {
-		h->entries.data[last.entry_prev].next = fr.entry_index;
-	} else {
-		h->hashes.data[last.hash_index] = fr.entry_index;
+
+	isize last_index = h->entries.count-1;
+	if (fr.entry_index != last_index) {
+		MapEntry<T> *last = &h->entries.data[last_index];
+		MapFindResult last_fr = map__find_from_entry(h, last);
+		GB_ASSERT(last_fr.entry_index == last_index);
+		if (last_fr.entry_prev >= 0) {
+			h->entries.data[last_fr.entry_prev].next = fr.entry_index;
+		} else {
+			*hash_index_slot(&h->index, last_fr.hash_index) = cast(u32)fr.entry_index;
+		}
+		h->entries.data[fr.entry_index] = *last;
 	}
+	array_pop(&h->entries);
 }
 
 template <typename T>
@@ -267,7 +251,7 @@ void map_remove(Map<T> *h, HashKey const &key) {
 
 template <typename T>
 gb_inline void map_clear(Map<T> *h) {
-	array_clear(&h->hashes);
+	hash_index_clear(&h->index);
 	array_clear(&h->entries);
 }
 
@@ -285,11 +269,8 @@ MapEntry<T> *multi_map_find_first(Map<T> *h, HashKey const &key) {
 template <typename T>
 MapEntry<T> *multi_map_find_next(Map<T> *h, MapEntry<T> *e) {
 	isize i = e->next;
-	while (i >= 0) {
-		if (hash_key_equal(h->entries.data[i].key, e->key)) {
-			return &h->entries.data[i];
-		}
-		i = h->entries.data[i].next;
+	if (i >= 0) {
+		return &h->entries.data[i];
 	}
 	return nullptr;
 }
@@ -315,26 +296,20 @@ void multi_map_get_all(Map<T> *h, HashKey const &key, T *items) {
 	}
 }
 
+// NOTE: The newest entry becomes the first of its key
 template <typename T>
 void multi_map_insert(Map<T> *h, HashKey const &key, T const &value) {
-	MapFindResult fr;
-	isize i;
-	if (h->hashes.count == 0) {
-		map_grow(h);
-	}
-	// Make
-	fr = map__find(h, key);
-	i = map__add_entry(h, key);
-	if (fr.entry_prev < 0) {
-		h->hashes.data[fr.hash_index] = i;
-	} else {
-		h->entries.data[fr.entry_prev].next = i;
+	MapFindResult fr = map__find(h, key);
+	if (fr.entry_index < 0) {
+		map__reserve_one(h);
 	}
-	h->entries.data[i].next = fr.entry_index;
+	isize i = map__add_entry(h, key);
 	h->entries.data[i].value = value;
-	// Grow if needed
-	if (map__full(h)) {
-		map_grow(h);
+	if (fr.entry_index >= 0) {
+		h->entries.data[i].next = fr.entry_index;
+		*hash_index_slot(&h->index, fr.hash_index) = cast(u32)i;
+	} else {
+		hash_index_insert(&h->index, key.key, cast(u32)i);
 	}
 }
 
@@ -1,9 +1,10 @@
 #include "parser_pos.cpp"
+#include "token_cache.cpp"
 
 Token token_end_of_line(AstFile *f, Token tok) {
 	u8 const *start = f->tokenizer.start + tok.pos.offset;
 	u8 const *s = start;
-	while (*s && *s != '\n' && s < f->tokenizer.end) {
+	while (s < f->tokenizer.end && *s && *s != '\n') {
 		s += 1;
 	}
 	tok.pos.column += cast(i32)(s - start) - 1;
@@ -24,29 +25,20 @@ gbString get_file_line_as_string(TokenPos const &pos, i32 *offset_) {
 		return nullptr;
 	}
 
-	u8 *pos_offset = start+offset;
-
-	u8 *line_start = pos_offset;
-	u8 *line_end  = pos_offset;
-	while (line_start >= start) {
-		if (*line_start == '\n') {
-			line_start += 1;
-			break;
-		}
+	// NOTE: The contents may be memory mapped and are not null terminated, so only [start, end) may be read.
+	// A position at the end of the file (offset == len) is on the last line
+	isize line_start = offset;
+	isize line_end   = offset;
+	while (line_start > 0 && start[line_start-1] != '\n') {
 		line_start -= 1;
 	}
-
-	while (line_end < end) {
-		if (*line_end == '\n') {
-			line_end -= 1;
-			break;
-		}
+	while (line_end < len && start[line_end] != '\n') {
 		line_end += 1;
 	}
-	String the_line = make_string(line_start, line_end-line_start);
+	String the_line = make_string(start+line_start, line_end-line_start);
 	the_line = string_trim_whitespace(the_line);
 
-	if (offset_) *offset_ = cast(i32)(pos_offset - the_line.text);
+	if (offset_) *offset_ = cast(i32)(offset - (the_line.text - start));
 
 	return gb_string_make_length(heap_allocator(), the_line.text, the_line.len);
 }
@@ -69,6 +61,19 @@ Ast *alloc_ast_node(AstFile *f, AstKind kind) {
 	return node;
 }
 
+TypeAndValue *ast_tav_for_write(Ast *node) {
+	TypeAndValue *tav = node->tav.ptr.load(std::memory_order_acquire);
+	if (tav != nullptr) {
+		return tav;
+	}
+	TypeAndValue *new_tav = gb_alloc_item(permanent_allocator(), TypeAndValue);
+	// NOTE: If another thread set it first, use that one; the allocation is just wasted
+	if (node->tav.ptr.compare_exchange_strong(tav, new_tav, std::memory_order_acq_rel, std::memory_order_acquire)) {
+		return new_tav;
+	}
+	return tav;
+}
+
 Ast *clone_ast(Ast *node);
 Array<Ast *> clone_ast_array(Array<Ast *> const &array) {
 	Array<Ast *> result = {};
@@ -97,6 +102,10 @@ Ast *clone_ast(Ast *node) {
 	}
 	Ast *n = alloc_ast_node(node->file, node->kind);
 	gb_memmove(n, node, ast_node_size(node->kind));
+	n->tav.ptr.store(nullptr, std::memory_order_relaxed);
+	if (node->tav.ptr.load(std::memory_order_acquire) != nullptr) {
+		*ast_tav_for_write(n) = *node->tav;
+	}
 
 	switch (n->kind) {
 	default: GB_PANIC("Unhandled Ast %.*s", LIT(ast_strings[n->kind])); break;
@@ -613,8 +622,9 @@ String string_value_from_token(AstFile *f, Token const &token) {
 Ast *ast_basic_lit(AstFile *f, Token basic_lit) {
 	Ast *result = alloc_ast_node(f, Ast_BasicLit);
 	result->BasicLit.token = basic_lit;
-	result->tav.mode = Addressing_Constant;
-	result->tav.value = exact_value_from_token(f, basic_lit);
+	TypeAndValue *tav = ast_tav_for_write(result);
+	tav->mode = Addressing_Constant;
+	tav->value = exact_value_from_token(f, basic_lit);
 	return result;
 }
 
@@ -1115,9 +1125,14 @@ Ast *ast_attribute(AstFile *f, Token token, Token open, Token close, Array<Ast *
 }
 
 
+Token ast_file_token(AstFile *f, isize index, i32 line_hint=1) {
+	return unpack_token(&f->tokenizer, f->id, f->line_offsets, f->tokens[index], line_hint);
+}
+
 bool next_token0(AstFile *f) {
 	if (f->curr_token_index+1 < f->tokens.count) {
-		f->curr_token = f->tokens[++f->curr_token_index];
+		f->curr_token_index += 1;
+		f->curr_token = ast_file_token(f, f->curr_token_index, f->curr_token.pos.line);
 		return true;
 	}
 	syntax_error(f->curr_token, "Token is EOF");
@@ -1230,7 +1245,7 @@ Token advance_token(AstFile *f) {
 
 bool peek_token_kind(AstFile *f, TokenKind kind) {
 	for (isize i = f->curr_token_index+1; i < f->tokens.count; i++) {
-		Token tok = f->tokens[i];
+		PackedToken tok = f->tokens[i];
 		if (kind != Token_Comment && tok.kind == Token_Comment) {
 			continue;
 		}
@@ -1241,11 +1256,10 @@ bool peek_token_kind(AstFile *f, TokenKind kind) {
 
 Token peek_token(AstFile *f) {
 	for (isize i = f->curr_token_index+1; i < f->tokens.count; i++) {
-		Token tok = f->tokens[i];
-		if (tok.kind == Token_Comment) {
+		if (f->tokens[i].kind == Token_Comment) {
 			continue;
 		}
-		return tok;
+		return ast_file_token(f, i, f->curr_token.pos.line);
 	}
 	return {};
 }
@@ -1825,7 +1839,7 @@ Ast *convert_stmt_to_expr(AstFile *f, Ast *statement, String kind) {
 	syntax_error(f->curr_token, "Expected '%.*s', found a simple statement.", LIT(kind));
 	Token end = f->curr_token;
 	if (f->tokens.count < f->curr_token_index) {
-		end = f->tokens[f->curr_token_index+1];
+		end = ast_file_token(f, f->curr_token_index+1);
 	}
 	return ast_bad_expr(f, f->curr_token, end);
 }
@@ -3846,7 +3860,7 @@ Ast *parse_if_stmt(AstFile *f) {
 		} break;
 		default:
 			syntax_error(f->curr_token, "Expected if statement block statement");
-			else_stmt = ast_bad_stmt(f, f->curr_token, f->tokens[f->curr_token_index+1]);
+			else_stmt = ast_bad_stmt(f, f->curr_token, ast_file_token(f, f->curr_token_index+1, f->curr_token.pos.line));
 			break;
 		}
 	}
@@ -3903,7 +3917,7 @@ Ast *parse_when_stmt(AstFile *f) {
 		} break;
 		default:
 			syntax_error(f->curr_token, "Expected when statement block statement");
-			else_stmt = ast_bad_stmt(f, f->curr_token, f->tokens[f->curr_token_index+1]);
+			else_stmt = ast_bad_stmt(f, f->curr_token, ast_file_token(f, f->curr_token_index+1, f->curr_token.pos.line));
 			break;
 		}
 	}
@@ -4633,37 +4647,41 @@ ParseFileError init_ast_file(AstFile *f, String fullpath, TokenPos *err_pos) {
 	array_init(&f->tokens, heap_allocator(), 0, gb_max(init_token_cap, 16));
 	isize cap0 = f->tokens.capacity;
 
+	init_line_offsets(&f->line_offsets, f->tokenizer.start, file_size);
+
 	if (err == TokenizerInit_Empty) {
-		Token token = {Token_EOF};
-		token.pos.file_id = f->id;
-		token.pos.line    = 1;
-		token.pos.column  = 1;
+		PackedToken token = {Token_EOF};
 		array_add(&f->tokens, token);
 		return ParseFile_None;
 	}
 
 	u64 start = time_stamp_time_now();
 
-	for (;;) {
-		Token *token = array_add_and_get(&f->tokens);
-		tokenizer_get_token(&f->tokenizer, token);
-		if (token->kind == Token_Invalid) {
-			err_pos->line   = token->pos.line;
-			err_pos->column = token->pos.column;
-			return ParseFile_InvalidToken;
-		}
+	if (!token_cache_load(f, tokenizer_flags)) {
+		for (;;) {
+			Token token = {};
+			tokenizer_get_token(&f->tokenizer, &token);
+			if (token.kind == Token_Invalid) {
+				err_pos->line   = token.pos.line;
+				err_pos->column = token.pos.column;
+				return ParseFile_InvalidToken;
+			}
 
-		if (token->kind == Token_EOF) {
-			break;
+			array_add(&f->tokens, pack_token(&f->tokenizer, token));
+			if (token.kind == Token_EOF) {
+				break;
+			}
 		}
+
+		token_cache_store(f, tokenizer_flags);
 	}
 
 	u64 end = time_stamp_time_now();
 	f->time_to_tokenize = cast(f64)(end-start)/cast(f64)time_stamp__freq();
 
 	f->curr_token_index = 0;
-	f->prev_token = f->tokens[f->curr_token_index];
-	f->curr_token = f->tokens[f->curr_token_index];
+	f->prev_token = ast_file_token(f, f->curr_token_index);
+	f->curr_token = ast_file_token(f, f->curr_token_index);
 
 	isize const page_size = 4*1024;
 	isize block_size = 2*f->tokens.count*gb_size_of(Ast);
@@ -4684,6 +4702,7 @@ ParseFileError init_ast_file(AstFile *f, String fullpath, TokenPos *err_pos) {
 void destroy_ast_file(AstFile *f) {
 	GB_ASSERT(f != nullptr);
 	array_free(&f->tokens);
+	array_free(&f->line_offsets);
 	array_free(&f->comments);
 	array_free(&f->imports);
 	gb_free(heap_allocator(), f->tokenizer.fullpath.text);
@@ -4753,6 +4772,7 @@ ParseFileError process_imported_file(Parser *p, ImportedFile const &imported_fil
 
 WORKER_TASK_PROC(parser_worker_proc) {
 	ParserWorkerData *wd = cast(ParserWorkerData *)data;
+	TRACE_SCOPE(str_lit("Parse File"), wd->imported_file.fi.fullpath);
 	ParseFileError err = process_imported_file(wd->parser, wd->imported_file);
 	if (err != ParseFile_None) {
 		mpmc_enqueue(&wd->parser->file_error_queue, err);
@@ -4763,7 +4783,7 @@ WORKER_TASK_PROC(parser_worker_proc) {
 
 void parser_add_file_to_process(Parser *p, AstPackage *pkg, FileInfo fi, TokenPos pos) {
 	// TODO(bill): Use a better allocator
-	ImportedFile f = {pkg, fi, pos, p->file_to_process_count++};
+	ImportedFile f = {pkg, fi, pos, p->file_to_process_count.fetch_add(1)};
 	auto wd = gb_alloc_item(heap_allocator(), ParserWorkerData);
 	wd->parser = p;
 	wd->imported_file = f;
@@ -4783,9 +4803,11 @@ WORKER_TASK_PROC(foreign_file_worker_proc) {
 	char *c_str = alloc_cstring(heap_allocator(), fullpath);
 	defer (gb_free(heap_allocator(), c_str));
 
-	gbFileContents fc = gb_file_read_contents(heap_allocator(), true, c_str);
-	foreign_file.source.text = (u8 *)fc.data;
-	foreign_file.source.len = fc.size;
+	// NOTE: The mapping is kept alive for the rest of the compilation
+	LoadedFile loaded_file = {};
+	load_file(c_str, &loaded_file);
+	foreign_file.source.text = cast(u8 *)loaded_file.data;
+	foreign_file.source.len = loaded_file.size;
 
 	switch (wd->foreign_kind) {
 	case AstForeignFile_S:
@@ -4801,7 +4823,7 @@ WORKER_TASK_PROC(foreign_file_worker_proc) {
 
 void parser_add_foreign_file_to_process(Parser *p, AstPackage *pkg, AstForeignFileKind kind, FileInfo fi, TokenPos pos) {
 	// TODO(bill): Use a better allocator
-	ImportedFile f = {pkg, fi, pos, p->file_to_process_count++};
+	ImportedFile f = {pkg, fi, pos, p->file_to_process_count.fetch_add(1)};
 	auto wd = gb_alloc_item(heap_allocator(), ForeignFileWorkerData);
 	wd->parser = p;
 	wd->imported_file = f;
@@ -4814,13 +4836,17 @@ void parser_add_foreign_file_to_process(Parser *p, AstPackage *pkg, AstForeignFi
 AstPackage *try_add_import_path(Parser *p, String const &path, String const &rel_path, TokenPos pos, PackageKind kind = Package_Normal) {
 	String const FILE_EXT = str_lit(".odin");
 
+	// NOTE: The lock is only held to claim the path, so that the directories of different packages
+	// are read at the same time by whichever threads found their imports
 	mutex_lock(&p->import_mutex);
-	defer (mutex_unlock(&p->import_mutex));
-
-	if (string_set_exists(&p->imported_files, path)) {
+	bool already_imported = string_set_exists(&p->imported_files, path);
+	if (!already_imported) {
+		string_set_add(&p->imported_files, path);
+	}
+	mutex_unlock(&p->import_mutex);
+	if (already_imported) {
 		return nullptr;
 	}
-	string_set_add(&p->imported_files, path);
 
 
 	AstPackage *pkg = gb_alloc_item(heap_allocator(), AstPackage);
@@ -4840,7 +4866,10 @@ AstPackage *try_add_import_path(Parser *p, String const &path, String const &rel
 
 		pkg->is_single_file = true;
 		parser_add_file_to_process(p, pkg, fi, pos);
+
+		mutex_lock(&p->import_mutex);
 		parser_add_package(p, pkg);
+		mutex_unlock(&p->import_mutex);
 		return pkg;
 	}
 
@@ -4892,7 +4921,9 @@ AstPackage *try_add_import_path(Parser *p, String const &path, String const &rel
 		}
 	}
 
+	mutex_lock(&p->import_mutex);
 	parser_add_package(p, pkg);
+	mutex_unlock(&p->import_mutex);
 
 	return pkg;
 }
@@ -4998,6 +5029,7 @@ bool determine_path_from_string(BlockingMutex *file_mutex, Ast *node, String bas
 	GB_ASSERT(path != nullptr);
 
 	// NOTE(bill): if file_mutex == nullptr, this means that the code is used within the semantics stage
+	// The path is resolved without holding it, as `get_fullpath_relative` is safe to call from any thread
 
 	gbAllocator a = heap_allocator();
 	String collection_name = {};
@@ -5084,10 +5116,6 @@ bool determine_path_from_string(BlockingMutex *file_mutex, Ast *node, String bas
 		return true;
 	}
 
-	if (file_mutex) mutex_lock(file_mutex);
-	defer (if (file_mutex) mutex_unlock(file_mutex));
-
-
 	if (node->kind == Ast_ForeignImportDecl) {
 		node->ForeignImportDecl.collection_name = collection_name;
 	}
@@ -5124,6 +5152,26 @@ void parse_setup_file_when_stmt(Parser *p, AstFile *f, String base_dir, AstWhenS
 	}
 }
 
+// NOTE: Returns a bad declaration if the import path is invalid
+Ast *parse_setup_import_decl(Parser *p, AstFile *f, String base_dir, Ast *node) {
+	ast_node(id, ImportDecl, node);
+
+	String original_string = string_trim_whitespace(string_value_from_token(f, id->relpath));
+	String import_path = {};
+	bool ok = determine_path_from_string(&p->file_decl_mutex, node, base_dir, original_string, &import_path);
+	if (!ok) {
+		return ast_bad_decl(f, id->relpath, id->relpath);
+	}
+	import_path = string_trim_whitespace(import_path);
+
+	id->fullpath = import_path;
+	if (is_package_name_reserved(import_path)) {
+		return node;
+	}
+	try_add_import_path(p, import_path, original_string, ast_token(node).pos);
+	return node;
+}
+
 void parse_setup_file_decls(Parser *p, AstFile *f, String base_dir, Slice<Ast *> &decls) {
 	for_array(i, decls) {
 		Ast *node = decls[i];
@@ -5144,22 +5192,10 @@ void parse_setup_file_decls(Parser *p, AstFile *f, String base_dir, Slice<Ast *>
 
 			syntax_error(node, "Only declarations are allowed at file scope, got %.*s", LIT(ast_strings[node->kind]));
 		} else if (node->kind == Ast_ImportDecl) {
-			ast_node(id, ImportDecl, node);
-
-			String original_string = string_trim_whitespace(string_value_from_token(f, id->relpath));
-			String import_path = {};
-			bool ok = determine_path_from_string(&p->file_decl_mutex, node, base_dir, original_string, &import_path);
-			if (!ok) {
-				decls[i] = ast_bad_decl(f, id->relpath, id->relpath);
-				continue;
+			// NOTE: An import which has already been set up whilst parsing the file has its `fullpath`
+			if (node->ImportDecl.fullpath.len == 0) {
+				decls[i] = parse_setup_import_decl(p, f, base_dir, node);
 			}
-			import_path = string_trim_whitespace(import_path);
-
-			id->fullpath = import_path;
-			if (is_package_name_reserved(import_path)) {
-				continue;
-			}
-			try_add_import_path(p, import_path, original_string, ast_token(node).pos);
 		} else if (node->kind == Ast_ForeignImportDecl) {
 			ast_node(fl, ForeignImportDecl, node);
 
@@ -5394,6 +5430,11 @@ bool parse_file(Parser *p, AstFile *f) {
 		while (f->curr_token.kind != Token_EOF) {
 			Ast *stmt = parse_stmt(f);
 			if (stmt && stmt->kind != Ast_EmptyStmt) {
+				if (stmt->kind == Ast_ImportDecl && f->error_count == 0) {
+					// NOTE: Start on the imported package straight away rather than once this
+					// file has been parsed, so that its files are read whilst the rest of this one is parsed
+					stmt = parse_setup_import_decl(p, f, base_dir, stmt);
+				}
 				array_add(&decls, stmt);
 				if (stmt->kind == Ast_ExprStmt &&
 				    stmt->ExprStmt.expr != nullptr &&
@@ -100,7 +100,8 @@ struct AstFile {
 	Ast *        pkg_decl;
 	String       fullpath;
 	Tokenizer    tokenizer;
-	Array<Token> tokens;
+	Array<PackedToken> tokens; // NOTE: See `ast_file_token`
+	Array<i32>   line_offsets;
 	isize        curr_token_index;
 	Token        curr_token;
 	Token        prev_token; // previous non-comment
@@ -189,7 +190,7 @@ struct Parser {
 	StringMap<AstPackage *>   package_map; // Key(package name)
 	Array<AstPackage *>       packages;
 	Array<ImportedPackage>    package_imports;
-	isize                     file_to_process_count;
+	std::atomic<isize>        file_to_process_count;
 	isize                     total_token_count;
 	isize                     total_line_count;
 	BlockingMutex             import_mutex;
@@ -681,22 +682,38 @@ isize const ast_variant_sizes[] = {
 #undef AST_KIND
 };
 
+// NOTE: The type and value of a node is stored out-of-line and is only allocated once it is first set,
+// as most nodes (statements, declarations, fields, and anything which is never checked) never have one.
+// Until then, it reads as an empty `TypeAndValue`; use `ast_tav_for_write` to set it
+gb_global TypeAndValue const empty_type_and_value = {};
+
+struct AstTypeAndValue {
+	std::atomic<TypeAndValue *> ptr;
+
+	gb_inline TypeAndValue const *get() const {
+		TypeAndValue const *tav = ptr.load(std::memory_order_acquire);
+		return tav != nullptr ? tav : &empty_type_and_value;
+	}
+	gb_inline TypeAndValue const *operator->() const { return get(); }
+	gb_inline TypeAndValue const &operator*()  const { return *get(); }
+};
+
 struct AstCommonStuff {
-	AstKind      kind;
-	u16          state_flags;
-	u16          viral_state_flags;
-	AstFile *    file;
-	Scope *      scope;
-	TypeAndValue tav; // TODO(bill): Make this a pointer to minimize pointer size
+	AstKind         kind;
+	u16             state_flags;
+	u16             viral_state_flags;
+	AstFile *       file;
+	Scope *         scope;
+	AstTypeAndValue tav;
 };
 
 struct Ast {
-	AstKind      kind;
-	u16          state_flags;
-	u16          viral_state_flags;
-	AstFile *    file;
-	Scope *      scope;
-	TypeAndValue tav; // TODO(bill): Make this a pointer to minimize pointer size
+	AstKind         kind;
+	u16             state_flags;
+	u16             viral_state_flags;
+	AstFile *       file;
+	Scope *         scope;
+	AstTypeAndValue tav;
 
 	// IMPORTANT NOTE(bill): This must be at the end since the AST is allocated to be size of the variant
 	union {
@@ -744,5 +761,6 @@ gbAllocator ast_allocator(AstFile *f) {
 }
 
 Ast *alloc_ast_node(AstFile *f, AstKind kind);
+TypeAndValue *ast_tav_for_write(Ast *node);
 
 gbString expr_to_string(Ast *expression);
@@ -1,23 +1,12 @@
-typedef u32 PtrSetIndex;
-
-struct PtrSetFindResult {
-	PtrSetIndex hash_index;
-	PtrSetIndex entry_prev;
-	PtrSetIndex entry_index;
-};
-
-enum : PtrSetIndex { PTR_SET_SENTINEL = ~(PtrSetIndex)0 };
-
-
+// NOTE: See `hash_index.cpp`
 template <typename T>
 struct PtrSetEntry {
-	T           ptr;
-	PtrSetIndex next;
+	T ptr;
 };
 
 template <typename T>
 struct PtrSet {
-	Array<PtrSetIndex>    hashes;
+	HashIndex             index;
 	Array<PtrSetEntry<T>> entries;
 };
 
@@ -32,182 +21,101 @@ template <typename T> void ptr_set_grow   (PtrSet<T> *s);
 template <typename T> void ptr_set_rehash (PtrSet<T> *s, isize new_count);
 
 
+// NOTE: `T` is not always a pointer, e.g. `PtrSet<isize>`
 template <typename T>
-void ptr_set_init(PtrSet<T> *s, gbAllocator a, isize capacity) {
-	capacity = next_pow2_isize(gb_max(16, capacity));
+gb_inline u64 ptr_set__hash(T ptr) {
+	return cast(u64)cast(uintptr)ptr;
+}
 
-	array_init(&s->hashes,  a, capacity);
+template <typename T>
+void ptr_set_init(PtrSet<T> *s, gbAllocator a, isize capacity) {
 	array_init(&s->entries, a, 0, capacity);
-	for (isize i = 0; i < capacity; i++) {
-		s->hashes.data[i] = PTR_SET_SENTINEL;
+	s->index = {};
+	if (capacity > 0) {
+		hash_index_init(&s->index, a, capacity);
 	}
 }
 
 template <typename T>
 void ptr_set_destroy(PtrSet<T> *s) {
-	array_free(&s->hashes);
+	hash_index_destroy(&s->index, s->entries.allocator);
 	array_free(&s->entries);
 }
 
+// NOTE: Returns the slot of `ptr` or -1
 template <typename T>
-gb_internal PtrSetIndex ptr_set__add_entry(PtrSet<T> *s, T ptr) {
-	PtrSetEntry<T> e = {};
-	e.ptr = ptr;
-	e.next = PTR_SET_SENTINEL;
-	array_add(&s->entries, e);
-	return cast(PtrSetIndex)(s->entries.count-1);
-}
-
-
-template <typename T>
-gb_internal PtrSetFindResult ptr_set__find(PtrSet<T> *s, T ptr) {
-	PtrSetFindResult fr = {PTR_SET_SENTINEL, PTR_SET_SENTINEL, PTR_SET_SENTINEL};
-	if (s->hashes.count != 0) {
-		u64 hash = 0xcbf29ce484222325ull ^ cast(u64)cast(uintptr)ptr;
-		u64 n = cast(u64)s->hashes.count;
-		fr.hash_index = cast(PtrSetIndex)(hash & (n-1));
-		fr.entry_index = s->hashes.data[fr.hash_index];
-		while (fr.entry_index != PTR_SET_SENTINEL) {
-			if (s->entries.data[fr.entry_index].ptr == ptr) {
-				return fr;
-			}
-			fr.entry_prev = fr.entry_index;
-			fr.entry_index = s->entries.data[fr.entry_index].next;
-		}
-	}
-	return fr;
-}
-
-template <typename T>
-gb_internal bool ptr_set__full(PtrSet<T> *s) {
-	return 0.75f * s->hashes.count <= s->entries.count;
+gb_internal isize ptr_set__find(PtrSet<T> *s, T ptr) {
+	return hash_index_find(&s->index, ptr_set__hash(ptr), [s, ptr](u32 index) -> bool {
+		return s->entries.data[index].ptr == ptr;
+	});
 }
 
 template <typename T>
 gb_inline void ptr_set_grow(PtrSet<T> *s) {
-	isize new_count = s->hashes.count*2;
-	ptr_set_rehash(s, new_count);
+	ptr_set_rehash(s, 2*s->entries.count);
 }
 
 template <typename T>
 void ptr_set_rehash(PtrSet<T> *s, isize new_count) {
-	isize i, j;
-	PtrSet<T> ns = {};
-	ptr_set_init(&ns, s->hashes.allocator);
-	array_resize(&ns.hashes, new_count);
-	array_reserve(&ns.entries, s->entries.count);
-	for (i = 0; i < new_count; i++) {
-		ns.hashes.data[i] = PTR_SET_SENTINEL;
-	}
-	for (i = 0; i < s->entries.count; i++) {
-		PtrSetEntry<T> *e = &s->entries.data[i];
-		PtrSetFindResult fr;
-		if (ns.hashes.count == 0) {
-			ptr_set_grow(&ns);
-		}
-		fr = ptr_set__find(&ns, e->ptr);
-		j = ptr_set__add_entry(&ns, e->ptr);
-		if (fr.entry_prev == PTR_SET_SENTINEL) {
-			ns.hashes.data[fr.hash_index] = cast(PtrSetIndex)j;
-		} else {
-			ns.entries.data[fr.entry_prev].next = cast(PtrSetIndex)j;
-		}
-		ns.entries.data[j].next = fr.entry_index;
-		if (ptr_set__full(&ns)) {
-			ptr_set_grow(&ns);
-		}
+	new_count = gb_max(new_count, s->entries.count);
+	hash_index_destroy(&s->index, s->entries.allocator);
+	hash_index_init(&s->index, s->entries.allocator, new_count);
+	for_array(i, s->entries) {
+		hash_index_insert(&s->index, ptr_set__hash(s->entries.data[i].ptr), cast(u32)i);
 	}
-	ptr_set_destroy(s);
-	*s = ns;
 }
 
 template <typename T>
 gb_inline bool ptr_set_exists(PtrSet<T> *s, T ptr) {
-	isize index = ptr_set__find(s, ptr).entry_index;
-	return index != PTR_SET_SENTINEL;
+	return ptr_set__find(s, ptr) >= 0;
 }
 
-// Returns true if it already exists
 template <typename T>
-T ptr_set_add(PtrSet<T> *s, T ptr) {
-	PtrSetIndex index;
-	PtrSetFindResult fr;
-	if (s->hashes.count == 0) {
-		ptr_set_grow(s);
-	}
-	fr = ptr_set__find(s, ptr);
-	if (fr.entry_index == PTR_SET_SENTINEL) {
-		index = ptr_set__add_entry(s, ptr);
-		if (fr.entry_prev != PTR_SET_SENTINEL) {
-			s->entries.data[fr.entry_prev].next = index;
-		} else {
-			s->hashes.data[fr.hash_index] = index;
-		}
-	}
-	if (ptr_set__full(s)) {
-		ptr_set_grow(s);
-	}
+gb_inline T ptr_set_add(PtrSet<T> *s, T ptr) {
+	ptr_set_update(s, ptr);
 	return ptr;
 }
 
 template <typename T>
 bool ptr_set_update(PtrSet<T> *s, T ptr) { // returns true if it previously existsed
-	bool exists = false;
-	PtrSetIndex index;
-	PtrSetFindResult fr;
-	if (s->hashes.count == 0) {
-		ptr_set_grow(s);
+	if (ptr_set__find(s, ptr) >= 0) {
+		return true;
 	}
-	fr = ptr_set__find(s, ptr);
-	if (fr.entry_index != PTR_SET_SENTINEL) {
-		exists = true;
-	} else {
-		index = ptr_set__add_entry(s, ptr);
-		if (fr.entry_prev != PTR_SET_SENTINEL) {
-			s->entries.data[fr.entry_prev].next = index;
-		} else {
-			s->hashes.data[fr.hash_index] = index;
-		}
-	}
-	if (ptr_set__full(s)) {
+	if (s->index.capacity == 0 || hash_index_needs_grow(&s->index)) {
 		ptr_set_grow(s);
 	}
-	return exists;
+	PtrSetEntry<T> e = {ptr};
+	array_add(&s->entries, e);
+	hash_index_insert(&s->index, ptr_set__hash(ptr), cast(u32)(s->entries.count-1));
+	return false;
 }
 
 
-
+// NOTE: Moves the last entry into the place of the erased one to keep the entries dense
 template <typename T>
-void ptr_set__erase(PtrSet<T> *s, PtrSetFindResult fr) {
-	PtrSetFindResult last;
-	if (fr.entry_prev == PTR_SET_SENTINEL) {
-		s->hashes.data[fr.hash_index] = s->entries.data[fr.entry_index].next;
-	} else {
-		s->entries.data[fr.entry_prev].next = s->entries.data[fr.entry_index].next;
-	}
-	if (cast(isize)fr.entry_index == s->entries.count-1) {
-		array_pop(&s->entries);
-		return;
-	}
-	s->entries.data[fr.entry_index] = s->entries.data[s->entries.count-1];
-	last = ptr_set__find(s, s->entries.data[fr.entry_index].ptr);
-	if (last.entry_prev != PTR_SET_SENTINEL) {
-		s->entries.data[last.entry_prev].next = fr.entry_index;
-	} else {
-		s->hashes.data[last.hash_index] = fr.entry_index;
+void ptr_set__erase(PtrSet<T> *s, isize slot) {
+	isize entry_index = *hash_index_slot(&s->index, slot);
+	hash_index_erase(&s->index, slot);
+	isize last_index = s->entries.count-1;
+	if (entry_index != last_index) {
+		T last = s->entries.data[last_index].ptr;
+		isize last_slot = hash_index_slot_of_entry(&s->index, ptr_set__hash(last), cast(u32)last_index);
+		*hash_index_slot(&s->index, last_slot) = cast(u32)entry_index;
+		s->entries.data[entry_index].ptr = last;
 	}
+	array_pop(&s->entries);
 }
 
 template <typename T>
 void ptr_set_remove(PtrSet<T> *s, T ptr) {
-	PtrSetFindResult fr = ptr_set__find(s, ptr);
-	if (fr.entry_index != PTR_SET_SENTINEL) {
-		ptr_set__erase(s, fr);
+	isize slot = ptr_set__find(s, ptr);
+	if (slot >= 0) {
+		ptr_set__erase(s, slot);
 	}
 }
 
 template <typename T>
 gb_inline void ptr_set_clear(PtrSet<T> *s) {
-	array_clear(&s->hashes);
+	hash_index_clear(&s->index);
 	array_clear(&s->entries);
 }
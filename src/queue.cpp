@@ -92,11 +92,24 @@ i32 mpmc_enqueue(MPMCQueue<T> *q, T const &data) {
 				return -1;
 			}
 			// NOTE(bill): pretend it's not atomic for performance
+			// The queued range [tail_idx, head_idx) may wrap around the end of the old buffer,
+			// so every node must be moved to the slot which the new mask maps its index to
 			auto *raw_data = cast(MPMCQueueNodeNonAtomic<T> *)q->buffer.data;
-			for (i32 i = old_size; i < new_size; i++) {
-				raw_data[i].idx = i;
+			i32 new_mask = new_size-1;
+			i32 tail_idx = q->tail_idx.load(std::memory_order_acquire);
+			head_idx = q->head_idx.load(std::memory_order_relaxed);
+			for (i32 i = new_size-1; i >= 0; i--) {
+				i32 idx = tail_idx + ((i - tail_idx) & new_mask);
+				if (idx - head_idx < 0) {
+					if (i >= old_size) {
+						raw_data[i].data = raw_data[i-old_size].data;
+					}
+					raw_data[i].idx = idx+1;
+				} else {
+					raw_data[i].idx = idx;
+				}
 			}
-			q->mask = new_size-1;
+			q->mask = new_mask;
 			mutex_unlock(&q->mutex);
 		} else {
 			head_idx = q->head_idx.load(std::memory_order_relaxed);
@@ -1,7 +1,6 @@
 // NOTE(bill): This util stuff is the same for every `Map`
 struct StringMapFindResult {
 	isize hash_index;
-	isize entry_prev;
 	isize entry_index;
 };
 
@@ -25,6 +24,10 @@ gb_inline StringHashKey string_hash_string(String const &s) {
 
 bool string_hash_key_equal(StringHashKey a, StringHashKey b) {
 	if (a.hash == b.hash) {
+		if (a.string.text == b.string.text && a.string.len == b.string.len) {
+			// NOTE: Interned strings share their text, see `string_intern_hash_key`
+			return true;
+		}
 		// NOTE(bill): If two string's hashes collide, compare the strings themselves
 		return a.string == b.string;
 	}
@@ -36,13 +39,13 @@ bool operator!=(StringHashKey a, StringHashKey b) { return !string_hash_key_equa
 template <typename T>
 struct StringMapEntry {
 	StringHashKey key;
-	isize         next;
 	T             value;
 };
 
+// NOTE: See `hash_index.cpp`
 template <typename T>
 struct StringMap {
-	Array<isize>              hashes;
+	HashIndex                 index;
 	Array<StringMapEntry<T> > entries;
 };
 
@@ -69,107 +72,45 @@ template <typename T> void string_map_rehash           (StringMap<T> *h, isize n
 
 template <typename T>
 gb_inline void string_map_init(StringMap<T> *h, gbAllocator a, isize capacity) {
-	array_init(&h->hashes,  a, capacity);
 	array_init(&h->entries, a, 0, capacity);
-	for (isize i = 0; i < capacity; i++) {
-		h->hashes.data[i] = -1;
+	h->index = {};
+	if (capacity > 0) {
+		hash_index_init(&h->index, a, capacity);
 	}
 }
 
 template <typename T>
 gb_inline void string_map_destroy(StringMap<T> *h) {
+	hash_index_destroy(&h->index, h->entries.allocator);
 	array_free(&h->entries);
-	array_free(&h->hashes);
-}
-
-template <typename T>
-gb_internal isize string_map__add_entry(StringMap<T> *h, StringHashKey const &key) {
-	StringMapEntry<T> e = {};
-	e.key = key;
-	e.next = -1;
-	array_add(&h->entries, e);
-	return h->entries.count-1;
 }
 
 template <typename T>
 gb_internal StringMapFindResult string_map__find(StringMap<T> *h, StringHashKey const &key) {
-	StringMapFindResult fr = {-1, -1, -1};
-	if (h->hashes.count > 0) {
-		fr.hash_index = key.hash % h->hashes.count;
-		fr.entry_index = h->hashes.data[fr.hash_index];
-		while (fr.entry_index >= 0) {
-			if (string_hash_key_equal(h->entries.data[fr.entry_index].key, key)) {
-				return fr;
-			}
-			fr.entry_prev = fr.entry_index;
-			fr.entry_index = h->entries.data[fr.entry_index].next;
+	StringMapFindResult fr = {-1, -1};
+	fr.hash_index = hash_index_find(&h->index, key.hash, [h, &key, &fr](u32 index) -> bool {
+		if (string_hash_key_equal(h->entries.data[index].key, key)) {
+			fr.entry_index = index;
+			return true;
 		}
-	}
+		return false;
+	});
 	return fr;
 }
 
-template <typename T>
-gb_internal StringMapFindResult string_map__find_from_entry(StringMap<T> *h, StringMapEntry<T> *e) {
-	StringMapFindResult fr = {-1, -1, -1};
-	if (h->hashes.count > 0) {
-		fr.hash_index  = e->key.hash % h->hashes.count;
-		fr.entry_index = h->hashes.data[fr.hash_index];
-		while (fr.entry_index >= 0) {
-			if (&h->entries.data[fr.entry_index] == e) {
-				return fr;
-			}
-			fr.entry_prev = fr.entry_index;
-			fr.entry_index = h->entries.data[fr.entry_index].next;
-		}
-	}
-	return fr;
-}
-
-template <typename T>
-gb_internal b32 string_map__full(StringMap<T> *h) {
-	return 0.75f * h->hashes.count <= h->entries.count;
-}
-
-#define STRING_MAP_ARRAY_GROW_FORMULA(x) (4*(x) + 7)
-GB_STATIC_ASSERT(STRING_MAP_ARRAY_GROW_FORMULA(0) > 0);
-
 template <typename T>
 gb_inline void string_map_grow(StringMap<T> *h) {
-	isize new_count = STRING_MAP_ARRAY_GROW_FORMULA(h->entries.count);
-	string_map_rehash(h, new_count);
+	string_map_rehash(h, 2*h->entries.count);
 }
 
 template <typename T>
 void string_map_rehash(StringMap<T> *h, isize new_count) {
-	isize i, j;
-	StringMap<T> nh = {};
-	string_map_init(&nh, h->hashes.allocator, new_count);
-	array_resize(&nh.hashes, new_count);
-	array_reserve(&nh.entries, h->entries.count);
-	for (i = 0; i < new_count; i++) {
-		nh.hashes.data[i] = -1;
-	}
-	for (i = 0; i < h->entries.count; i++) {
-		StringMapEntry<T> *e = &h->entries.data[i];
-		StringMapFindResult fr;
-		if (nh.hashes.count == 0) {
-			string_map_grow(&nh);
-		}
-		fr = string_map__find(&nh, e->key);
-		j = string_map__add_entry(&nh, e->key);
-		if (fr.entry_prev < 0) {
-			nh.hashes.data[fr.hash_index] = j;
-		} else {
-			nh.entries.data[fr.entry_prev].next = j;
-		}
-		nh.entries.data[j].next = fr.entry_index;
-		nh.entries.data[j].value = e->value;
-		if (string_map__full(&nh)) {
-			string_map_grow(&nh);
-		}
+	new_count = gb_max(new_count, h->entries.count);
+	hash_index_destroy(&h->index, h->entries.allocator);
+	hash_index_init(&h->index, h->entries.allocator, new_count);
+	for_array(i, h->entries) {
+		hash_index_insert(&h->index, h->entries.data[i].key.hash, cast(u32)i);
 	}
-	string_map_destroy(h);
-	*h = nh;
 }
 
 template <typename T>
@@ -210,27 +151,19 @@ gb_inline T &string_map_must_get(StringMap<T> *h, char const *key) {
 
 template <typename T>
 void string_map_set(StringMap<T> *h, StringHashKey const &key, T const &value) {
-	isize index;
-	StringMapFindResult fr;
-	if (h->hashes.count == 0) {
-		string_map_grow(h);
-	}
-	fr = string_map__find(h, key);
+	StringMapFindResult fr = string_map__find(h, key);
 	if (fr.entry_index >= 0) {
-		index = fr.entry_index;
-	} else {
-		index = string_map__add_entry(h, key);
-		if (fr.entry_prev >= 0) {
-			h->entries.data[fr.entry_prev].next = index;
-		} else {
-			h->hashes.data[fr.hash_index] = index;
-		}
+		h->entries.data[fr.entry_index].value = value;
+		return;
 	}
-	h->entries.data[index].value = value;
-
-	if (string_map__full(h)) {
+	if (h->index.capacity == 0 || hash_index_needs_grow(&h->index)) {
 		string_map_grow(h);
 	}
+	StringMapEntry<T> e = {};
+	e.key = key;
+	e.value = value;
+	array_add(&h->entries, e);
+	hash_index_insert(&h->index, key.hash, cast(u32)(h->entries.count-1));
 }
 
 template <typename T>
@@ -244,25 +177,18 @@ gb_inline void string_map_set(StringMap<T> *h, char const *key, T const &value)
 }
 
 
+// NOTE: Moves the last entry into the place of the erased one to keep the entries dense
 template <typename T>
 void string_map__erase(StringMap<T> *h, StringMapFindResult const &fr) {
-	StringMapFindResult last;
-	if (fr.entry_prev < 0) {
-		h->hashes.data[fr.hash_index] = h->entries.data[fr.entry_index].next;
-	} else {
-		h->entries.data[fr.entry_prev].next = h->entries.data[fr.entry_index].next;
-	}
-	if (fr.entry_index == h->entries.count-1) {
-		array_pop(&h->entries);
-		return;
-	}
-	h->entries.data[fr.entry_index] = h->entries.data[h->entries.count-1];
-	last = string_map__find(h, h->entries.data[fr.entry_index].key);
-	if (last.entry_prev >= 0) {
-		h->entries.data[last.entry_prev].next = fr.entry_index;
-	} else {
-		h->hashes.data[last.hash_index] = fr.entry_index;
+	hash_index_erase(&h->index, fr.hash_index);
+	isize last_index = h->entries.count-1;
+	if (fr.entry_index != last_index) {
+		StringMapEntry<T> *last = &h->entries.data[last_index];
+		isize slot = hash_index_slot_of_entry(&h->index, last->key.hash, cast(u32)last_index);
+		*hash_index_slot(&h->index, slot) = cast(u32)fr.entry_index;
+		h->entries.data[fr.entry_index] = *last;
 	}
+	array_pop(&h->entries);
 }
 
 template <typename T>
@@ -275,7 +201,7 @@ void string_map_remove(StringMap<T> *h, StringHashKey const &key) {
 
 template <typename T>
 gb_inline void string_map_clear(StringMap<T> *h) {
-	array_clear(&h->hashes);
+	hash_index_clear(&h->index);
 	array_clear(&h->entries);
 }
 
@@ -3,22 +3,158 @@
 #define WORKER_TASK_PROC(name) isize name(void *data)
 typedef WORKER_TASK_PROC(WorkerTaskProc);
 
+struct ThreadPoolTaskGroup;
+
 struct WorkerTask {
 	WorkerTaskProc *do_work;
 	void *data;
+	ThreadPoolTaskGroup *group;
 	isize result;
 };
 
+// NOTE: A group of tasks which can be waited upon with `thread_pool_wait_for`
+struct ThreadPoolTaskGroup {
+	std::atomic<isize> tasks_left;
+};
+
+
+// NOTE: Chase-Lev work stealing deque
+// The owning worker pushes and pops at the bottom, any other thread steals from the top
+// The fields of a slot are atomics as a thief may read a slot which is being reused,
+// in which case its compare-exchange on `top` fails and the read is discarded
+struct WorkerTaskSlot {
+	std::atomic<WorkerTaskProc *>      do_work;
+	std::atomic<void *>                data;
+	std::atomic<ThreadPoolTaskGroup *> group;
+};
+
+struct WorkerTaskDequeBuffer {
+	isize           mask;
+	WorkerTaskSlot *slots;
+};
+
+struct WorkerTaskDeque {
+	std::atomic<isize> top;
+	char pad0[64 - gb_size_of(std::atomic<isize>)];
+	std::atomic<isize> bottom;
+	std::atomic<WorkerTaskDequeBuffer *> buffer;
+
+	// NOTE: Old buffers may still be read by thieves, so they are only freed on destroy
+	Array<WorkerTaskDequeBuffer *> old_buffers;
+	gbAllocator allocator;
+};
+
+
+WorkerTaskDequeBuffer *worker_task_deque_buffer_make(gbAllocator a, isize capacity) {
+	GB_ASSERT(gb_is_power_of_two(capacity));
+	WorkerTaskDequeBuffer *b = gb_alloc_item(a, WorkerTaskDequeBuffer);
+	b->mask  = capacity-1;
+	b->slots = gb_alloc_array(a, WorkerTaskSlot, capacity);
+	return b;
+}
+
+void worker_task_deque_buffer_free(gbAllocator a, WorkerTaskDequeBuffer *b) {
+	gb_free(a, b->slots);
+	gb_free(a, b);
+}
+
+gb_inline void worker_task_slot_store(WorkerTaskDequeBuffer *b, isize index, WorkerTask const &task) {
+	WorkerTaskSlot *slot = &b->slots[index & b->mask];
+	slot->do_work.store(task.do_work, std::memory_order_relaxed);
+	slot->data.store(task.data, std::memory_order_relaxed);
+	slot->group.store(task.group, std::memory_order_relaxed);
+}
+
+gb_inline WorkerTask worker_task_slot_load(WorkerTaskDequeBuffer *b, isize index) {
+	WorkerTaskSlot *slot = &b->slots[index & b->mask];
+	WorkerTask task = {};
+	task.do_work = slot->do_work.load(std::memory_order_relaxed);
+	task.data    = slot->data.load(std::memory_order_relaxed);
+	task.group   = slot->group.load(std::memory_order_relaxed);
+	return task;
+}
+
+void worker_task_deque_init(WorkerTaskDeque *q, gbAllocator a, isize capacity) {
+	q->allocator = a;
+	q->top.store(0, std::memory_order_relaxed);
+	q->bottom.store(0, std::memory_order_relaxed);
+	q->buffer.store(worker_task_deque_buffer_make(a, next_pow2_isize(gb_max(capacity, 16))), std::memory_order_relaxed);
+	array_init(&q->old_buffers, a);
+}
+
+void worker_task_deque_destroy(WorkerTaskDeque *q) {
+	worker_task_deque_buffer_free(q->allocator, q->buffer.load(std::memory_order_relaxed));
+	for_array(i, q->old_buffers) {
+		worker_task_deque_buffer_free(q->allocator, q->old_buffers[i]);
+	}
+	array_free(&q->old_buffers);
+}
+
+// NOTE: Owner only
+void worker_task_deque_push(WorkerTaskDeque *q, WorkerTask const &task) {
+	isize b = q->bottom.load(std::memory_order_relaxed);
+	isize t = q->top.load(std::memory_order_acquire);
+	WorkerTaskDequeBuffer *buf = q->buffer.load(std::memory_order_relaxed);
+	if (b - t > buf->mask) {
+		WorkerTaskDequeBuffer *new_buf = worker_task_deque_buffer_make(q->allocator, 2*(buf->mask+1));
+		for (isize i = t; i < b; i++) {
+			worker_task_slot_store(new_buf, i, worker_task_slot_load(buf, i));
+		}
+		array_add(&q->old_buffers, buf);
+		q->buffer.store(new_buf, std::memory_order_release);
+		buf = new_buf;
+	}
+	worker_task_slot_store(buf, b, task);
+	std::atomic_thread_fence(std::memory_order_release);
+	q->bottom.store(b+1, std::memory_order_relaxed);
+}
+
+// NOTE: Owner only
+bool worker_task_deque_pop(WorkerTaskDeque *q, WorkerTask *task) {
+	isize b = q->bottom.load(std::memory_order_relaxed) - 1;
+	WorkerTaskDequeBuffer *buf = q->buffer.load(std::memory_order_relaxed);
+	q->bottom.store(b, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	isize t = q->top.load(std::memory_order_relaxed);
+	if (t > b) {
+		// NOTE: Empty
+		q->bottom.store(b+1, std::memory_order_relaxed);
+		return false;
+	}
+	*task = worker_task_slot_load(buf, b);
+	if (t == b) {
+		// NOTE: Last task, race against any thieves
+		bool ok = q->top.compare_exchange_strong(t, t+1, std::memory_order_seq_cst, std::memory_order_relaxed);
+		q->bottom.store(b+1, std::memory_order_relaxed);
+		return ok;
+	}
+	return true;
+}
+
+bool worker_task_deque_steal(WorkerTaskDeque *q, WorkerTask *task) {
+	isize t = q->top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	isize b = q->bottom.load(std::memory_order_acquire);
+	if (t >= b) {
+		return false;
+	}
+	WorkerTaskDequeBuffer *buf = q->buffer.load(std::memory_order_acquire);
+	*task = worker_task_slot_load(buf, t);
+	return q->top.compare_exchange_strong(t, t+1, std::memory_order_seq_cst, std::memory_order_relaxed);
+}
+
 
 struct ThreadPool {
-	gbMutex     mutex;
 	gbSemaphore sem_available;
-	gbAtomic32  processing_work_count;
+	std::atomic<isize> tasks_left;
 	bool        is_running;
 
 	gbAllocator allocator;
 
+	// NOTE: Tasks added from threads outside of the pool (e.g. the main thread)
 	MPMCQueue<WorkerTask> tasks;
+	// NOTE: One deque per worker thread, tasks added from within a worker go onto its own deque
+	WorkerTaskDeque *worker_tasks;
 
 	gbThread *threads;
 	isize thread_count;
@@ -27,11 +163,17 @@ struct ThreadPool {
 	i32 worker_prefix_len;
 };
 
+// NOTE: The pool and index of the worker running on the current thread, if any
+thread_local ThreadPool *thread_pool_current_pool = nullptr;
+thread_local isize       thread_pool_current_worker_index = -1;
+
 void thread_pool_init(ThreadPool *pool, gbAllocator const &a, isize thread_count, char const *worker_prefix = nullptr);
 void thread_pool_destroy(ThreadPool *pool);
 void thread_pool_start(ThreadPool *pool);
 void thread_pool_join(ThreadPool *pool);
-void thread_pool_add_task(ThreadPool *pool, WorkerTaskProc *proc, void *data);
+void thread_pool_add_task(ThreadPool *pool, WorkerTaskProc *proc, void *data, ThreadPoolTaskGroup *group = nullptr);
+void thread_pool_wait_for(ThreadPool *pool, ThreadPoolTaskGroup *group);
+void thread_pool_wait(ThreadPool *pool);
 GB_THREAD_PROC(worker_thread_internal);
 
 void thread_pool_init(ThreadPool *pool, gbAllocator const &a, isize thread_count, char const *worker_prefix) {
@@ -39,8 +181,12 @@ void thread_pool_init(ThreadPool *pool, gbAllocator const &a, isize thread_count
 	mpmc_init(&pool->tasks, a, 1024);
 	pool->thread_count = gb_max(thread_count, 0);
 	pool->threads = gb_alloc_array(a, gbThread, pool->thread_count);
-	gb_mutex_init(&pool->mutex);
+	pool->worker_tasks = gb_alloc_array(a, WorkerTaskDeque, pool->thread_count);
+	for (isize i = 0; i < pool->thread_count; i++) {
+		worker_task_deque_init(&pool->worker_tasks[i], a, 256);
+	}
 	gb_semaphore_init(&pool->sem_available);
+	pool->tasks_left.store(0);
 	pool->is_running = true;
 
 	pool->worker_prefix_len = 0;
@@ -67,6 +213,8 @@ void thread_pool_init(ThreadPool *pool, gbAllocator const &a, isize thread_count
 }
 
 void thread_pool_start(ThreadPool *pool) {
+	// NOTE: A pool may be started again once it has been joined by thread_pool_wait_to_process
+	pool->is_running = true;
 	for (isize i = 0; i < pool->thread_count; i++) {
 		gbThread *t = &pool->threads[i];
 		gb_thread_start(t, worker_thread_internal, pool);
@@ -91,78 +239,117 @@ void thread_pool_destroy(ThreadPool *pool) {
 	thread_pool_join(pool);
 
 	gb_semaphore_destroy(&pool->sem_available);
-	gb_mutex_destroy(&pool->mutex);
+	for (isize i = 0; i < pool->thread_count; i++) {
+		worker_task_deque_destroy(&pool->worker_tasks[i]);
+	}
+	gb_free(pool->allocator, pool->worker_tasks);
 	gb_free(pool->allocator, pool->threads);
 	pool->thread_count = 0;
 	mpmc_destroy(&pool->tasks);
 }
 
 
-void thread_pool_add_task(ThreadPool *pool, WorkerTaskProc *proc, void *data) {
-	gb_mutex_lock(&pool->mutex);
-
+void thread_pool_add_task(ThreadPool *pool, WorkerTaskProc *proc, void *data, ThreadPoolTaskGroup *group) {
 	WorkerTask task = {};
 	task.do_work = proc;
 	task.data = data;
+	task.group = group;
+
+	if (group != nullptr) {
+		group->tasks_left.fetch_add(1, std::memory_order_relaxed);
+	}
+	pool->tasks_left.fetch_add(1, std::memory_order_relaxed);
 
-	mpmc_enqueue(&pool->tasks, task);
+	if (thread_pool_current_pool == pool && thread_pool_current_worker_index >= 0) {
+		// NOTE: Nested work from within a worker does not contend with any other thread
+		worker_task_deque_push(&pool->worker_tasks[thread_pool_current_worker_index], task);
+	} else {
+		mpmc_enqueue(&pool->tasks, task);
+	}
 	gb_semaphore_post(&pool->sem_available, 1);
-	gb_mutex_unlock(&pool->mutex);
 }
 
 bool thread_pool_try_and_pop_task(ThreadPool *pool, WorkerTask *task) {
-	bool got_task = false;
+	isize index = -1;
+	if (thread_pool_current_pool == pool) {
+		index = thread_pool_current_worker_index;
+	}
+	if (index >= 0 && worker_task_deque_pop(&pool->worker_tasks[index], task)) {
+		return true;
+	}
 	if (mpmc_dequeue(&pool->tasks, task)) {
-		gb_atomic32_fetch_add(&pool->processing_work_count, +1);
-		got_task = true;
+		return true;
 	}
-	return got_task;
+	// NOTE: Steal from the other workers, starting from the next one along
+	isize count = pool->thread_count;
+	for (isize i = 1; i <= count; i++) {
+		isize victim = (index + i) % count;
+		if (victim < 0) {
+			victim += count;
+		}
+		if (victim != index && worker_task_deque_steal(&pool->worker_tasks[victim], task)) {
+			return true;
+		}
+	}
+	return false;
 }
 void thread_pool_do_work(ThreadPool *pool, WorkerTask *task) {
 	task->result = task->do_work(task->data);
-	gb_atomic32_fetch_add(&pool->processing_work_count, -1);
+	if (task->group != nullptr) {
+		task->group->tasks_left.fetch_sub(1, std::memory_order_release);
+	}
+	pool->tasks_left.fetch_sub(1, std::memory_order_release);
 }
 
-void thread_pool_wait_to_process(ThreadPool *pool) {
-	if (pool->thread_count == 0) {
+// NOTE: Help process the tasks of the pool until all the tasks within the group have been completed
+// This may be called from within a worker, and does not join the threads of the pool
+void thread_pool_wait_for(ThreadPool *pool, ThreadPoolTaskGroup *group) {
+	while (group->tasks_left.load(std::memory_order_acquire) > 0) {
 		WorkerTask task = {};
-		while (thread_pool_try_and_pop_task(pool, &task)) {
+		if (thread_pool_try_and_pop_task(pool, &task)) {
 			thread_pool_do_work(pool, &task);
+		} else {
+			gb_yield();
 		}
-		return;
 	}
-	while (pool->tasks.count.load(std::memory_order_relaxed) > 0 || gb_atomic32_load(&pool->processing_work_count) != 0) {
+}
+
+// NOTE: Help process the tasks of the pool until all of them have been completed
+// The threads of the pool keep running, so the pool (and the per-thread state of its workers) can be reused
+void thread_pool_wait(ThreadPool *pool) {
+	while (pool->tasks_left.load(std::memory_order_acquire) > 0) {
 		WorkerTask task = {};
 		if (thread_pool_try_and_pop_task(pool, &task)) {
 			thread_pool_do_work(pool, &task);
+		} else {
+			gb_yield();
 		}
-
-		// Safety-kick
-		while (pool->tasks.count.load(std::memory_order_relaxed) > 0 && gb_atomic32_load(&pool->processing_work_count) == 0) {
-			gb_mutex_lock(&pool->mutex);
-			gb_semaphore_post(&pool->sem_available, cast(i32)pool->tasks.count.load(std::memory_order_relaxed));
-			gb_mutex_unlock(&pool->mutex);
-		}
-
-		gb_yield();
 	}
+}
 
+void thread_pool_wait_to_process(ThreadPool *pool) {
+	thread_pool_wait(pool);
 	thread_pool_join(pool);
 }
 
 
 GB_THREAD_PROC(worker_thread_internal) {
 	ThreadPool *pool = cast(ThreadPool *)thread->user_data;
-	while (pool->is_running) {
-		gb_semaphore_wait(&pool->sem_available);
+	thread_pool_current_pool = pool;
+	thread_pool_current_worker_index = thread->user_index;
 
+	while (pool->is_running) {
 		WorkerTask task = {};
 		if (thread_pool_try_and_pop_task(pool, &task)) {
 			thread_pool_do_work(pool, &task);
+			continue;
 		}
+		gb_semaphore_wait(&pool->sem_available);
 	}
 	// Cascade
 	gb_semaphore_release(&pool->sem_available);
 
+	thread_pool_current_pool = nullptr;
+	thread_pool_current_worker_index = -1;
 	return 0;
 }
@@ -203,3 +203,179 @@ void timings_print_all(Timings *t, TimingUnit unit = TimingUnit_Millisecond) {
 		          100.0*section_time/total_time);
 	}
 }
+
+
+// NOTE: Per-thread spans for -trace-file:<path>, written out as Chrome Trace Event JSON
+// which can be viewed with chrome://tracing or https://ui.perfetto.dev
+// Each thread appends to its own buffer so that recording a span never takes a lock
+
+struct TraceSpan {
+	u64    start;
+	u64    finish;
+	String name;
+	String arg; // file or procedure name
+};
+
+struct TraceThreadBuffer {
+	u32              thread_id;
+	Array<TraceSpan> spans;
+};
+
+struct TraceState {
+	bool                        enabled;
+	u64                         start;
+	gbMutex                     mutex;
+	Array<TraceThreadBuffer *>  buffers;
+};
+
+gb_global TraceState trace_state = {};
+thread_local TraceThreadBuffer *trace_thread_buffer = nullptr;
+
+void trace_init(void) {
+	trace_state.enabled = true;
+	trace_state.start = time_stamp_time_now();
+	gb_mutex_init(&trace_state.mutex);
+	array_init(&trace_state.buffers, heap_allocator());
+}
+
+TraceThreadBuffer *trace_get_thread_buffer(void) {
+	TraceThreadBuffer *buffer = trace_thread_buffer;
+	if (buffer == nullptr) {
+		buffer = gb_alloc_item(heap_allocator(), TraceThreadBuffer);
+		buffer->thread_id = gb_thread_current_id();
+		array_init(&buffer->spans, heap_allocator(), 0, 1024);
+
+		gb_mutex_lock(&trace_state.mutex);
+		array_add(&trace_state.buffers, buffer);
+		gb_mutex_unlock(&trace_state.mutex);
+
+		trace_thread_buffer = buffer;
+	}
+	return buffer;
+}
+
+void trace_add_span(String const &name, String const &arg, u64 start, u64 finish) {
+	if (!trace_state.enabled) {
+		return;
+	}
+	TraceSpan span = {start, finish, name, arg};
+	array_add(&trace_get_thread_buffer()->spans, span);
+}
+
+struct TraceScope {
+	String name;
+	String arg;
+	u64    start;
+
+	TraceScope(String const &name_, String const &arg_) {
+		if (trace_state.enabled) {
+			name  = name_;
+			arg   = arg_;
+			start = time_stamp_time_now();
+		}
+	}
+	~TraceScope() {
+		if (trace_state.enabled) {
+			trace_add_span(name, arg, start, time_stamp_time_now());
+		}
+	}
+};
+
+#define TRACE__CONCAT_(a, b) a##b
+#define TRACE__CONCAT(a, b)  TRACE__CONCAT_(a, b)
+// NOTE: TRACE_SCOPE(name, arg) records a span for the rest of the enclosing scope when -trace-file is set
+#define TRACE_SCOPE(...) TraceScope TRACE__CONCAT(trace_scope_, __LINE__)(__VA_ARGS__)
+
+
+void trace__write_json_string(gbFile *f, String const &s) {
+	gb_fprintf(f, "\"");
+	for (isize i = 0; i < s.len; i++) {
+		u8 c = s.text[i];
+		switch (c) {
+		case '"':  gb_fprintf(f, "\\\""); break;
+		case '\\': gb_fprintf(f, "\\\\"); break;
+		case '\n': gb_fprintf(f, "\\n");  break;
+		case '\t': gb_fprintf(f, "\\t");  break;
+		default:
+			if (c < 0x20) {
+				gb_fprintf(f, "\\u%04x", c);
+			} else {
+				gb_file_write(f, &c, 1);
+			}
+			break;
+		}
+	}
+	gb_fprintf(f, "\"");
+}
+
+f64 trace__time_us(u64 t, u64 freq) {
+	if (t < trace_state.start) {
+		return 0;
+	}
+	return 1000000.0*cast(f64)(t - trace_state.start)/cast(f64)freq;
+}
+
+void trace__write_span(gbFile *f, bool *first, u32 thread_id, TraceSpan const &span, u64 freq) {
+	if (span.finish < span.start) {
+		return;
+	}
+	gb_fprintf(f, "%s\n{\"name\":", *first ? "" : ",");
+	*first = false;
+	trace__write_json_string(f, span.name);
+	gb_fprintf(f, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+	           thread_id,
+	           trace__time_us(span.start, freq),
+	           trace__time_us(span.finish, freq) - trace__time_us(span.start, freq));
+	if (span.arg.len > 0) {
+		gb_fprintf(f, ",\"args\":{\"name\":");
+		trace__write_json_string(f, span.arg);
+		gb_fprintf(f, "}");
+	}
+	gb_fprintf(f, "}");
+}
+
+// NOTE: The sections of the main timings become spans of the main thread
+bool trace_write_file(String const &path, Timings *t) {
+	timings__stop_current_section(t);
+	t->total.finish = time_stamp_time_now();
+
+	char *cpath = alloc_cstring(heap_allocator(), path);
+	defer (gb_free(heap_allocator(), cpath));
+
+	gbFile f = {};
+	if (gb_file_create(&f, cpath) != gbFileError_None) {
+		return false;
+	}
+	defer (gb_file_close(&f));
+
+	u64 freq = t->freq;
+	trace_state.start = gb_min(trace_state.start, t->total.start);
+	u32 main_thread_id = gb_thread_current_id();
+	bool first = true;
+
+	gb_fprintf(&f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+	gb_fprintf(&f, "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"main\"}}", main_thread_id);
+	first = false;
+
+	trace__write_span(&f, &first, main_thread_id, TraceSpan{t->total.start, t->total.finish, t->total.label, {}}, freq);
+	for_array(i, t->sections) {
+		TimeStamp const &ts = t->sections[i];
+		trace__write_span(&f, &first, main_thread_id, TraceSpan{ts.start, ts.finish, ts.label, {}}, freq);
+	}
+
+	gb_mutex_lock(&trace_state.mutex);
+	for_array(i, trace_state.buffers) {
+		TraceThreadBuffer *buffer = trace_state.buffers[i];
+		if (buffer->thread_id != main_thread_id) {
+			gb_fprintf(&f, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"worker %d\"}}", buffer->thread_id, cast(int)i);
+		}
+		for_array(j, buffer->spans) {
+			trace__write_span(&f, &first, buffer->thread_id, buffer->spans[j], freq);
+		}
+	}
+	gb_mutex_unlock(&trace_state.mutex);
+
+	gb_fprintf(&f, "\n]}\n");
+	return true;
+}
@@ -0,0 +1,249 @@
+// NOTE: An opt-in on-disk cache of tokenized files (-cache-dir:<path>)
+// Each entry is keyed by the file's path, size, id (e.g. inode) and last write time, and by the compiler version,
+// so unchanged files (e.g. core and vendored packages) do not need to be read and tokenized again.
+// Each unique identifier of a file is stored once with its hash, so it is only interned once when loaded
+//
+// Layout of a cache entry:
+//     TokenCacheHeader
+//     TokenCacheEntry[header.token_count]
+//     TokenCacheIdent[header.ident_count]
+
+#define TOKEN_CACHE_MAGIC   0x4b54444f // "ODTK"
+#define TOKEN_CACHE_VERSION 2
+
+// NOTE: A file written this recently may still be written again with the same last write time,
+// so its tokens are not stored
+enum : u64 {TOKEN_CACHE_MIN_FILE_AGE = 2000000}; // microseconds
+
+struct TokenCacheHeader {
+	u32 magic;
+	u32 version;
+	u64 compiler_hash;
+	u64 file_key;
+	i64 content_size;
+	u32 tokenizer_flags;
+	u32 token_count;
+	u32 ident_count;
+	i32 line_count; // NOTE: The tokenizer's line count, which is not recomputed on a cache hit
+};
+
+// NOTE: A `PackedToken` without the pointer to the interned identifier,
+// an identifier's `length` is its index into the `TokenCacheIdent` table
+struct TokenCacheEntry {
+	u8  kind;
+	u8  flags;
+	u16 padding;
+	i32 offset;
+	i32 length;
+};
+
+struct TokenCacheIdent {
+	u64 hash; // NOTE: The same as `StringIntern::hash`
+	i32 offset;
+	i32 length;
+};
+
+gb_global u64 token_cache_compiler_hash = 0;
+
+u64 token_cache_get_compiler_hash(void) {
+	if (token_cache_compiler_hash == 0) {
+		// NOTE: Any change to the compiler or token layout must invalidate the cache
+		u64 h = fnv64a(ODIN_VERSION.text, ODIN_VERSION.len);
+	#if defined(GIT_SHA)
+		h ^= fnv64a(GIT_SHA, gb_strlen(GIT_SHA));
+	#endif
+		u32 layout[4] = {TOKEN_CACHE_VERSION, Token_Count, gb_size_of(TokenCacheEntry), gb_size_of(PackedToken)};
+		h ^= fnv64a(layout, gb_size_of(layout));
+		token_cache_compiler_hash = h;
+	}
+	return token_cache_compiler_hash;
+}
+
+// NOTE: Returns 0 if the file cannot be cached, e.g. it was not read from a regular file
+u64 token_cache_file_key(AstFile *f, TokenizerFlags flags) {
+	LoadedFile const *file = &f->tokenizer.loaded_file;
+	if (file->last_write_time == 0) {
+		return 0;
+	}
+	u64 h = fnv64a(f->fullpath.text, f->fullpath.len);
+	u64 values[4] = {cast(u64)file->size, file->file_id, file->last_write_time, cast(u64)flags};
+	h ^= fnv64a(values, gb_size_of(values)) * 0x100000001b3ull;
+	return h ? h : 1;
+}
+
+String token_cache_path(u64 file_key) {
+	String dir = build_context.cache_dir;
+	isize len = dir.len + 1 + 16 + 1 + 16 + 4 + 1;
+	char *text = gb_alloc_array(heap_allocator(), char, len);
+	len = gb_snprintf(text, len, "%.*s/%016llx-%016llx.tok", LIT(dir),
+		cast(unsigned long long)file_key,
+		cast(unsigned long long)token_cache_get_compiler_hash());
+	return make_string(cast(u8 *)text, len-1);
+}
+
+bool token_cache_load(AstFile *f, TokenizerFlags flags) {
+	if (build_context.cache_dir.len == 0) {
+		return false;
+	}
+	u64 file_key = token_cache_file_key(f, flags);
+	if (file_key == 0) {
+		return false;
+	}
+	Tokenizer *t = &f->tokenizer;
+	isize content_size = t->end - t->start;
+
+	String path = token_cache_path(file_key);
+	defer (gb_free(heap_allocator(), path.text));
+
+	LoadedFile cache_file = {};
+	if (load_file(cast(char const *)path.text, &cache_file) != LoadedFile_None) {
+		return false;
+	}
+	defer (unload_file(&cache_file));
+
+	if (cache_file.size < gb_size_of(TokenCacheHeader)) {
+		return false;
+	}
+	TokenCacheHeader const *header = cast(TokenCacheHeader const *)cache_file.data;
+	if (header->magic != TOKEN_CACHE_MAGIC ||
+	    header->version != TOKEN_CACHE_VERSION ||
+	    header->compiler_hash != token_cache_get_compiler_hash() ||
+	    header->file_key != file_key ||
+	    header->content_size != content_size ||
+	    header->tokenizer_flags != cast(u32)flags ||
+	    header->token_count == 0 ||
+	    header->line_count <= 0) {
+		return false;
+	}
+	isize entries_size = cast(isize)header->token_count * gb_size_of(TokenCacheEntry);
+	isize idents_size  = cast(isize)header->ident_count * gb_size_of(TokenCacheIdent);
+	if (cache_file.size != gb_size_of(TokenCacheHeader) + entries_size + idents_size) {
+		return false;
+	}
+
+	TokenCacheEntry const *entries = cast(TokenCacheEntry const *)(header+1);
+	TokenCacheIdent const *idents  = cast(TokenCacheIdent const *)(entries+header->token_count);
+
+	StringIntern **interns = gb_alloc_array(heap_allocator(), StringIntern *, header->ident_count);
+	defer (gb_free(heap_allocator(), interns));
+	for (u32 i = 0; i < header->ident_count; i++) {
+		TokenCacheIdent const *ident = &idents[i];
+		if (ident->offset < 0 || ident->length < 0 || ident->offset+ident->length > content_size) {
+			return false;
+		}
+		interns[i] = string_intern_entry(cast(char const *)t->start + ident->offset, ident->length, ident->hash);
+	}
+
+	array_resize(&f->tokens, header->token_count);
+	for (u32 i = 0; i < header->token_count; i++) {
+		TokenCacheEntry const *entry = &entries[i];
+		PackedToken *token = &f->tokens[i];
+		bool in_range = 0 <= entry->offset && 0 <= entry->length && entry->offset <= content_size;
+		if (entry->flags & PackedTokenFlag_Interned) {
+			in_range = in_range && entry->length < cast(i64)header->ident_count;
+		} else if ((entry->flags & PackedTokenFlag_Newline) == 0) {
+			in_range = in_range && entry->offset+entry->length <= content_size;
+		}
+		if (entry->kind >= Token_Count || !in_range) {
+			array_clear(&f->tokens);
+			return false;
+		}
+		*token = {};
+		token->kind   = entry->kind;
+		token->flags  = entry->flags;
+		token->offset = entry->offset;
+		if (token->flags & PackedTokenFlag_Interned) {
+			token->intern = interns[entry->length];
+		} else {
+			token->length = entry->length;
+		}
+	}
+
+	if (f->tokens[f->tokens.count-1].kind != Token_EOF) {
+		array_clear(&f->tokens);
+		return false;
+	}
+	t->line_count = header->line_count;
+	return true;
+}
+
+void token_cache_store(AstFile *f, TokenizerFlags flags) {
+	if (build_context.cache_dir.len == 0) {
+		return;
+	}
+	Tokenizer *t = &f->tokenizer;
+	if (t->error_count != 0 || t->warning_count != 0) {
+		// NOTE: Diagnostics would be lost when loading from the cache
+		return;
+	}
+	u64 file_key = token_cache_file_key(f, flags);
+	if (file_key == 0 || gb_utc_time_now() < t->loaded_file.last_write_time + TOKEN_CACHE_MIN_FILE_AGE) {
+		return;
+	}
+	isize content_size = t->end - t->start;
+
+	TokenCacheHeader header = {};
+	header.magic           = TOKEN_CACHE_MAGIC;
+	header.version         = TOKEN_CACHE_VERSION;
+	header.compiler_hash   = token_cache_get_compiler_hash();
+	header.file_key        = file_key;
+	header.content_size    = content_size;
+	header.tokenizer_flags = cast(u32)flags;
+	header.token_count     = cast(u32)f->tokens.count;
+	header.line_count      = t->line_count;
+
+	isize entries_size = f->tokens.count * gb_size_of(TokenCacheEntry);
+	TokenCacheEntry *entries = gb_alloc_array(heap_allocator(), TokenCacheEntry, f->tokens.count);
+	defer (gb_free(heap_allocator(), entries));
+
+	auto idents = array_make<TokenCacheIdent>(heap_allocator(), 0, f->tokens.count/4 + 1);
+	defer (array_free(&idents));
+	Map<i32> ident_indices = {}; // Key: StringIntern *
+	map_init(&ident_indices, heap_allocator());
+	defer (map_destroy(&ident_indices));
+
+	for_array(i, f->tokens) {
+		PackedToken const *token = &f->tokens[i];
+		TokenCacheEntry *entry = &entries[i];
+		*entry = {};
+		entry->kind   = token->kind;
+		entry->flags  = token->flags;
+		entry->offset = token->offset;
+		if (token->flags & PackedTokenFlag_Interned) {
+			i32 *found = map_get(&ident_indices, hash_pointer(token->intern));
+			if (found != nullptr) {
+				entry->length = *found;
+			} else {
+				// NOTE: The identifier is the same text in the source, starting at the token
+				TokenCacheIdent ident = {token->intern->hash, token->offset, cast(i32)token->intern->len};
+				entry->length = cast(i32)idents.count;
+				map_set(&ident_indices, hash_pointer(token->intern), entry->length);
+				array_add(&idents, ident);
+			}
+		} else {
+			entry->length = token->length;
+		}
+	}
+	header.ident_count = cast(u32)idents.count;
+
+	String path = token_cache_path(file_key);
+	defer (gb_free(heap_allocator(), path.text));
+
+	// NOTE: Write to a temporary file and then move it into place, so that other threads
+	// or compiler processes never see a partially written entry
+	char tmp_path[1024] = {};
+	gb_snprintf(tmp_path, gb_size_of(tmp_path), "%.*s.%u.%d", LIT(path), gb_thread_current_id(), f->id);
+
+	gbFile file = {};
+	if (gb_file_create(&file, tmp_path) != gbFileError_None) {
+		return;
+	}
+	bool ok = gb_file_write(&file, &header, gb_size_of(header)) &&
+	          gb_file_write(&file, entries, entries_size) &&
+	          gb_file_write(&file, idents.data, idents.count*gb_size_of(TokenCacheIdent));
+	gb_file_close(&file);
+
+	if (!ok || !gb_file_move(tmp_path, cast(char const *)path.text)) {
+		gb_file_remove(tmp_path);
+	}
+}
@@ -236,9 +236,10 @@ TokenPos token_pos_add_column(TokenPos pos) {
 }
 
 struct Token {
-	TokenKind kind;
-	String    string;
-	TokenPos  pos;
+	TokenKind      kind;
+	String         string;
+	TokenPos       pos;
+	StringIntern * intern; // NOTE: Only set for identifiers by the tokenizer, see `token_hash_key`
 };
 
 Token empty_token = {Token_Invalid};
@@ -253,6 +254,16 @@ Token make_token_ident(char const *s) {
 	return t;
 }
 
+// NOTE: Identifiers from the tokenizer are interned, so their hash does not need to be calculated again
+// If the string of the token has been changed since, the hash is calculated from that string
+gb_inline StringHashKey token_hash_key(Token const &token) {
+	StringIntern const *intern = token.intern;
+	if (intern != nullptr && token.string.text == cast(u8 const *)intern->str && token.string.len == intern->len) {
+		return string_intern_hash_key(intern);
+	}
+	return string_hash_string(token.string);
+}
+
 bool token_is_newline(Token const &tok) {
 	return tok.kind == Token_Semicolon && tok.string == "\n";
 }
@@ -274,6 +285,22 @@ struct ErrorCollector {
 
 gb_global ErrorCollector global_error_collector;
 
+// NOTE: Diagnostics which are kept rather than written out, so that the diagnostics of several threads
+// can be written out in a deterministic order, sorted by position, with `error_deferred_flush`
+struct ErrorDeferredDiagnostic {
+	TokenPos pos;
+	isize    index; // NOTE: Keeps the order of diagnostics at the same position
+	gbString text;
+};
+
+struct ErrorDeferredBuffer {
+	TokenPos prev;
+	Array<ErrorDeferredDiagnostic> diagnostics;
+};
+
+// NOTE: The buffer which the diagnostics of the current thread are kept in, if any
+thread_local ErrorDeferredBuffer *error_deferred_buffer = nullptr;
+
 #define MAX_ERROR_COLLECTOR_COUNT (36)
 
 
@@ -378,6 +405,103 @@ void end_error_block(void) {
 }
 
 
+void error_deferred_init(ErrorDeferredBuffer *b) {
+	b->prev = {};
+	array_init(&b->diagnostics, heap_allocator());
+}
+
+void error_deferred_destroy(ErrorDeferredBuffer *b) {
+	for_array(i, b->diagnostics) {
+		gb_string_free(b->diagnostics[i].text);
+	}
+	array_free(&b->diagnostics);
+}
+
+// NOTE: Starts a new diagnostic, which any following output belongs to
+void error_out_begin(TokenPos const &pos) {
+	if (error_deferred_buffer != nullptr) {
+		ErrorDeferredDiagnostic d = {};
+		d.pos  = pos;
+		d.text = gb_string_make(heap_allocator(), "");
+		array_add(&error_deferred_buffer->diagnostics, d);
+	}
+}
+
+// NOTE: The previous position is per buffer, so that skipping duplicates does not depend upon other threads
+TokenPos *error_prev_pos(void) {
+	if (error_deferred_buffer != nullptr) {
+		return &error_deferred_buffer->prev;
+	}
+	return &global_error_collector.prev;
+}
+
+GB_COMPARE_PROC(error_deferred_diagnostic_cmp) {
+	ErrorDeferredDiagnostic const *x = *cast(ErrorDeferredDiagnostic const **)a;
+	ErrorDeferredDiagnostic const *y = *cast(ErrorDeferredDiagnostic const **)b;
+	i32 cmp = string_compare(get_file_path_string(x->pos.file_id), get_file_path_string(y->pos.file_id));
+	if (cmp != 0) {
+		return cmp;
+	}
+	if (x->pos.line != y->pos.line) {
+		return x->pos.line < y->pos.line ? -1 : +1;
+	}
+	if (x->pos.column != y->pos.column) {
+		return x->pos.column < y->pos.column ? -1 : +1;
+	}
+	if (x->index != y->index) {
+		return x->index < y->index ? -1 : +1;
+	}
+	return 0;
+}
+
+// NOTE: Writes out the diagnostics of every buffer, sorted by their position, and then clears the buffers
+void error_deferred_flush(ErrorDeferredBuffer **buffers, isize buffer_count) {
+	isize count = 0;
+	for (isize i = 0; i < buffer_count; i++) {
+		count += buffers[i]->diagnostics.count;
+	}
+	if (count == 0) {
+		return;
+	}
+
+	auto sorted = array_make<ErrorDeferredDiagnostic *>(heap_allocator(), 0, count);
+	defer (array_free(&sorted));
+	for (isize i = 0; i < buffer_count; i++) {
+		for_array(j, buffers[i]->diagnostics) {
+			ErrorDeferredDiagnostic *d = &buffers[i]->diagnostics[j];
+			d->index = sorted.count;
+			array_add(&sorted, d);
+		}
+	}
+	gb_sort_array(sorted.data, sorted.count, error_deferred_diagnostic_cmp);
+
+	gbFile *f = gb_file_get_standard(gbFileStandard_Error);
+	mutex_lock(&global_error_collector.error_out_mutex);
+	for_array(i, sorted) {
+		gbString text = sorted[i]->text;
+		isize n = gb_string_length(text);
+		if (n == 0) {
+			continue;
+		}
+		u8 *data = gb_alloc_array(heap_allocator(), u8, n+1);
+		gb_memmove(data, text, n);
+		data[n] = 0;
+		array_add(&global_error_collector.errors, make_string(data, n));
+		gb_file_write(f, text, n);
+	}
+	mutex_unlock(&global_error_collector.error_out_mutex);
+
+	for (isize i = 0; i < buffer_count; i++) {
+		error_deferred_destroy(buffers[i]);
+		error_deferred_init(buffers[i]);
+	}
+
+	if (global_error_collector.count > MAX_ERROR_COLLECTOR_COUNT) {
+		gb_exit(1);
+	}
+}
+
+
 #define ERROR_OUT_PROC(name) void name(char const *fmt, va_list va)
 typedef ERROR_OUT_PROC(ErrorOutProc);
 
@@ -387,6 +511,15 @@ ERROR_OUT_PROC(default_error_out_va) {
 	char buf[4096] = {};
 	isize len = gb_snprintf_va(buf, gb_size_of(buf), fmt, va);
 	isize n = len-1;
+	if (error_deferred_buffer != nullptr) {
+		auto *diagnostics = &error_deferred_buffer->diagnostics;
+		if (diagnostics->count == 0) {
+			error_out_begin({});
+		}
+		gbString *text = &(*diagnostics)[diagnostics->count-1].text;
+		*text = gb_string_append_length(*text, buf, n);
+		return;
+	}
 	if (global_error_collector.in_block) {
 		isize cap = global_error_collector.error_buffer.count + n;
 		array_reserve(&global_error_collector.error_buffer, cap);
@@ -496,16 +629,18 @@ void error_va(TokenPos const &pos, TokenPos end, char const *fmt, va_list va) {
 	global_error_collector.count++;
 	// NOTE(bill): Duplicate error, skip it
 	if (pos.line == 0) {
+		error_out_begin(pos);
 		error_out("Error: %s\n", gb_bprintf_va(fmt, va));
-	} else if (global_error_collector.prev != pos) {
-		global_error_collector.prev = pos;
+	} else if (*error_prev_pos() != pos) {
+		*error_prev_pos() = pos;
+		error_out_begin(pos);
 		error_out("%s %s\n",
 		          token_pos_to_string(pos),
 		          gb_bprintf_va(fmt, va));
 		show_error_on_line(pos, end);
 	}
 	mutex_unlock(&global_error_collector.mutex);
-	if (global_error_collector.count > MAX_ERROR_COLLECTOR_COUNT) {
+	if (error_deferred_buffer == nullptr && global_error_collector.count > MAX_ERROR_COLLECTOR_COUNT) {
 		gb_exit(1);
 	}
 }
@@ -520,9 +655,11 @@ void warning_va(TokenPos const &pos, TokenPos end, char const *fmt, va_list va)
 	if (!global_ignore_warnings()) {
 		// NOTE(bill): Duplicate error, skip it
 		if (pos.line == 0) {
+			error_out_begin(pos);
 			error_out("Warning: %s\n", gb_bprintf_va(fmt, va));
-		} else if (global_error_collector.prev != pos) {
-			global_error_collector.prev = pos;
+		} else if (*error_prev_pos() != pos) {
+			*error_prev_pos() = pos;
+			error_out_begin(pos);
 			error_out("%s Warning: %s\n",
 			          token_pos_to_string(pos),
 			          gb_bprintf_va(fmt, va));
@@ -542,15 +679,17 @@ void error_no_newline_va(TokenPos const &pos, char const *fmt, va_list va) {
 	global_error_collector.count++;
 	// NOTE(bill): Duplicate error, skip it
 	if (pos.line == 0) {
+		error_out_begin(pos);
 		error_out("Error: %s", gb_bprintf_va(fmt, va));
-	} else if (global_error_collector.prev != pos) {
-		global_error_collector.prev = pos;
+	} else if (*error_prev_pos() != pos) {
+		*error_prev_pos() = pos;
+		error_out_begin(pos);
 		error_out("%s %s",
 		          token_pos_to_string(pos),
 		          gb_bprintf_va(fmt, va));
 	}
 	mutex_unlock(&global_error_collector.mutex);
-	if (global_error_collector.count > MAX_ERROR_COLLECTOR_COUNT) {
+	if (error_deferred_buffer == nullptr && global_error_collector.count > MAX_ERROR_COLLECTOR_COUNT) {
 		gb_exit(1);
 	}
 }
@@ -560,18 +699,20 @@ void syntax_error_va(TokenPos const &pos, TokenPos end, char const *fmt, va_list
 	mutex_lock(&global_error_collector.mutex);
 	global_error_collector.count++;
 	// NOTE(bill): Duplicate error, skip it
-	if (global_error_collector.prev != pos) {
-		global_error_collector.prev = pos;
+	if (*error_prev_pos() != pos) {
+		*error_prev_pos() = pos;
+		error_out_begin(pos);
 		error_out("%s Syntax Error: %s\n",
 		          token_pos_to_string(pos),
 		          gb_bprintf_va(fmt, va));
 		show_error_on_line(pos, end);
 	} else if (pos.line == 0) {
+		error_out_begin(pos);
 		error_out("Syntax Error: %s\n", gb_bprintf_va(fmt, va));
 	}
 
 	mutex_unlock(&global_error_collector.mutex);
-	if (global_error_collector.count > MAX_ERROR_COLLECTOR_COUNT) {
+	if (error_deferred_buffer == nullptr && global_error_collector.count > MAX_ERROR_COLLECTOR_COUNT) {
 		gb_exit(1);
 	}
 }
@@ -585,13 +726,15 @@ void syntax_warning_va(TokenPos const &pos, TokenPos end, char const *fmt, va_li
 	global_error_collector.warning_count++;
 	if (!global_ignore_warnings()) {
 		// NOTE(bill): Duplicate error, skip it
-		if (global_error_collector.prev != pos) {
-			global_error_collector.prev = pos;
+		if (*error_prev_pos() != pos) {
+			*error_prev_pos() = pos;
+			error_out_begin(pos);
 			error_out("%s Syntax Warning: %s\n",
 			          token_pos_to_string(pos),
 			          gb_bprintf_va(fmt, va));
 			show_error_on_line(pos, end);
 		} else if (pos.line == 0) {
+			error_out_begin(pos);
 			error_out("Warning: %s\n", gb_bprintf_va(fmt, va));
 		}
 	}
@@ -707,16 +850,19 @@ enum TokenizerFlags {
 struct Tokenizer {
 	i32 curr_file_id;
 	String fullpath;
+	LoadedFile loaded_file;
 	u8 *start;
 	u8 *end;
 
 	Rune  curr_rune;   // current character
 	u8 *  curr;        // character pos
 	u8 *  read_curr;   // pos from start
+	u8 *  line_start;  // start of the current line
 	i32   column_minus_one;
 	i32   line_count;
 
 	i32 error_count;
+	i32 warning_count;
 
 	TokenizerFlags flags;
 	bool insert_semicolon;
@@ -758,11 +904,12 @@ void tokenizer_err(Tokenizer *t, TokenPos const &pos, char const *msg, ...) {
 
 void advance_to_next_rune(Tokenizer *t) {
 	if (t->curr_rune == '\n') {
-		t->column_minus_one = 0;
 		t->line_count++;
+		t->line_start = t->read_curr;
 	}
 	if (t->read_curr < t->end) {
 		t->curr = t->read_curr;
+		t->column_minus_one = cast(i32)(t->curr - t->line_start);
 		Rune rune = *t->read_curr;
 		if (rune == 0) {
 			tokenizer_err(t, "Illegal character NUL");
@@ -781,18 +928,20 @@ void advance_to_next_rune(Tokenizer *t) {
 		t->curr_rune = rune;
 	} else {
 		t->curr = t->end;
+		t->column_minus_one = cast(i32)(t->curr - t->line_start);
 		t->curr_rune = GB_RUNE_EOF;
 	}
 }
 
-void init_tokenizer_with_file_contents(Tokenizer *t, String const &fullpath, gbFileContents *fc, TokenizerFlags flags) {
+void init_tokenizer_with_data(Tokenizer *t, String const &fullpath, void const *data, isize size, TokenizerFlags flags) {
 	t->flags = flags;
 	t->fullpath = fullpath;
 	t->line_count = 1;
 
-	t->start = cast(u8 *)fc->data;
+	t->start = cast(u8 *)data;
 	t->read_curr = t->curr = t->start;
-	t->end = t->start + fc->size;
+	t->line_start = t->start;
+	t->end = t->start + size;
 
 	advance_to_next_rune(t);
 	if (t->curr_rune == GB_RUNE_BOM) {
@@ -801,48 +950,130 @@ void init_tokenizer_with_file_contents(Tokenizer *t, String const &fullpath, gbF
 }
 
 TokenizerInitError init_tokenizer(Tokenizer *t, String const &fullpath, TokenizerFlags flags = TokenizerFlag_None) {
-	TokenizerInitError err = TokenizerInit_None;
-
 	char *c_str = alloc_cstring(heap_allocator(), fullpath);
 	defer (gb_free(heap_allocator(), c_str));
 
-	// TODO(bill): Memory map rather than copy contents
-	gbFileContents fc = gb_file_read_contents(heap_allocator(), true, c_str);
-
-	if (fc.size > I32_MAX) {
-		t->flags = flags;
-		t->fullpath = fullpath;
-		t->line_count = 1;
-		err = TokenizerInit_FileTooLarge;
-		gb_file_free_contents(&fc);
-	} else if (fc.data != nullptr) {
-		init_tokenizer_with_file_contents(t, fullpath, &fc, flags);
-	} else {
-		t->flags = flags;
-		t->fullpath = fullpath;
-		t->line_count = 1;
-		gbFile f = {};
-		gbFileError file_err = gb_file_open(&f, c_str);
-		defer (gb_file_close(&f));
-
-		switch (file_err) {
-		case gbFileError_Invalid:    err = TokenizerInit_Invalid;    break;
-		case gbFileError_NotExists:  err = TokenizerInit_NotExists;  break;
-		case gbFileError_Permission: err = TokenizerInit_Permission; break;
+	// NOTE: The file is memory mapped where possible, and the contents
+	// are kept alive until destroy_tokenizer as tokens refer directly into them
+	LoadedFileError file_err = load_file(c_str, &t->loaded_file);
+	if (file_err == LoadedFile_None) {
+		init_tokenizer_with_data(t, fullpath, t->loaded_file.data, t->loaded_file.size, flags);
+		return TokenizerInit_None;
+	}
+
+	t->flags = flags;
+	t->fullpath = fullpath;
+	t->line_count = 1;
+
+	switch (file_err) {
+	case LoadedFile_Empty:        return TokenizerInit_Empty;
+	case LoadedFile_FileTooLarge: return TokenizerInit_FileTooLarge;
+	case LoadedFile_NotExists:    return TokenizerInit_NotExists;
+	case LoadedFile_Permission:   return TokenizerInit_Permission;
+	}
+	return TokenizerInit_Invalid;
+}
+
+gb_inline void destroy_tokenizer(Tokenizer *t) {
+	unload_file(&t->loaded_file);
+	t->start = nullptr;
+	t->end = nullptr;
+}
+
+
+enum PackedTokenFlag : u8 {
+	PackedTokenFlag_Newline  = 1<<0, // NOTE: The string is the "\n" of an inserted semicolon
+	PackedTokenFlag_Interned = 1<<1, // NOTE: `intern` is set rather than `length`
+};
+
+// NOTE: The compact form of a token which is kept for a whole file (see `AstFile::tokens`)
+// The string is a range of the source or the interned identifier, and the line and column are
+// computed from the line offsets of the file when the token is unpacked
+struct PackedToken {
+	u8  kind;
+	u8  flags;
+	i32 offset;
+	union {
+		StringIntern *intern;
+		i32           length;
+	};
+};
+GB_STATIC_ASSERT(gb_size_of(PackedToken) <= 16);
+GB_STATIC_ASSERT(Token_Count <= 256);
+
+// NOTE: The offset of the start of each line
+void init_line_offsets(Array<i32> *offsets, u8 const *start, isize size) {
+	array_init(offsets, heap_allocator(), 0, size/32 + 1);
+	array_add(offsets, 0);
+	u8 const *end = start + size;
+	for (u8 const *s = start; s < end; /**/) {
+		u8 const *newline = cast(u8 const *)gb_memchr(s, '\n', end-s);
+		if (newline == nullptr) {
+			break;
 		}
+		s = newline+1;
+		array_add(offsets, cast(i32)(s - start));
+	}
+}
 
-		if (err == TokenizerInit_None && gb_file_size(&f) == 0) {
-			err = TokenizerInit_Empty;
+// NOTE: Returns the line containing `offset` (starting at 1)
+// `hint` is a line at or before it, e.g. that of the previous token, as tokens are mostly unpacked in order
+i32 line_from_offset(Array<i32> const &offsets, i32 offset, i32 hint) {
+	isize lo = 0;
+	if (1 <= hint && hint <= offsets.count && offsets[hint-1] <= offset) {
+		lo = hint-1;
+		for (isize i = 0; i < 4; i++) {
+			if (lo+1 >= offsets.count || offset < offsets[lo+1]) {
+				return cast(i32)(lo+1);
+			}
+			lo += 1;
 		}
 	}
+	isize hi = offsets.count;
+	while (hi-lo > 1) {
+		isize mid = lo + (hi-lo)/2;
+		if (offsets[mid] <= offset) {
+			lo = mid;
+		} else {
+			hi = mid;
+		}
+	}
+	return cast(i32)(lo+1);
+}
 
-	return err;
+PackedToken pack_token(Tokenizer const *t, Token const &token) {
+	PackedToken packed = {};
+	packed.kind   = cast(u8)token.kind;
+	packed.offset = token.pos.offset;
+	if (token.intern != nullptr) {
+		packed.flags |= PackedTokenFlag_Interned;
+		packed.intern = token.intern;
+		return packed;
+	}
+	if (token.string.text != t->start + token.pos.offset) {
+		GB_ASSERT(token.string == "\n");
+		packed.flags |= PackedTokenFlag_Newline;
+	}
+	packed.length = cast(i32)token.string.len;
+	return packed;
 }
 
-gb_inline void destroy_tokenizer(Tokenizer *t) {
-	if (t->start != nullptr) {
-		gb_free(heap_allocator(), t->start);
+Token unpack_token(Tokenizer const *t, i32 file_id, Array<i32> const &line_offsets, PackedToken const &packed, i32 line_hint) {
+	Token token = {};
+	token.kind = cast(TokenKind)packed.kind;
+	if (packed.flags & PackedTokenFlag_Interned) {
+		token.intern = packed.intern;
+		token.string = string_intern_string(packed.intern);
+	} else if (packed.flags & PackedTokenFlag_Newline) {
+		token.string = str_lit("\n");
+	} else {
+		token.string = make_string(t->start + packed.offset, packed.length);
 	}
+	token.pos.file_id = file_id;
+	token.pos.offset  = packed.offset;
+	token.pos.line    = line_from_offset(line_offsets, packed.offset, line_hint);
+	token.pos.column  = packed.offset - line_offsets[token.pos.line-1] + 1;
+	return token;
 }
 
 gb_inline i32 digit_value(Rune r) {
@@ -1101,6 +1332,7 @@ void tokenizer_get_token(Tokenizer *t, Token *token, int repeat=0) {
 	token->kind = Token_Invalid;
 	token->string.text = t->curr;
 	token->string.len  = 1;
+	token->intern = nullptr;
 	token->pos.file_id = t->curr_file_id;
 	token->pos.line = t->line_count;
 	token->pos.offset = cast(i32)(t->curr - t->start);
@@ -1127,11 +1359,17 @@ void tokenizer_get_token(Tokenizer *t, Token *token, int repeat=0) {
 					token->kind = entry->kind;
 					if (token->kind == Token_not_in && entry->text == "notin") {
 						syntax_warning(*token, "'notin' is deprecated in favour of 'not_in'");
+						t->warning_count++;
 					}
 				}
 			}
 		}
 
+		if (token->kind == Token_Ident) {
+			token->intern = string_intern_entry(token->string);
+			token->string = string_intern_string(token->intern);
+		}
+
 		goto semicolon_check;
 	} else {
 		switch (curr_rune) {
@@ -308,7 +308,9 @@ struct Type {
 	// NOTE(bill): These need to be at the end to not affect the unionized data
 	i64  cached_size;
 	i64  cached_align;
+	u64  cached_hash; // NOTE: 0 means not yet computed, see `type_hash`
 	u32  flags; // TypeFlag
+	u32  id; // NOTE: Dense and unique (the basic types get theirs in `init_universal`), see `IdSet`
 	bool failure;
 };
 
@@ -660,9 +662,16 @@ gb_global Type *t_map_header                     = nullptr;
 
 gb_global Type *t_equal_proc  = nullptr;
 gb_global Type *t_hasher_proc = nullptr;
+gb_global Type *t_map_get_proc = nullptr;
 
 gb_global RecursiveMutex g_type_mutex;
 
+// NOTE: Simple structural types (^T, []T, [dynamic]T, [N]T) are hash-consed so that
+// structurally identical types are the same `Type *`, which makes `are_types_identical` and
+// the `Type *` keyed caches (e.g. `lbModule::types`) hit on pointer equality
+gb_global BlockingMutex g_type_intern_mutex; // NOT recursive
+gb_global Map<Type *>   g_type_intern_map;   // Key: kind + elem + count (multi map)
+
 
 i64      type_size_of               (Type *t);
 i64      type_align_of              (Type *t);
@@ -671,6 +680,9 @@ gbString type_to_string             (Type *type);
 void     init_map_internal_types(Type *type);
 Type *   bit_set_to_int(Type *t);
 bool are_types_identical(Type *x, Type *y);
+u64 type_hash(Type *t);
+u64 type_hash_final(Type *t);
+u64 type_hash_nested(Type *t, bool *can_cache);
 
 bool is_type_pointer(Type *t);
 bool is_type_slice(Type *t);
@@ -678,6 +690,8 @@ bool is_type_integer(Type *t);
 
 void init_type_mutex(void) {
 	mutex_init(&g_type_mutex);
+	mutex_init(&g_type_intern_mutex);
+	map_init(&g_type_intern_map, heap_allocator());
 }
 
 bool type_ptr_set_exists(PtrSet<Type *> *s, Type *t) {
@@ -685,11 +699,12 @@ bool type_ptr_set_exists(PtrSet<Type *> *s, Type *t) {
 		return true;
 	}
 
-	// TODO(bill, 2019-10-05): This is very slow and it's probably a lot
-	// faster to cache types correctly
+	// NOTE: Only pointer, slice and array types are interned and always hit above,
+	// any other type is compared structurally against the entries with the same hash
+	u64 hash = type_hash(t);
 	for_array(i, s->entries) {
 		Type *f = s->entries[i].ptr;
-		if (are_types_identical(t, f)) {
+		if (type_hash(f) == hash && are_types_identical(t, f)) {
 			ptr_set_add(s, t);
 			return true;
 		}
@@ -752,6 +767,9 @@ void set_base_type(Type *t, Type *base) {
 }
 
 
+// NOTE: Types are created on multiple threads, so each id must be unique
+gb_global std::atomic<u32> global_type_id;
+
 Type *alloc_type(TypeKind kind) {
 	// gbAllocator a = heap_allocator();
 	gbAllocator a = permanent_allocator();
@@ -760,10 +778,20 @@ Type *alloc_type(TypeKind kind) {
 	t->kind = kind;
 	t->cached_size  = -1;
 	t->cached_align = -1;
+	t->id = 1+global_type_id.fetch_add(1, std::memory_order_relaxed);
 	return t;
 }
 
 
+// NOTE: Replaces the contents of `dst` with those of `src`, e.g. when specializing a polymorphic type in place,
+// whilst `dst` keeps its own id, as the ids must stay unique
+void type_overwrite_in_place(Type *dst, Type *src) {
+	u32 id = dst->id;
+	gb_memmove(dst, src, gb_size_of(Type));
+	dst->id = id;
+}
+
+
 Type *alloc_type_generic(Scope *scope, i64 id, String name, Type *specialized) {
 	Type *t = alloc_type(Type_Generic);
 	t->Generic.id = id;
@@ -773,7 +801,69 @@ Type *alloc_type_generic(Scope *scope, i64 id, String name, Type *specialized) {
 	return t;
 }
 
+Type *intern_type_with_elem(TypeKind kind, Type *elem, i64 count) {
+	GB_ASSERT(elem != nullptr);
+
+	u64 h = cast(u64)kind;
+	h = h*0x100000001b3ull ^ cast(u64)cast(uintptr)elem;
+	h = h*0x100000001b3ull ^ cast(u64)count;
+	HashKey key = hash_integer(h);
+
+	mutex_lock(&g_type_intern_mutex);
+	defer (mutex_unlock(&g_type_intern_mutex));
+
+	for (auto *entry = multi_map_find_first(&g_type_intern_map, key);
+	     entry != nullptr;
+	     entry = multi_map_find_next(&g_type_intern_map, entry)) {
+		Type *t = entry->value;
+		if (t->kind != kind) {
+			continue;
+		}
+		switch (kind) {
+		case Type_Pointer:
+			if (t->Pointer.elem == elem) {
+				return t;
+			}
+			break;
+		case Type_Slice:
+			if (t->Slice.elem == elem) {
+				return t;
+			}
+			break;
+		case Type_DynamicArray:
+			if (t->DynamicArray.elem == elem) {
+				return t;
+			}
+			break;
+		case Type_Array:
+			if (t->Array.elem == elem && t->Array.count == count) {
+				return t;
+			}
+			break;
+		}
+	}
+
+	Type *t = alloc_type(kind);
+	switch (kind) {
+	case Type_Pointer:      t->Pointer.elem      = elem; break;
+	case Type_Slice:        t->Slice.elem        = elem; break;
+	case Type_DynamicArray: t->DynamicArray.elem = elem; break;
+	case Type_Array:
+		t->Array.elem  = elem;
+		t->Array.count = count;
+		break;
+	default:
+		GB_PANIC("Unsupported interned type kind");
+		break;
+	}
+	multi_map_insert(&g_type_intern_map, key, t);
+	return t;
+}
+
 Type *alloc_type_pointer(Type *elem) {
+	if (elem != nullptr) {
+		return intern_type_with_elem(Type_Pointer, elem, 0);
+	}
 	Type *t = alloc_type(Type_Pointer);
 	t->Pointer.elem = elem;
 	return t;
@@ -781,12 +871,17 @@ Type *alloc_type_pointer(Type *elem) {
 
 Type *alloc_type_array(Type *elem, i64 count, Type *generic_count = nullptr) {
 	if (generic_count != nullptr) {
+		// NOTE: The count of a polymorphic array is modified in place when specialized
 		Type *t = alloc_type(Type_Array);
 		t->Array.elem = elem;
 		t->Array.count = count;
 		t->Array.generic_count = generic_count;
 		return t;
 	}
+	if (elem != nullptr && count >= 0) {
+		// NOTE: [?]T has its count modified in place, so do not intern it
+		return intern_type_with_elem(Type_Array, elem, count);
+	}
 	Type *t = alloc_type(Type_Array);
 	t->Array.elem = elem;
 	t->Array.count = count;
@@ -807,12 +902,18 @@ Type *alloc_type_enumerated_array(Type *elem, Type *index, ExactValue min_value,
 
 
 Type *alloc_type_slice(Type *elem) {
+	if (elem != nullptr) {
+		return intern_type_with_elem(Type_Slice, elem, 0);
+	}
 	Type *t = alloc_type(Type_Slice);
 	t->Array.elem = elem;
 	return t;
 }
 
 Type *alloc_type_dynamic_array(Type *elem) {
+	if (elem != nullptr) {
+		return intern_type_with_elem(Type_DynamicArray, elem, 0);
+	}
 	Type *t = alloc_type(Type_DynamicArray);
 	t->DynamicArray.elem = elem;
 	return t;
@@ -2184,6 +2285,205 @@ bool are_types_identical(Type *x, Type *y) {
 	return false;
 }
 
+gb_inline u64 type_hash_combine(u64 h, u64 value) {
+	h ^= value + 0x9e3779b97f4a7c15ull + (h<<6) + (h>>2);
+	return h;
+}
+
+u64 type_hash_string(String const &s) {
+	return gb_fnv64a(s.text, s.len);
+}
+
+u64 type_hash_exact_value(ExactValue const &v, bool *can_cache) {
+	// NOTE: This must agree with `compare_exact_values(Token_CmpEq, ...)`
+	// Values which compare equal across different kinds (e.g. 2 and 2.0) must hash the same
+	switch (v.kind) {
+	case ExactValue_Bool:
+		return v.value_bool ? 1 : 2;
+	case ExactValue_String:
+		return type_hash_string(v.value_string);
+	case ExactValue_Integer:
+	case ExactValue_Float:
+	case ExactValue_Complex:
+	case ExactValue_Quaternion:
+		{
+			// NOTE: Only hash the real part as that is all that is shared between the kinds
+			f64 f = 0;
+			switch (v.kind) {
+			case ExactValue_Integer:    f = exact_value_to_float(v).value_float; break;
+			case ExactValue_Float:      f = v.value_float;                       break;
+			case ExactValue_Complex:    f = v.value_complex->real;               break;
+			case ExactValue_Quaternion: f = v.value_quaternion->real;            break;
+			}
+			if (f == 0) {
+				f = 0; // NOTE: -0.0 == +0.0
+			}
+			return hash_f64(f).key;
+		}
+	case ExactValue_Typeid:
+		return type_hash_nested(v.value_typeid, can_cache);
+	}
+	return 0;
+}
+
+u64 type_hash_internal(Type *t, bool *can_cache) {
+	u64 h = cast(u64)t->kind + 1;
+
+	switch (t->kind) {
+	case Type_Generic:
+		return type_hash_combine(h, type_hash_nested(t->Generic.specialized, can_cache));
+
+	case Type_Basic:
+		return type_hash_combine(h, cast(u64)t->Basic.kind);
+
+	case Type_EnumeratedArray:
+		h = type_hash_combine(h, type_hash_nested(t->EnumeratedArray.index, can_cache));
+		h = type_hash_combine(h, type_hash_nested(t->EnumeratedArray.elem, can_cache));
+		return h;
+
+	case Type_Array:
+		h = type_hash_combine(h, cast(u64)t->Array.count);
+		h = type_hash_combine(h, type_hash_nested(t->Array.elem, can_cache));
+		return h;
+
+	case Type_DynamicArray:
+		return type_hash_combine(h, type_hash_nested(t->DynamicArray.elem, can_cache));
+
+	case Type_Slice:
+		return type_hash_combine(h, type_hash_nested(t->Slice.elem, can_cache));
+
+	case Type_BitSet:
+		h = type_hash_combine(h, type_hash_nested(t->BitSet.elem, can_cache));
+		h = type_hash_combine(h, type_hash_nested(t->BitSet.underlying, can_cache));
+		h = type_hash_combine(h, cast(u64)t->BitSet.lower);
+		h = type_hash_combine(h, cast(u64)t->BitSet.upper);
+		return h;
+
+	case Type_Union:
+		h = type_hash_combine(h, cast(u64)t->Union.variants.count);
+		h = type_hash_combine(h, cast(u64)t->Union.custom_align);
+		h = type_hash_combine(h, cast(u64)t->Union.no_nil);
+		for_array(i, t->Union.variants) {
+			h = type_hash_combine(h, type_hash_nested(t->Union.variants[i], can_cache));
+		}
+		return h;
+
+	case Type_Struct:
+		h = type_hash_combine(h, cast(u64)t->Struct.is_raw_union);
+		h = type_hash_combine(h, cast(u64)t->Struct.is_packed);
+		h = type_hash_combine(h, cast(u64)t->Struct.custom_align);
+		h = type_hash_combine(h, cast(u64)t->Struct.soa_kind);
+		h = type_hash_combine(h, cast(u64)t->Struct.soa_count);
+		h = type_hash_combine(h, type_hash_nested(t->Struct.soa_elem, can_cache));
+		h = type_hash_combine(h, cast(u64)t->Struct.fields.count);
+		for_array(i, t->Struct.fields) {
+			Entity *f = t->Struct.fields[i];
+			h = type_hash_combine(h, cast(u64)f->kind);
+			h = type_hash_combine(h, type_hash_nested(f->type, can_cache));
+			h = type_hash_combine(h, type_hash_string(f->token.string));
+			h = type_hash_combine(h, (f->flags&EntityFlag_Using) != 0);
+		}
+		return h;
+
+	case Type_Pointer:
+		return type_hash_combine(h, type_hash_nested(t->Pointer.elem, can_cache));
+
+	case Type_Named:
+		// NOTE: Named types are compared by their type name entity
+		return type_hash_combine(h, cast(u64)cast(uintptr)t->Named.type_name);
+
+	case Type_Tuple:
+		h = type_hash_combine(h, cast(u64)t->Tuple.variables.count);
+		h = type_hash_combine(h, cast(u64)t->Tuple.is_packed);
+		for_array(i, t->Tuple.variables) {
+			Entity *e = t->Tuple.variables[i];
+			h = type_hash_combine(h, cast(u64)e->kind);
+			h = type_hash_combine(h, type_hash_nested(e->type, can_cache));
+			if (e->kind == Entity_Constant) {
+				h = type_hash_combine(h, type_hash_exact_value(e->Constant.value, can_cache));
+			}
+		}
+		return h;
+
+	case Type_Proc:
+		h = type_hash_combine(h, cast(u64)t->Proc.calling_convention);
+		h = type_hash_combine(h, cast(u64)t->Proc.c_vararg);
+		h = type_hash_combine(h, cast(u64)t->Proc.variadic);
+		h = type_hash_combine(h, cast(u64)t->Proc.diverging);
+		h = type_hash_combine(h, cast(u64)t->Proc.optional_ok);
+		h = type_hash_combine(h, type_hash_nested(t->Proc.params, can_cache));
+		h = type_hash_combine(h, type_hash_nested(t->Proc.results, can_cache));
+		return h;
+
+	case Type_Map:
+		h = type_hash_combine(h, type_hash_nested(t->Map.key, can_cache));
+		h = type_hash_combine(h, type_hash_nested(t->Map.value, can_cache));
+		return h;
+
+	case Type_SimdVector:
+		h = type_hash_combine(h, cast(u64)t->SimdVector.count);
+		h = type_hash_combine(h, type_hash_nested(t->SimdVector.elem, can_cache));
+		return h;
+	}
+
+	// NOTE: Any other kind is only ever identical to itself
+	return type_hash_combine(h, cast(u64)cast(uintptr)t);
+}
+
+// NOTE: A structural hash of a type which agrees with `are_types_identical`
+// i.e. if `are_types_identical(x, y)` then `type_hash(x) == type_hash(y)`
+u64 type_hash_nested(Type *t, bool *can_cache) {
+	if (t == nullptr) {
+		return 1;
+	}
+	t = strip_type_aliasing(t);
+	if (t->cached_hash != 0) {
+		return t->cached_hash;
+	}
+	bool can_cache_this = true;
+	switch (t->kind) {
+	case Type_Generic:
+	case Type_Tuple:
+	case Type_Proc:
+		// NOTE: These types may be modified in place whilst checking
+		// (e.g. procedure types of polymorphic procedures), so they are not cached
+		// nor any type which contains them, until they are in use (see `type_hash_final`)
+		can_cache_this = false;
+		break;
+	case Type_Array:
+		// NOTE: The counts of polymorphic ([$N]T) and inferred ([?]T) arrays are set in place
+		if (t->Array.generic_count != nullptr || t->Array.count < 0) {
+			can_cache_this = false;
+		}
+		break;
+	}
+	u64 h = type_hash_internal(t, &can_cache_this);
+	if (h == 0) {
+		h = 1;
+	}
+	if (can_cache_this) {
+		t->cached_hash = h;
+	} else {
+		*can_cache = false;
+	}
+	return h;
+}
+
+u64 type_hash(Type *t) {
+	bool can_cache = true;
+	return type_hash_nested(t, &can_cache);
+}
+
+// NOTE: Called once a type is in use (e.g. it has been added to the type info table), after which it is
+// not modified in place, so the hash of a procedure or tuple type (or a type containing one) can now be cached
+u64 type_hash_final(Type *t) {
+	u64 h = type_hash(t);
+	if (t != nullptr) {
+		strip_type_aliasing(t)->cached_hash = h;
+	}
+	return h;
+}
+
 Type *default_type(Type *type) {
 	if (type == nullptr) {
 		return t_invalid;